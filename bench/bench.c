@@ -0,0 +1,450 @@
+/**
+ * @file bench.c
+ * @brief Medição do desempenho das operações principais sobre mapas sintéticos
+ *
+ * @details Para cada mapa indicado, mede repetidamente:
+ * - carregar_mapa_paralelo com um só fio, para comparar com o seguinte
+ * - carregar_mapa_modo (carregamento e ligação das antenas, um fio por processador)
+ * - procura_largura e procura_profundidade (a partir da frequência com mais antenas)
+ * - encontrar_caminhos (limitado em saltos e em número de caminhos)
+ * - caminho_mais_curto (procura em largura bidirecional entre as mesmas antenas)
+ * - grafo_compactar e compacto_procura_largura (mesma procura sobre o grafo compacto)
+ * - escrever_grafo (para um ficheiro temporário, com o buffer de TAMANHO_BUFFER_ESCRITA)
+ * - antenas_mais_proximas (CONSULTAS_ESPACIAIS posições na caixa da frequência com mais antenas)
+ * - intersecoes_frequencias (entre as duas frequências com mais antenas, sem imprimir)
+ *
+ * Para cada operação escreve uma linha CSV com a mediana, o percentil 99, o
+ * mínimo e o máximo dos tempos, e o pico de memória residente do processo até
+ * esse momento. As operações cujo trabalho estimado excede o limite são
+ * ignoradas, com um aviso, para que os mapas grandes não fiquem a correr horas.
+ *
+ * Utilização:
+ *   bench [-r repeticoes] [-e] [-w limite] [-o resultados.csv] mapa.bin...
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <time.h>
+#include <sys/resource.h>
+#endif
+#include "grafo.h"
+#include "mapa.h"
+#include "compacto.h"
+
+#define MAX_SALTOS_CAMINHOS 3       ///< Saltos máximos na medição de encontrar_caminhos
+#define MAX_CAMINHOS 1000           ///< Caminhos contados antes de terminar a enumeração
+#define MAX_PARES_ESCRITA 2e7       ///< Vizinhos escritos no máximo pela medição de escrever_grafo
+#define CONSULTAS_ESPACIAIS 1000    ///< Posições consultadas em cada repetição de antenas_mais_proximas
+
+/**
+ * @struct ParametrosBench
+ * @brief Opções da medição lidas da linha de comandos
+ */
+typedef struct ParametrosBench {
+    int repeticoes;             ///< Número de execuções de cada operação
+    ModoArestas modo;           ///< Representação das arestas dos grafos carregados
+    double limite;              ///< Trabalho estimado máximo de uma execução (pares de vértices ou de segmentos)
+    const char* saida;          ///< Ficheiro CSV (NULL para a saída padrão)
+} ParametrosBench;
+
+/**
+ * @brief Lê o relógio monótono
+ * @return Instante atual em microssegundos, a partir de uma origem arbitrária
+ */
+static double agora_us(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequencia, contador;
+    QueryPerformanceFrequency(&frequencia);
+    QueryPerformanceCounter(&contador);
+    return (double)contador.QuadPart * 1e6 / (double)frequencia.QuadPart;
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec * 1e6 + (double)t.tv_nsec / 1e3;
+#endif
+}
+
+/**
+ * @brief Obtém o pico de memória residente do processo
+ * @return Pico em KiB, ou 0 se não for possível obtê-lo
+ */
+static long long pico_memoria_kb(void) {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS contadores;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &contadores, sizeof(contadores))) return 0;
+    return (long long)(contadores.PeakWorkingSetSize / 1024);
+#else
+    struct rusage uso;
+    if (getrusage(RUSAGE_SELF, &uso) != 0) return 0;
+#ifdef __APPLE__
+    return (long long)uso.ru_maxrss / 1024;
+#else
+    return (long long)uso.ru_maxrss;
+#endif
+#endif
+}
+
+/**
+ * @brief Compara dois tempos (para qsort)
+ */
+static int comparar_tempos(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Escreve a linha CSV de uma operação
+ * @param saida Ficheiro CSV
+ * @param mapa Nome do mapa
+ * @param grafo Grafo medido
+ * @param operacao Nome da operação
+ * @param tempos Tempos de cada execução, em microssegundos (são ordenados)
+ * @param n Número de execuções
+ *
+ * @details O percentil 99 é o tempo na posição ceil(0.99 * n) dos tempos ordenados
+ */
+static void escrever_resultado(FILE* saida, const char* mapa, const Grafo* grafo, const char* operacao,
+                               double* tempos, int n) {
+    qsort(tempos, (size_t)n, sizeof(double), comparar_tempos);
+    double mediana = (n % 2) ? tempos[n / 2] : (tempos[n / 2 - 1] + tempos[n / 2]) / 2.0;
+    int p99 = (99 * n + 99) / 100 - 1;
+    fprintf(saida, "%s,%d,%s,%s,%d,%.1f,%.1f,%.1f,%.1f,%lld\n",
+            mapa, grafo->num_vertices, grafo->modo == ARESTAS_IMPLICITAS ? "implicito" : "explicito",
+            operacao, n, mediana, tempos[p99], tempos[0], tempos[n - 1], pico_memoria_kb());
+    fflush(saida);
+}
+
+/**
+ * @brief Função de visita que só conta os vértices visitados
+ * @param v Vértice visitado
+ * @param dados Contador (long long)
+ * @return 0, para a procura continuar
+ */
+static int contar_visita(Vertice* v, void* dados) {
+    (void)v;
+    (*(long long*)dados)++;
+    return 0;
+}
+
+/**
+ * @brief Função de visita do grafo compacto que só conta os vértices visitados
+ * @param grafo Grafo compacto percorrido
+ * @param v Índice do vértice visitado
+ * @param dados Contador (long long)
+ * @return 0, para a procura continuar
+ */
+static int contar_visita_compacto(const GrafoCompacto* grafo, uint32_t v, void* dados) {
+    (void)grafo;
+    (void)v;
+    (*(long long*)dados)++;
+    return 0;
+}
+
+/**
+ * @brief Função de visita de caminhos que conta até MAX_CAMINHOS caminhos
+ * @param caminho Caminho encontrado
+ * @param comprimento Número de vértices do caminho
+ * @param dados Contador (long long)
+ * @return 0 para continuar, 1 quando já foram contados MAX_CAMINHOS caminhos
+ */
+static int contar_caminho_limitado(CaminhoNode* caminho, int comprimento, void* dados) {
+    (void)caminho;
+    (void)comprimento;
+    long long* total = (long long*)dados;
+    return ++(*total) >= MAX_CAMINHOS;
+}
+
+/**
+ * @brief Encontra as duas frequências com mais antenas
+ * @param grafo Apontador para o grafo
+ * @param[out] primeira Frequência com mais antenas
+ * @param[out] segunda Frequência seguinte (igual a primeira se só houver uma)
+ */
+static void frequencias_maiores(const Grafo* grafo, int* primeira, int* segunda) {
+    *primeira = *segunda = -1;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        int k = grafo->num_por_frequencia[f];
+        if (k == 0) continue;
+        if (*primeira < 0 || k > grafo->num_por_frequencia[*primeira]) {
+            *segunda = *primeira;
+            *primeira = f;
+        } else if (*segunda < 0 || k > grafo->num_por_frequencia[*segunda]) {
+            *segunda = f;
+        }
+    }
+    if (*segunda < 0) *segunda = *primeira;
+}
+
+/**
+ * @brief Mede todas as operações sobre um mapa
+ * @param p Parâmetros da medição
+ * @param mapa Caminho do mapa
+ * @param saida Ficheiro CSV
+ * @return 0 em caso de sucesso, -1 se o mapa não puder ser carregado
+ *
+ * @details O trabalho estimado de cada operação é o número de pares que terá
+ * de percorrer: k * k vizinhos numa procura sobre uma frequência com k antenas,
+ * e o produto do número de segmentos das duas frequências nas intersecções
+ */
+static int medir_mapa(const ParametrosBench* p, const char* mapa, FILE* saida) {
+    // Sem isto, carregar_mapa criaria o mapa padrão no lugar de um ficheiro em falta
+    FILE* f = fopen(mapa, "rb");
+    if (!f) return -1;
+    fclose(f);
+
+    double* tempos = (double*)malloc((size_t)p->repeticoes * sizeof(double));
+    if (!tempos) return -1;
+
+    // Primeiro por um só fio, para comparar com o carregamento paralelo
+    Grafo* grafo = NULL;
+    for (int r = 0; r < p->repeticoes; r++) {
+        if (grafo) destruir_grafo(grafo);
+        double t0 = agora_us();
+        grafo = carregar_mapa_paralelo(mapa, p->modo, 1);
+        tempos[r] = agora_us() - t0;
+        if (!grafo) {
+            free(tempos);
+            return -1;
+        }
+    }
+    escrever_resultado(saida, mapa, grafo, "carregar_mapa_1fio", tempos, p->repeticoes);
+    destruir_grafo(grafo);
+
+    grafo = NULL;
+    for (int r = 0; r < p->repeticoes; r++) {
+        if (grafo) destruir_grafo(grafo);
+        double t0 = agora_us();
+        grafo = carregar_mapa_modo(mapa, p->modo);
+        tempos[r] = agora_us() - t0;
+        if (!grafo) {
+            free(tempos);
+            return -1;
+        }
+    }
+    escrever_resultado(saida, mapa, grafo, "carregar_mapa", tempos, p->repeticoes);
+
+    int fa, fb;
+    frequencias_maiores(grafo, &fa, &fb);
+    if (fa < 0) {
+        fprintf(stderr, "%s: mapa sem antenas\n", mapa);
+        free(tempos);
+        destruir_grafo(grafo);
+        return 0;
+    }
+    double ka = grafo->num_por_frequencia[fa];
+    double kb = grafo->num_por_frequencia[fb];
+    Vertice* inicio = grafo->por_frequencia[fa][0];
+    Vertice* fim = grafo->por_frequencia[fa][grafo->num_por_frequencia[fa] - 1];
+
+    if (ka * ka > p->limite) {
+        fprintf(stderr, "%s: procuras ignoradas (~%.3g pares > %.3g)\n", mapa, ka * ka, p->limite);
+    } else {
+        long long visitados = 0;
+        for (int r = 0; r < p->repeticoes; r++) {
+            double t0 = agora_us();
+            procura_largura_visitar(grafo, inicio, contar_visita, &visitados);
+            tempos[r] = agora_us() - t0;
+        }
+        escrever_resultado(saida, mapa, grafo, "procura_largura", tempos, p->repeticoes);
+
+        for (int r = 0; r < p->repeticoes; r++) {
+            double t0 = agora_us();
+            procura_profundidade_visitar(grafo, inicio, contar_visita, &visitados);
+            tempos[r] = agora_us() - t0;
+        }
+        escrever_resultado(saida, mapa, grafo, "procura_profundidade", tempos, p->repeticoes);
+    }
+
+    // O grafo compacto materializa as adjacências de todas as frequências
+    double pares = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        pares += (double)grafo->num_por_frequencia[f] * grafo->num_por_frequencia[f];
+    }
+    if (pares > p->limite) {
+        fprintf(stderr, "%s: grafo compacto ignorado (~%.3g pares > %.3g)\n", mapa, pares, p->limite);
+    } else {
+        GrafoCompacto* compacto = NULL;
+        for (int r = 0; r < p->repeticoes; r++) {
+            if (compacto) destruir_grafo_compacto(compacto);
+            double t0 = agora_us();
+            compacto = grafo_compactar(grafo);
+            tempos[r] = agora_us() - t0;
+        }
+        if (!compacto) {
+            fprintf(stderr, "%s: grafo compacto ignorado (fora dos limites de 16/32 bits)\n", mapa);
+        } else {
+            escrever_resultado(saida, mapa, grafo, "grafo_compactar", tempos, p->repeticoes);
+
+            long long visitados = 0;
+            for (int r = 0; r < p->repeticoes; r++) {
+                double t0 = agora_us();
+                compacto_procura_largura(compacto, (uint32_t)inicio->id, contar_visita_compacto, &visitados);
+                tempos[r] = agora_us() - t0;
+            }
+            escrever_resultado(saida, mapa, grafo, "compacto_procura_largura", tempos, p->repeticoes);
+            destruir_grafo_compacto(compacto);
+        }
+    }
+
+    // Cada vizinho ocupa cerca de 12 bytes no texto escrito
+    FILE* temporario = pares > MAX_PARES_ESCRITA ? NULL : tmpfile();
+    if (!temporario) {
+        fprintf(stderr, "%s: escrever_grafo ignorado (~%.3g vizinhos > %.3g ou sem ficheiro temporario)\n",
+                mapa, pares, MAX_PARES_ESCRITA);
+    } else {
+        static char buffer[TAMANHO_BUFFER_ESCRITA];
+        for (int r = 0; r < p->repeticoes; r++) {
+            rewind(temporario);
+            Saida escrita;
+            saida_ficheiro(&escrita, temporario, buffer, sizeof(buffer));
+            double t0 = agora_us();
+            escrever_grafo(grafo, &escrita);
+            saida_fechar(&escrita);
+            tempos[r] = agora_us() - t0;
+        }
+        escrever_resultado(saida, mapa, grafo, "escrever_grafo", tempos, p->repeticoes);
+        fclose(temporario);
+    }
+
+    if (inicio != fim) {
+        for (int r = 0; r < p->repeticoes; r++) {
+            long long caminhos = 0;
+            double t0 = agora_us();
+            encontrar_caminhos_visitar_limitado(grafo, inicio, fim, MAX_SALTOS_CAMINHOS,
+                                                contar_caminho_limitado, &caminhos);
+            tempos[r] = agora_us() - t0;
+        }
+        escrever_resultado(saida, mapa, grafo, "encontrar_caminhos", tempos, p->repeticoes);
+
+        for (int r = 0; r < p->repeticoes; r++) {
+            double t0 = agora_us();
+            caminho_mais_curto_bidirecional(grafo, inicio, fim, 0, NULL);
+            tempos[r] = agora_us() - t0;
+        }
+        escrever_resultado(saida, mapa, grafo, "caminho_mais_curto", tempos, p->repeticoes);
+    }
+
+    // Posições espalhadas pela caixa da frequência, sempre as mesmas em cada repetição
+    const GrelhaPontos* caixa = &grafo->espacial[fa];
+    long long largura = (long long)caixa->max_x - caixa->min_x + 1;
+    long long altura = (long long)caixa->max_y - caixa->min_y + 1;
+    for (int r = 0; r < p->repeticoes; r++) {
+        unsigned long long semente = 1;
+        Vertice* mais_proxima;
+        double t0 = agora_us();
+        for (int q = 0; q < CONSULTAS_ESPACIAIS; q++) {
+            semente = semente * 6364136223846793005ull + 1442695040888963407ull;
+            int x = caixa->min_x + (int)((semente >> 33) % (unsigned long long)largura);
+            int y = caixa->min_y + (int)((semente >> 13) % (unsigned long long)altura);
+            antenas_mais_proximas(grafo, fa, x, y, 1, &mais_proxima);
+        }
+        tempos[r] = agora_us() - t0;
+    }
+    escrever_resultado(saida, mapa, grafo, "antenas_mais_proximas", tempos, p->repeticoes);
+
+    double segmentos = (ka * (ka - 1) / 2) * (kb * (kb - 1) / 2);
+    if (fa == fb || segmentos == 0) {
+        fprintf(stderr, "%s: intersecoes ignoradas (menos de duas frequencias com ligacoes)\n", mapa);
+    } else if (segmentos > p->limite) {
+        fprintf(stderr, "%s: intersecoes ignoradas (~%.3g pares de segmentos > %.3g)\n",
+                mapa, segmentos, p->limite);
+    } else {
+        for (int r = 0; r < p->repeticoes; r++) {
+            double t0 = agora_us();
+            contar_intersecoes(grafo, (char)fa, (char)fb);
+            tempos[r] = agora_us() - t0;
+        }
+        escrever_resultado(saida, mapa, grafo, "intersecoes_frequencias", tempos, p->repeticoes);
+    }
+
+    free(tempos);
+    destruir_grafo(grafo);
+    return 0;
+}
+
+/**
+ * @brief Mostra a utilização do programa
+ * @param programa Nome do programa
+ */
+static void mostrar_utilizacao(const char* programa) {
+    fprintf(stderr, "Utilizacao: %s [-r repeticoes] [-e] [-w limite] [-o resultados.csv] mapa.bin...\n",
+            programa);
+}
+
+/**
+ * @brief Função principal da medição
+ * @param argc Número de argumentos
+ * @param argv Argumentos
+ * @return 0 se todos os mapas foram medidos, 1 em caso de erro
+ *
+ * @details Por omissão os grafos são carregados no modo implícito, o único em
+ * que os mapas com milhões de antenas cabem em memória; -e usa arestas explícitas.
+ * Com -o, as linhas são acrescentadas ao ficheiro e o cabeçalho CSV só é escrito
+ * se o ficheiro estiver vazio.
+ */
+int main(int argc, char** argv) {
+    ParametrosBench p;
+    p.repeticoes = 5;
+    p.modo = ARESTAS_IMPLICITAS;
+    p.limite = 5e8;
+    p.saida = NULL;
+
+    int i = 1;
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-e") == 0) {
+            p.modo = ARESTAS_EXPLICITAS;
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            p.repeticoes = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            p.limite = atof(argv[++i]);
+        } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            p.saida = argv[++i];
+        } else {
+            mostrar_utilizacao(argv[0]);
+            return 1;
+        }
+    }
+    if (i == argc || p.repeticoes < 1) {
+        mostrar_utilizacao(argv[0]);
+        return 1;
+    }
+
+    FILE* saida = stdout;
+    if (p.saida) {
+        saida = fopen(p.saida, "a");
+        if (!saida) {
+            fprintf(stderr, "Erro ao abrir %s\n", p.saida);
+            return 1;
+        }
+        fseek(saida, 0, SEEK_END);
+    }
+    if (saida == stdout || ftell(saida) == 0) {
+        fprintf(saida, "mapa,antenas,modo,operacao,repeticoes,mediana_us,p99_us,min_us,max_us,pico_rss_kb\n");
+    }
+
+    int erros = 0;
+    for (; i < argc; i++) {
+        if (medir_mapa(&p, argv[i], saida) != 0) {
+            fprintf(stderr, "Erro ao medir %s\n", argv[i]);
+            erros++;
+        }
+    }
+
+    if (saida != stdout) fclose(saida);
+    return erros ? 1 : 0;
+}
@@ -0,0 +1,293 @@
+/**
+ * @file gerar_mapa.c
+ * @brief Gerador de mapas sintéticos de antenas para medição de desempenho
+ *
+ * @details Escreve um ficheiro de mapa (cabeçalho da versão 2) configurável por:
+ * - Dimensões do mapa, ou número de antenas e densidade
+ * - Número de frequências e enviesamento da sua distribuição (tipo Zipf)
+ * - Modelo de posições: uniforme ou em agrupamentos à volta de centros aleatórios
+ *
+ * O gerador usa o seu próprio gerador pseudo-aleatório, pelo que a mesma
+ * semente produz o mesmo mapa em qualquer sistema.
+ *
+ * Utilização:
+ *   gerar_mapa [-l linhas] [-c colunas] [-n antenas] [-d densidade] [-f frequencias]
+ *              [-z enviesamento] [-a agrupamentos] [-r raio] [-s semente] -o ficheiro
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include "mapa.h"
+
+/**
+ * @brief Carateres usados para as frequências, pela ordem em que são atribuídas
+ */
+static const char FREQUENCIAS[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+#define MAX_FREQUENCIAS ((int)sizeof(FREQUENCIAS) - 1)   ///< Número de carateres de frequência disponíveis
+#define TENTATIVAS_AGRUPAMENTO 32                       ///< Tentativas de colocar uma antena num agrupamento
+
+/**
+ * @struct ParametrosGerador
+ * @brief Opções do gerador lidas da linha de comandos
+ */
+typedef struct ParametrosGerador {
+    long long linhas;       ///< Número de linhas (0 para calcular a partir de antenas e densidade)
+    long long colunas;      ///< Número de colunas (0 para calcular a partir de antenas e densidade)
+    long long antenas;      ///< Número de antenas (0 para calcular a partir da densidade)
+    double densidade;       ///< Fração das posições ocupadas por antenas
+    int frequencias;        ///< Número de frequências distintas
+    double enviesamento;    ///< Expoente da distribuição das frequências (0 = uniforme)
+    int agrupamentos;       ///< Número de agrupamentos (0 = posições uniformes)
+    double raio;            ///< Raio de cada agrupamento
+    unsigned long long semente;  ///< Semente do gerador pseudo-aleatório
+    const char* ficheiro;   ///< Ficheiro de saída
+} ParametrosGerador;
+
+/**
+ * @brief Avança o gerador pseudo-aleatório (xorshift64*)
+ * @param estado Estado do gerador (nunca 0)
+ * @return Próximo valor de 64 bits
+ */
+static unsigned long long aleatorio(unsigned long long* estado) {
+    unsigned long long x = *estado;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *estado = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+/**
+ * @brief Valor pseudo-aleatório uniforme em [0, 1)
+ * @param estado Estado do gerador
+ */
+static double aleatorio_unitario(unsigned long long* estado) {
+    return (double)(aleatorio(estado) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief Valor pseudo-aleatório uniforme em [0, n)
+ * @param estado Estado do gerador
+ * @param n Limite superior (positivo)
+ */
+static long long aleatorio_ate(unsigned long long* estado, long long n) {
+    return (long long)(aleatorio(estado) % (unsigned long long)n);
+}
+
+/**
+ * @brief Escolhe uma frequência segundo a distribuição acumulada
+ * @param acumulada Probabilidade acumulada de cada frequência
+ * @param n Número de frequências
+ * @param estado Estado do gerador
+ * @return Índice da frequência escolhida
+ */
+static int escolher_frequencia(const double* acumulada, int n, unsigned long long* estado) {
+    double u = aleatorio_unitario(estado);
+    int baixo = 0, alto = n - 1;
+    while (baixo < alto) {
+        int meio = (baixo + alto) / 2;
+        if (acumulada[meio] > u) {
+            alto = meio;
+        } else {
+            baixo = meio + 1;
+        }
+    }
+    return baixo;
+}
+
+/**
+ * @brief Mostra a utilização do programa
+ * @param programa Nome do programa
+ */
+static void mostrar_utilizacao(const char* programa) {
+    fprintf(stderr,
+            "Utilizacao: %s [-l linhas] [-c colunas] [-n antenas] [-d densidade] [-f frequencias]\n"
+            "           [-z enviesamento] [-a agrupamentos] [-r raio] [-s semente] -o ficheiro\n",
+            programa);
+}
+
+/**
+ * @brief Lê as opções da linha de comandos e completa as que dependem das outras
+ * @param argc Número de argumentos
+ * @param argv Argumentos
+ * @param[out] p Parâmetros lidos
+ * @return 0 em caso de sucesso, -1 se as opções forem inválidas
+ *
+ * @details Sem dimensões, o mapa é quadrado com o lado necessário para colocar
+ * as antenas pedidas com a densidade pedida. Sem número de antenas, este é
+ * obtido da densidade e das dimensões.
+ */
+static int ler_parametros(int argc, char** argv, ParametrosGerador* p) {
+    p->linhas = 0;
+    p->colunas = 0;
+    p->antenas = 0;
+    p->densidade = 0.1;
+    p->frequencias = 8;
+    p->enviesamento = 0.0;
+    p->agrupamentos = 0;
+    p->raio = 16.0;
+    p->semente = 1;
+    p->ficheiro = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        if (argv[i][0] != '-' || argv[i][1] == '\0' || argv[i][2] != '\0' || i + 1 >= argc) return -1;
+        const char* valor = argv[++i];
+        switch (argv[i - 1][1]) {
+            case 'l': p->linhas = atoll(valor); break;
+            case 'c': p->colunas = atoll(valor); break;
+            case 'n': p->antenas = atoll(valor); break;
+            case 'd': p->densidade = atof(valor); break;
+            case 'f': p->frequencias = atoi(valor); break;
+            case 'z': p->enviesamento = atof(valor); break;
+            case 'a': p->agrupamentos = atoi(valor); break;
+            case 'r': p->raio = atof(valor); break;
+            case 's': p->semente = strtoull(valor, NULL, 10); break;
+            case 'o': p->ficheiro = valor; break;
+            default: return -1;
+        }
+    }
+
+    if (!p->ficheiro || p->densidade <= 0.0 || p->densidade > 1.0 ||
+        p->frequencias < 1 || p->frequencias > MAX_FREQUENCIAS ||
+        p->enviesamento < 0.0 || p->agrupamentos < 0 || p->raio <= 0.0 ||
+        p->linhas < 0 || p->colunas < 0 || p->antenas < 0) {
+        return -1;
+    }
+    if (p->semente == 0) p->semente = 1;
+
+    if (p->linhas == 0 || p->colunas == 0) {
+        if (p->antenas == 0) return -1;
+        long long lado = (long long)ceil(sqrt((double)p->antenas / p->densidade));
+        if (p->linhas == 0) p->linhas = lado;
+        if (p->colunas == 0) p->colunas = lado;
+    }
+    if (p->linhas > INT_MAX || p->colunas > INT_MAX) return -1;
+
+    long long posicoes = p->linhas * p->colunas;
+    if (p->antenas == 0) p->antenas = (long long)(p->densidade * (double)posicoes);
+    if (p->antenas > posicoes) return -1;
+    return 0;
+}
+
+/**
+ * @brief Coloca as antenas na grelha do mapa
+ * @param p Parâmetros do gerador
+ * @param celulas Grelha de linhas * colunas carateres, já preenchida com '.'
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
+ *
+ * @details No modelo em agrupamentos, cada antena é colocada à volta de um
+ * centro escolhido ao acaso, com um desvio de distribuição triangular até ao
+ * raio em cada eixo. Se a posição sair do mapa ou já estiver ocupada ao fim
+ * de várias tentativas, a antena é colocada numa posição uniforme.
+ */
+static int colocar_antenas(const ParametrosGerador* p, char* celulas) {
+    unsigned long long estado = p->semente;
+
+    double* acumulada = (double*)malloc((size_t)p->frequencias * sizeof(double));
+    long long* centros = (long long*)malloc(2 * (size_t)(p->agrupamentos + 1) * sizeof(long long));
+    if (!acumulada || !centros) {
+        free(acumulada);
+        free(centros);
+        return -1;
+    }
+
+    double soma = 0.0;
+    for (int i = 0; i < p->frequencias; i++) {
+        soma += 1.0 / pow(i + 1, p->enviesamento);
+        acumulada[i] = soma;
+    }
+    for (int i = 0; i < p->frequencias; i++) acumulada[i] /= soma;
+
+    for (int i = 0; i < p->agrupamentos; i++) {
+        centros[2 * i] = aleatorio_ate(&estado, p->colunas);
+        centros[2 * i + 1] = aleatorio_ate(&estado, p->linhas);
+    }
+
+    for (long long n = 0; n < p->antenas; n++) {
+        long long x = -1, y = -1;
+        for (int t = 0; p->agrupamentos > 0 && t < TENTATIVAS_AGRUPAMENTO; t++) {
+            long long c = aleatorio_ate(&estado, p->agrupamentos);
+            double dx = (aleatorio_unitario(&estado) + aleatorio_unitario(&estado) - 1.0) * p->raio;
+            double dy = (aleatorio_unitario(&estado) + aleatorio_unitario(&estado) - 1.0) * p->raio;
+            long long cx = centros[2 * c] + (long long)floor(dx + 0.5);
+            long long cy = centros[2 * c + 1] + (long long)floor(dy + 0.5);
+            if (cx < 0 || cx >= p->colunas || cy < 0 || cy >= p->linhas) continue;
+            if (celulas[cy * p->colunas + cx] != '.') continue;
+            x = cx;
+            y = cy;
+            break;
+        }
+        while (x < 0) {
+            long long cx = aleatorio_ate(&estado, p->colunas);
+            long long cy = aleatorio_ate(&estado, p->linhas);
+            if (celulas[cy * p->colunas + cx] != '.') continue;
+            x = cx;
+            y = cy;
+        }
+        celulas[y * p->colunas + x] = FREQUENCIAS[escolher_frequencia(acumulada, p->frequencias, &estado)];
+    }
+
+    free(acumulada);
+    free(centros);
+    return 0;
+}
+
+/**
+ * @brief Função principal do gerador
+ * @param argc Número de argumentos
+ * @param argv Argumentos
+ * @return 0 se o mapa foi escrito, 1 em caso de erro
+ */
+int main(int argc, char** argv) {
+    ParametrosGerador p;
+    if (ler_parametros(argc, argv, &p) != 0) {
+        mostrar_utilizacao(argv[0]);
+        return 1;
+    }
+
+    size_t total = (size_t)p.linhas * (size_t)p.colunas;
+    char* celulas = (char*)malloc(total ? total : 1);
+    if (!celulas) {
+        fprintf(stderr, "Erro de memoria (%lld x %lld)\n", p.linhas, p.colunas);
+        return 1;
+    }
+    memset(celulas, '.', total);
+
+    if (colocar_antenas(&p, celulas) != 0) {
+        fprintf(stderr, "Erro de memoria\n");
+        free(celulas);
+        return 1;
+    }
+
+    FILE* f = fopen(p.ficheiro, "wb");
+    if (!f) {
+        fprintf(stderr, "Erro ao criar %s\n", p.ficheiro);
+        free(celulas);
+        return 1;
+    }
+    int estado = escrever_cabecalho_mapa(f, p.linhas, p.colunas);
+    if (estado == 0 && fwrite(celulas, 1, total, f) != total) estado = -1;
+    if (fclose(f) != 0) estado = -1;
+    free(celulas);
+
+    if (estado != 0) {
+        fprintf(stderr, "Erro ao escrever %s\n", p.ficheiro);
+        return 1;
+    }
+    printf("%s: %lld x %lld, %lld antenas, %d frequencias\n",
+           p.ficheiro, p.linhas, p.colunas, p.antenas, p.frequencias);
+    return 0;
+}
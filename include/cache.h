@@ -0,0 +1,226 @@
+/**
+ * @file cache.h
+ * @brief Cache de resultados de relatórios (intersecções e efeitos nefastos), em memória e em ficheiro
+ *
+ * @details Implementa as operações de:
+ * - Guarda de resultados com uma chave formada pelos parâmetros da consulta e
+ *   pelas assinaturas das frequências envolvidas (assinatura_frequencia)
+ * - Limite de memória, com descarte do resultado usado há mais tempo (LRU)
+ * - Invalidação dos resultados de uma só frequência
+ * - Gravação e leitura da cache num ficheiro ao lado do mapa
+ * - Intersecções entre duas frequências servidas pela cache
+ *
+ * Como as assinaturas dependem só do conteúdo de cada frequência, um resultado
+ * deixa de ser encontrado assim que uma das suas frequências muda, sem ser
+ * preciso avisar a cache, e continua válido para o mesmo mapa carregado de
+ * novo noutra execução. A cache pode ser usada por vários fios ao mesmo tempo.
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stddef.h>
+#include <pthread.h>
+#include "grafo.h"
+
+#define LIMITE_CACHE_RESULTADOS ((size_t)64 << 20)  ///< Memória ocupada por omissão pelos resultados (64 MiB)
+#define MAGIA_CACHE_RESULTADOS "EDACACHE"           ///< Identificação dos ficheiros de cache
+#define VERSAO_CACHE_RESULTADOS 1                   ///< Versão do formato dos ficheiros de cache
+#define EXTENSAO_CACHE_RESULTADOS ".cache"          ///< Extensão do ficheiro de cache de um mapa
+
+/**
+ * @brief Tipos de resultado guardados na cache
+ */
+typedef enum TipoResultado {
+    RESULTADO_INTERSECOES,  ///< Intersecções entre freq_a e freq_b (VALORES_INTERSECAO inteiros cada)
+    RESULTADO_EFEITOS,      ///< Posições com efeito nefasto de freq_a num mapa linhas x colunas (VALORES_EFEITO inteiros cada)
+    NUM_TIPOS_RESULTADO     ///< Número de tipos (não é um tipo)
+} TipoResultado;
+
+#define VALORES_INTERSECAO 10   ///< Ponto, a1, a2, b1 e b2, em pares (x, y)
+#define VALORES_EFEITO 2        ///< Posição (x, y)
+
+/**
+ * @brief Identificação de um resultado guardado
+ */
+typedef struct ChaveResultado ChaveResultado;
+
+/**
+ * @struct ChaveResultado
+ * @brief Parâmetros da consulta e assinaturas das frequências de quando foi calculada
+ *
+ * @details Os campos que não se aplicam a um tipo ficam a 0. O modo das arestas
+ * faz parte da chave porque, no modo explícito, as ligações também entram nas assinaturas.
+ */
+struct ChaveResultado {
+    int tipo;                           ///< TipoResultado
+    int modo;                           ///< ModoArestas do grafo
+    int freq_a;                         ///< Primeira frequência (0 .. NUM_FREQUENCIAS-1)
+    int freq_b;                         ///< Segunda frequência (intersecções)
+    int linhas;                         ///< Linhas do mapa (efeitos)
+    int colunas;                        ///< Colunas do mapa (efeitos)
+    unsigned long long assinatura_a;    ///< Assinatura de freq_a
+    unsigned long long assinatura_b;    ///< Assinatura de freq_b (intersecções)
+};
+
+/**
+ * @brief Resultado guardado na cache
+ */
+typedef struct EntradaResultado EntradaResultado;
+
+/**
+ * @struct EntradaResultado
+ * @brief Valores de um resultado, na tabela de dispersão e na lista de utilização
+ */
+struct EntradaResultado {
+    ChaveResultado chave;               ///< Identificação do resultado
+    int* valores;                       ///< num registos de valores_por_registo(tipo) inteiros
+    int num;                            ///< Número de registos
+    size_t bytes;                       ///< Memória ocupada pela entrada
+    EntradaResultado* seguinte;         ///< Próxima entrada na mesma posição da tabela
+    EntradaResultado* mais_recente;     ///< Entrada usada a seguir a esta (NULL na mais recente)
+    EntradaResultado* mais_antiga;      ///< Entrada usada antes desta (NULL na mais antiga)
+};
+
+/**
+ * @brief Cache de resultados com limite de memória
+ */
+typedef struct CacheResultados CacheResultados;
+
+/**
+ * @struct CacheResultados
+ * @brief Tabela de dispersão das entradas e lista por ordem de utilização
+ *
+ * @details Há no máximo uma entrada por consulta (tipo, modo, frequências e
+ * dimensões): um resultado novo para a mesma consulta substitui o anterior.
+ * Todas as operações são feitas com o trinco fechado.
+ */
+struct CacheResultados {
+    EntradaResultado** tabela;          ///< Listas de entradas por posição
+    int cap_tabela;                     ///< Número de posições (potência de 2)
+    int num_entradas;                   ///< Número de entradas guardadas
+    EntradaResultado* recente;          ///< Entrada usada há menos tempo
+    EntradaResultado* antiga;           ///< Entrada usada há mais tempo (a primeira a sair)
+    size_t bytes;                       ///< Memória ocupada pelas entradas
+    size_t limite;                      ///< Memória máxima das entradas
+    unsigned long acertos;              ///< Consultas respondidas pela cache
+    unsigned long falhas;               ///< Consultas que obrigaram a calcular
+    pthread_mutex_t trinco;             ///< Exclusão mútua entre fios
+};
+
+/**
+ * @brief Prepara uma cache vazia
+ * @param cache Cache a inicializar
+ * @param limite Memória máxima dos resultados em bytes (0 para LIMITE_CACHE_RESULTADOS)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int cache_resultados_iniciar(CacheResultados* cache, size_t limite);
+
+/**
+ * @brief Liberta todas as entradas e os recursos da cache
+ * @param cache Cache a libertar
+ */
+void cache_resultados_libertar(CacheResultados* cache);
+
+/**
+ * @brief Preenche a chave de um resultado com as assinaturas atuais do grafo
+ * @param[out] chave Chave a preencher
+ * @param grafo Grafo de onde vêm as assinaturas e o modo
+ * @param tipo Tipo do resultado
+ * @param freq_a Primeira frequência
+ * @param freq_b Segunda frequência (ignorada nos efeitos)
+ * @param linhas Linhas do mapa (ignoradas nas intersecções)
+ * @param colunas Colunas do mapa (ignoradas nas intersecções)
+ */
+void chave_resultado(ChaveResultado* chave, const Grafo* grafo, TipoResultado tipo, char freq_a, char freq_b,
+                     int linhas, int colunas);
+
+/**
+ * @brief Procura um resultado e devolve uma cópia dos seus valores
+ * @param cache Cache
+ * @param chave Chave do resultado
+ * @param[out] valores Vetor alocado com os valores (libertar com free; NULL se não houver registos)
+ * @param[out] num Número de registos
+ * @return 1 se o resultado foi encontrado, 0 se não, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int cache_resultados_obter(CacheResultados* cache, const ChaveResultado* chave, int** valores, int* num);
+
+/**
+ * @brief Guarda uma cópia de um resultado
+ * @param cache Cache
+ * @param chave Chave do resultado
+ * @param valores Valores (num registos)
+ * @param num Número de registos
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int cache_resultados_guardar(CacheResultados* cache, const ChaveResultado* chave, const int* valores, int num);
+
+/**
+ * @brief Descarta os resultados em que entra uma frequência
+ * @param cache Cache
+ * @param freq Frequência alterada
+ * @return Número de resultados descartados, ou -1 em caso de erro
+ */
+int cache_resultados_invalidar(CacheResultados* cache, char freq);
+
+/**
+ * @brief Grava todos os resultados da cache num ficheiro
+ * @param cache Cache
+ * @param ficheiro Caminho do ficheiro a criar
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int cache_resultados_gravar(CacheResultados* cache, const char* ficheiro);
+
+/**
+ * @brief Junta à cache os resultados gravados num ficheiro
+ * @param cache Cache
+ * @param ficheiro Caminho do ficheiro
+ * @return Número de resultados lidos, -1 se o ficheiro não puder ser aberto ou
+ * for inválido, -2 em caso de erro de memória
+ */
+int cache_resultados_ler(CacheResultados* cache, const char* ficheiro);
+
+/**
+ * @brief Obtém o caminho do ficheiro de cache de um mapa
+ * @param mapa Caminho do mapa (por exemplo data/mapa.bin)
+ * @param[out] nome Caminho da cache (data/mapa.cache)
+ * @param tamanho Tamanho de nome
+ * @return 0 em caso de sucesso, -1 se o caminho não couber em nome
+ */
+int nome_cache_mapa(const char* mapa, char* nome, size_t tamanho);
+
+/**
+ * @brief Encontra e imprime as intersecções entre duas frequências, servindo-as da cache quando possível
+ * @param grafo Apontador para o grafo
+ * @param cache Cache de resultados
+ * @param freqA Primeira frequência a considerar
+ * @param freqB Segunda frequência a considerar
+ * @return Número de intersecções, ou -1 em caso de erro
+ */
+int intersecoes_frequencias_cache(Grafo* grafo, CacheResultados* cache, char freqA, char freqB);
+
+/**
+ * @brief Encontra as intersecções entre duas frequências, chamando uma função para cada uma, servindo-as da cache quando possível
+ * @param grafo Apontador para o grafo (não é alterado)
+ * @param ctx Contexto que recebe os contadores das intersecções calculadas
+ * @param cache Cache de resultados (NULL para calcular sempre)
+ * @param freqA Primeira frequência a considerar
+ * @param freqB Segunda frequência a considerar
+ * @param num_fios Número de fios de execução da deteção (0 para usar um por processador)
+ * @param visita Função chamada para cada intersecção (pode ser NULL)
+ * @param dados Apontador passado a cada chamada de visita
+ * @return Número de intersecções, ou -1 em caso de erro
+ */
+int intersecoes_frequencias_cache_ctx(Grafo* grafo, ContextoProcura* ctx, CacheResultados* cache, char freqA,
+                                      char freqB, int num_fios, FuncaoIntersecao visita, void* dados);
+
+#endif // CACHE_H
@@ -0,0 +1,144 @@
+/**
+ * @file compacto.h
+ * @brief Representação compacta e imutável de um grafo de antenas, com índices de 32 bits
+ *
+ * @details Guarda um grafo já carregado no mínimo de memória:
+ * - Vértices num vetor denso (índice igual ao campo id de cada Vertice), sem listas ligadas
+ * - Coordenadas em 16 bits e frequência em 8 bits, juntas em 6 bytes por vértice
+ * - Adjacências em formato CSR com inícios e vizinhos de 32 bits
+ * - Procuras do CSR (VistaCSR), com marcas de visita de um bit por vértice
+ *
+ * Os mapas têm no máximo 65535 linhas e colunas; grafos com coordenadas
+ * maiores, ou com mais de 2^32 - 1 entradas de adjacência, não podem ser
+ * compactados. O grafo compacto é só de leitura e pode ser consultado por
+ * vários fios ao mesmo tempo.
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#ifndef COMPACTO_H
+#define COMPACTO_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "grafo.h"
+
+#define MAX_COORDENADA_COMPACTA 65535   ///< Maior coordenada representável
+
+/**
+ * @brief Vértice do grafo compacto
+ */
+typedef struct VerticeCompacto VerticeCompacto;
+
+/**
+ * @brief Grafo compacto
+ */
+typedef struct GrafoCompacto GrafoCompacto;
+
+/**
+ * @struct VerticeCompacto
+ * @brief Posição e frequência de uma antena em 6 bytes
+ */
+struct VerticeCompacto {
+    uint16_t x;             ///< Coordenada x (coluna)
+    uint16_t y;             ///< Coordenada y (linha)
+    uint8_t frequencia;     ///< Caracter da frequência
+};
+
+/**
+ * @struct GrafoCompacto
+ * @brief Vértices densos e adjacências CSR de 32 bits
+ *
+ * @details Os vizinhos do vértice v são vizinhos[inicios[v]] .. vizinhos[inicios[v+1]-1],
+ * pela mesma ordem que o IteradorVizinhos do grafo original os devolve.
+ * por_posicao tem os índices dos vértices ordenados por (y, x), para encontrar
+ * um vértice pelas coordenadas com uma pesquisa binária.
+ */
+struct GrafoCompacto {
+    uint32_t num_vertices;      ///< Número de vértices
+    uint32_t num_arestas;       ///< Número de entradas em vizinhos (cada ligação conta nos dois sentidos)
+    VerticeCompacto* vertices;  ///< Posição e frequência de cada vértice
+    uint32_t* inicios;          ///< Início das adjacências de cada vértice (num_vertices + 1 entradas)
+    uint32_t* vizinhos;         ///< Índices dos vértices vizinhos
+    uint32_t* por_posicao;      ///< Índices dos vértices por ordem de (y, x)
+};
+
+/**
+ * @brief Tipo das funções chamadas para cada vértice visitado numa procura compacta
+ * @param grafo Grafo compacto percorrido
+ * @param v Índice do vértice visitado
+ * @param dados Apontador passado à procura
+ * @return 0 para continuar, outro valor para terminar a procura
+ */
+typedef int (*FuncaoVisitaCompacto)(const GrafoCompacto* grafo, uint32_t v, void* dados);
+
+/**
+ * @brief Converte um grafo na sua representação compacta
+ * @param grafo Apontador para o grafo a compactar (só lido)
+ * @return Apontador para o grafo compacto, ou NULL em caso de erro, de falta de
+ * memória ou se o grafo não couber nos limites da representação
+ */
+GrafoCompacto* grafo_compactar(const Grafo* grafo);
+
+/**
+ * @brief Carrega um mapa diretamente para a representação compacta
+ * @param ficheiro Caminho para o ficheiro do mapa
+ * @return Apontador para o grafo compacto ou NULL em caso de erro
+ */
+GrafoCompacto* carregar_mapa_compacto(const char* ficheiro);
+
+/**
+ * @brief Liberta toda a memória associada a um grafo compacto
+ * @param grafo Apontador para o grafo compacto a destruir
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int destruir_grafo_compacto(GrafoCompacto* grafo);
+
+/**
+ * @brief Calcula a memória ocupada por um grafo compacto
+ * @param grafo Apontador para o grafo compacto
+ * @return Número de bytes dos vetores do grafo e da própria estrutura
+ */
+size_t compacto_memoria(const GrafoCompacto* grafo);
+
+/**
+ * @brief Encontra o índice de um vértice pelas suas coordenadas
+ * @param grafo Apontador para o grafo compacto
+ * @param x Coordenada x (coluna) do vértice
+ * @param y Coordenada y (linha) do vértice
+ * @return Índice do vértice ou -1 se não existir
+ */
+long long compacto_encontrar_vertice(const GrafoCompacto* grafo, int x, int y);
+
+/**
+ * @brief Executa uma procura em profundidade sobre o grafo compacto
+ * @param grafo Apontador para o grafo compacto
+ * @param inicio Índice do vértice de início
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 se a procura terminou, 1 se foi interrompida pela função de visita,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ */
+int compacto_procura_profundidade(const GrafoCompacto* grafo, uint32_t inicio,
+                                  FuncaoVisitaCompacto visita, void* dados);
+
+/**
+ * @brief Executa uma procura em largura sobre o grafo compacto
+ * @param grafo Apontador para o grafo compacto
+ * @param inicio Índice do vértice de início
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 se a procura terminou, 1 se foi interrompida pela função de visita,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ */
+int compacto_procura_largura(const GrafoCompacto* grafo, uint32_t inicio,
+                             FuncaoVisitaCompacto visita, void* dados);
+
+#endif // COMPACTO_H
@@ -0,0 +1,71 @@
+/**
+ * @file consultas.h
+ * @brief Execução em lote de consultas sobre um grafo de antenas já carregado
+ *
+ * @details Define a leitura e a execução de um ficheiro (ou canal) de consultas,
+ * uma por linha, sobre um grafo carregado uma só vez. Cada lote de consultas é
+ * repartido por vários fios de execução, cada um com o seu ContextoProcura, e
+ * os resultados são escritos pela ordem das consultas.
+ *
+ * Consultas aceites (coordenadas x y, frequências como carateres):
+ * - dfs x y                          Procura em profundidade
+ * - bfs x y                          Procura em largura
+ * - caminhos x1 y1 x2 y2 [s [n]]     Até n caminhos com até s saltos (0 = sem limite)
+ * - contar x1 y1 x2 y2 [s]           Número de caminhos com até s saltos
+ * - curto x1 y1 x2 y2 [s]            Caminho mais curto com até s saltos
+ * - alcanca x1 y1 x2 y2 s            Se o destino é alcançável em até s saltos
+ * - intersecoes A B                  Intersecções entre as frequências A e B
+ * - efeitos l c                      Posições com efeito nefasto num mapa de l linhas e c colunas
+ * - retangulo x0 y0 x1 y1 [F]        Antenas dentro do retângulo (da frequência F, se indicada)
+ * - raio x y r [F]                   Antenas a uma distância não superior a r
+ * - proximas x y [k [F]]             As k antenas mais próximas (1 por omissão)
+ *
+ * As linhas vazias e as começadas por '#' são ignoradas. As intersecções e os
+ * efeitos podem ser servidos por uma CacheResultados partilhada pelos fios.
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#ifndef CONSULTAS_H
+#define CONSULTAS_H
+
+#include <stdio.h>
+#include "grafo.h"
+#include "cache.h"
+
+#define MAX_LINHA_CONSULTA 256          ///< Tamanho máximo de uma linha de consulta, incluindo o fim de linha
+#define LOTE_CONSULTAS_OMISSAO 1024     ///< Consultas lidas antes de cada execução em paralelo
+#define MAX_CAMINHOS_CONSULTA 1000      ///< Caminhos escritos por omissão numa consulta "caminhos"
+
+/**
+ * @brief Executa as consultas lidas de um ficheiro e escreve os resultados noutro
+ * @param grafo Grafo sobre o qual as consultas são feitas (não é alterado)
+ * @param entrada Ficheiro de consultas, uma por linha
+ * @param saida Ficheiro de resultados
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @param tamanho_lote Número de consultas executadas de cada vez (1 para responder linha a linha)
+ * @return Número de consultas executadas, -1 em caso de erro, -2 em caso de erro de memória
+ */
+long long executar_consultas(Grafo* grafo, FILE* entrada, FILE* saida, int num_fios, int tamanho_lote);
+
+/**
+ * @brief Executa as consultas lidas de um ficheiro, servindo as intersecções e os efeitos de uma cache
+ * @param grafo Grafo sobre o qual as consultas são feitas (não é alterado)
+ * @param cache Cache de resultados partilhada pelos fios (NULL para calcular sempre)
+ * @param entrada Ficheiro de consultas, uma por linha
+ * @param saida Ficheiro de resultados
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @param tamanho_lote Número de consultas executadas de cada vez (1 para responder linha a linha)
+ * @return Número de consultas executadas, -1 em caso de erro, -2 em caso de erro de memória
+ */
+long long executar_consultas_cache(Grafo* grafo, CacheResultados* cache, FILE* entrada, FILE* saida,
+                                   int num_fios, int tamanho_lote);
+
+#endif // CONSULTAS_H
@@ -0,0 +1,170 @@
+/**
+ * @file csr.h
+ * @brief Representação compacta (CSR) e imutável de um grafo de antenas
+ *
+ * @details Converte um Grafo já carregado numa representação "Compressed Sparse Row":
+ * - Índices densos de vértices (iguais ao campo id de cada Vertice)
+ * - Vetores contíguos offsets[] e destinos[] com as adjacências
+ * - Coordenadas e frequências em vetores separados (x[], y[], frequencia[])
+ * - Versões CSR da procura em profundidade, em largura e dos caminhos
+ * - Procuras com função de visita sobre adjacências CSR de 64 ou de 32 bits
+ *   (VistaCSR), partilhadas com o grafo compacto (compacto.h)
+ * - Identificação das componentes ligadas em paralelo (union-find concorrente)
+ *
+ * Destina-se a cargas de trabalho só de consulta, depois do carregamento.
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#ifndef CSR_H
+#define CSR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "grafo.h"
+
+/**
+ * @brief Grafo congelado em formato CSR
+ */
+typedef struct GrafoCSR GrafoCSR;
+
+/**
+ * @struct GrafoCSR
+ * @brief Adjacências em vetores contíguos, indexadas por índice denso de vértice
+ *
+ * @details Os vizinhos do vértice v são destinos[offsets[v]] .. destinos[offsets[v+1]-1],
+ * pela mesma ordem que o IteradorVizinhos do grafo original os devolve.
+ * por_posicao tem os índices dos vértices ordenados por (y, x), para encontrar
+ * um vértice pelas coordenadas com uma pesquisa binária.
+ */
+struct GrafoCSR {
+    int num_vertices;       ///< Número de vértices
+    size_t num_arestas;     ///< Número de entradas em destinos (cada ligação conta nos dois sentidos)
+    size_t* offsets;        ///< Início das adjacências de cada vértice (num_vertices + 1 entradas)
+    int* destinos;          ///< Índices dos vértices vizinhos
+    int* x;                 ///< Coordenada x (coluna) de cada vértice
+    int* y;                 ///< Coordenada y (linha) de cada vértice
+    char* frequencia;       ///< Frequência de cada vértice
+    int* por_posicao;       ///< Índices dos vértices por ordem de (y, x)
+};
+
+/**
+ * @brief Adjacências CSR só de leitura, com inícios de 64 ou de 32 bits
+ */
+typedef struct VistaCSR VistaCSR;
+
+/**
+ * @struct VistaCSR
+ * @brief Vetores de adjacências de um GrafoCSR ou de um GrafoCompacto
+ *
+ * @details Só um dos vetores de inícios é usado: offsets, se não for NULL, ou
+ * inicios32. Os vizinhos do vértice v são destinos[inicio(v)] .. destinos[inicio(v+1)-1].
+ */
+struct VistaCSR {
+    int num_vertices;           ///< Número de vértices
+    const size_t* offsets;      ///< Inícios de 64 bits (NULL para usar inicios32)
+    const uint32_t* inicios32;  ///< Inícios de 32 bits
+    const int* destinos;        ///< Índices dos vértices vizinhos
+};
+
+/**
+ * @brief Tipo das funções chamadas para cada vértice visitado numa procura sobre uma VistaCSR
+ * @param v Índice do vértice visitado
+ * @param dados Apontador passado à procura
+ * @return 0 para continuar, outro valor para terminar a procura
+ */
+typedef int (*FuncaoVisitaCSR)(int v, void* dados);
+
+/**
+ * @brief Converte um grafo na sua representação CSR
+ * @param grafo Apontador para o grafo a congelar (só lido)
+ * @return Apontador para o grafo CSR ou NULL em caso de erro
+ */
+GrafoCSR* grafo_congelar(const Grafo* grafo);
+
+/**
+ * @brief Liberta toda a memória associada a um grafo CSR
+ * @param csr Apontador para o grafo CSR a destruir
+ */
+int destruir_grafo_csr(GrafoCSR* csr);
+
+/**
+ * @brief Encontra o índice de um vértice pelas suas coordenadas
+ * @param csr Apontador para o grafo CSR
+ * @param x Coordenada x (coluna) do vértice
+ * @param y Coordenada y (linha) do vértice
+ * @return Índice do vértice ou -1 se não existir
+ */
+int csr_encontrar_vertice(const GrafoCSR* csr, int x, int y);
+
+/**
+ * @brief Obtém a vista das adjacências de um grafo CSR
+ * @param csr Apontador para o grafo CSR
+ * @param[out] vista Vista a preencher
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int csr_vista(const GrafoCSR* csr, VistaCSR* vista);
+
+/**
+ * @brief Executa uma procura em profundidade sobre uma vista CSR
+ * @param vista Adjacências a percorrer
+ * @param inicio Índice do vértice de início
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 se a procura terminou, 1 se foi interrompida pela função de visita,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ */
+int csr_vista_profundidade(const VistaCSR* vista, int inicio, FuncaoVisitaCSR visita, void* dados);
+
+/**
+ * @brief Executa uma procura em largura sobre uma vista CSR
+ * @param vista Adjacências a percorrer
+ * @param inicio Índice do vértice de início
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 se a procura terminou, 1 se foi interrompida pela função de visita,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ */
+int csr_vista_largura(const VistaCSR* vista, int inicio, FuncaoVisitaCSR visita, void* dados);
+
+/**
+ * @brief Executa uma procura em profundidade (DFS) sobre o grafo CSR
+ * @param csr Apontador para o grafo CSR
+ * @param inicio Índice do vértice de início
+ */
+int csr_procura_profundidade(const GrafoCSR* csr, int inicio);
+
+/**
+ * @brief Executa uma procura em largura (BFS) sobre o grafo CSR
+ * @param csr Apontador para o grafo CSR
+ * @param inicio Índice do vértice de início
+ */
+int csr_procura_largura(const GrafoCSR* csr, int inicio);
+
+/**
+ * @brief Encontra e imprime todos os caminhos entre dois vértices do grafo CSR
+ * @param csr Apontador para o grafo CSR
+ * @param origem Índice do vértice de origem
+ * @param destino Índice do vértice de destino
+ */
+int csr_encontrar_caminhos(const GrafoCSR* csr, int origem, int destino);
+
+/**
+ * @brief Identifica as componentes ligadas do grafo CSR
+ * @param csr Apontador para o grafo CSR
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @param[out] componente Vetor alocado com a componente de cada vértice (libertar com free)
+ * @param[out] tamanhos Vetor alocado com o número de vértices de cada componente (libertar com free)
+ * @param[out] num_componentes Número de componentes
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int csr_componentes(const GrafoCSR* csr, int num_fios, int** componente, int** tamanhos, int* num_componentes);
+
+#endif // CSR_H
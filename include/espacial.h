@@ -0,0 +1,131 @@
+/**
+ * @file espacial.h
+ * @brief Índice espacial em grelha uniforme para conjuntos de pontos de coordenadas inteiras
+ *
+ * @details Implementa as operações de:
+ * - Construção de uma grelha de células quadradas sobre a caixa envolvente dos pontos
+ * - Enumeração dos pontos dentro de um retângulo ou de um círculo
+ * - Procura dos k pontos mais próximos de uma posição, por anéis de células
+ *
+ * A grelha não conhece o grafo: cada ponto é identificado pela sua posição no
+ * vetor de onde a grelha foi construída. As distâncias são euclidianas e
+ * calculadas em inteiros, ao quadrado, sem vírgula flutuante. As coordenadas
+ * devem estar no intervalo [-2^30, 2^30).
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#ifndef ESPACIAL_H
+#define ESPACIAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define PONTOS_POR_CELULA 4     ///< Número médio de pontos pretendido em cada célula
+
+/**
+ * @brief Grelha uniforme com os pontos de cada célula
+ */
+typedef struct GrelhaPontos GrelhaPontos;
+
+/**
+ * @struct GrelhaPontos
+ * @brief Pontos guardados célula a célula, com as coordenadas ao lado do índice
+ *
+ * @details Os pontos da célula c são as posições inicio[c] .. inicio[c+1]-1 de
+ * indices, px e py, pela ordem do vetor original. A célula (coluna, linha)
+ * cobre as posições [min_x + coluna*lado, min_x + (coluna+1)*lado) em x, e o
+ * mesmo em y.
+ */
+struct GrelhaPontos {
+    int num;                ///< Número de pontos
+    int min_x, min_y;       ///< Canto da caixa envolvente dos pontos
+    int max_x, max_y;       ///< Canto oposto (inclusive)
+    int lado;               ///< Lado de cada célula
+    int colunas, linhas;    ///< Dimensões da grelha em células
+    int* inicio;            ///< Início de cada célula (colunas * linhas + 1 entradas)
+    int* indices;           ///< Posição de cada ponto no vetor original
+    int* px;                ///< Coordenada x de cada ponto
+    int* py;                ///< Coordenada y de cada ponto
+    bool valida;            ///< A grelha corresponde aos pontos atuais (gerido por quem a mantém)
+};
+
+/**
+ * @brief Tipo das funções chamadas para cada ponto encontrado numa grelha
+ * @param indice Posição do ponto no vetor original
+ * @param x Coordenada x do ponto
+ * @param y Coordenada y do ponto
+ * @param dados Apontador passado à procura
+ * @return 0 para continuar, outro valor para terminar a enumeração
+ */
+typedef int (*FuncaoPonto)(int indice, int x, int y, void* dados);
+
+/**
+ * @brief Prepara uma grelha vazia e inválida
+ * @param grelha Grelha a inicializar
+ */
+void grelha_pontos_iniciar(GrelhaPontos* grelha);
+
+/**
+ * @brief Constrói a grelha de um conjunto de pontos, substituindo o conteúdo anterior
+ * @param grelha Grelha (já inicializada)
+ * @param x Coordenada x de cada ponto
+ * @param y Coordenada y de cada ponto
+ * @param num Número de pontos
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int grelha_pontos_construir(GrelhaPontos* grelha, const int* x, const int* y, int num);
+
+/**
+ * @brief Liberta a memória de uma grelha, que fica vazia e inválida
+ * @param grelha Grelha a libertar
+ */
+void grelha_pontos_libertar(GrelhaPontos* grelha);
+
+/**
+ * @brief Enumera os pontos dentro de um retângulo
+ * @param grelha Grelha construída
+ * @param x0 Coordenada x de um canto
+ * @param y0 Coordenada y de um canto
+ * @param x1 Coordenada x do canto oposto (inclusive)
+ * @param y1 Coordenada y do canto oposto (inclusive)
+ * @param visita Função chamada para cada ponto
+ * @param dados Apontador passado a cada chamada de visita
+ * @return Número de pontos passados a visita, ou -1 em caso de erro
+ */
+int grelha_pontos_retangulo(const GrelhaPontos* grelha, int x0, int y0, int x1, int y1,
+                            FuncaoPonto visita, void* dados);
+
+/**
+ * @brief Enumera os pontos a uma distância não superior a raio de uma posição
+ * @param grelha Grelha construída
+ * @param x Coordenada x do centro
+ * @param y Coordenada y do centro
+ * @param raio Raio do círculo (inclusive)
+ * @param visita Função chamada para cada ponto
+ * @param dados Apontador passado a cada chamada de visita
+ * @return Número de pontos passados a visita, ou -1 em caso de erro
+ */
+int grelha_pontos_raio(const GrelhaPontos* grelha, int x, int y, int raio, FuncaoPonto visita, void* dados);
+
+/**
+ * @brief Encontra os k pontos mais próximos de uma posição
+ * @param grelha Grelha construída
+ * @param x Coordenada x da posição
+ * @param y Coordenada y da posição
+ * @param k Número de pontos pretendido
+ * @param[out] indices Posição dos pontos no vetor original (k entradas), do mais próximo para o mais afastado
+ * @param[out] distancias Quadrado da distância de cada ponto (k entradas, pode ser NULL)
+ * @return Número de pontos encontrados (o menor entre k e num), ou -1 em caso de erro
+ */
+int grelha_pontos_proximos(const GrelhaPontos* grelha, int x, int y, int k,
+                           int* indices, unsigned long long* distancias);
+
+#endif // ESPACIAL_H
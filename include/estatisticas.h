@@ -0,0 +1,148 @@
+/**
+ * @file estatisticas.h
+ * @brief Contadores e tempos opcionais das operações sobre grafos de antenas
+ *
+ * @details Define:
+ * - A estrutura com os contadores e os tempos por fase de um grafo
+ * - As macros usadas nos caminhos críticos para os atualizar
+ * - Um relógio monótono em nanossegundos
+ * - A escrita das estatísticas em JSON
+ *
+ * As macros só fazem alguma coisa se o código for compilado com
+ * EDA_ESTATISTICAS definido (por exemplo, make ESTATISTICAS=1); caso contrário
+ * não geram código e os contadores ficam a 0. A estrutura tem sempre o mesmo
+ * formato, pelo que bibliotecas compiladas com e sem a opção podem ser juntas.
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#ifndef ESTATISTICAS_H
+#define ESTATISTICAS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+/**
+ * @brief Fases cronometradas
+ */
+typedef enum FaseEstatisticas {
+    FASE_CARREGAMENTO,          ///< carregar_mapa_modo, do mapeamento do ficheiro ao grafo ligado
+    FASE_LIGACAO,               ///< Ligação das antenas da mesma frequência, dentro do carregamento
+    FASE_PROCURA_PROFUNDIDADE,  ///< procura_profundidade_visitar
+    FASE_PROCURA_LARGURA,       ///< procura_largura_visitar
+    FASE_CAMINHOS,              ///< encontrar_caminhos_visitar_limitado
+    FASE_CAMINHO_MAIS_CURTO,    ///< caminho_mais_curto e variantes (incluindo alcancavel)
+    FASE_RECOLHA_SEGMENTOS,     ///< Recolha dos segmentos das frequências nas intersecções
+    FASE_DETECAO_INTERSECOES,   ///< Deteção dos cruzamentos entre os segmentos recolhidos
+    NUM_FASES                   ///< Número de fases
+} FaseEstatisticas;
+
+/**
+ * @brief Contadores da deteção de intersecções
+ */
+typedef struct ContadoresIntersecao ContadoresIntersecao;
+
+/**
+ * @struct ContadoresIntersecao
+ * @brief Trabalho feito por uma deteção de intersecções
+ */
+struct ContadoresIntersecao {
+    unsigned long long testes_segmentos;    ///< Pares de segmentos testados
+    unsigned long long sondagens_pontos;    ///< Posições consultadas nas tabelas de pontos já vistos
+};
+
+/**
+ * @brief Estatísticas acumuladas de um grafo
+ */
+typedef struct EstatisticasGrafo EstatisticasGrafo;
+
+/**
+ * @struct EstatisticasGrafo
+ * @brief Contadores e tempos acumulados desde a criação do grafo ou o último reinício
+ */
+struct EstatisticasGrafo {
+    unsigned long long vertices_criados;        ///< Vértices adicionados
+    unsigned long long arestas_criadas;         ///< Ligações criadas (cada uma conta uma vez)
+    unsigned long long verificacoes_duplicados; ///< Arestas comparadas por adicionar_aresta à procura de duplicados
+    unsigned long long enfileirados;            ///< Vértices postos na fila pelas procuras em largura
+    unsigned long long profundidade_procura;    ///< Maior profundidade da pilha das procuras em profundidade
+    unsigned long long profundidade_caminhos;   ///< Maior profundidade de recursão da procura de caminhos
+    ContadoresIntersecao intersecoes;           ///< Trabalho acumulado das deteções de intersecções
+    unsigned long long execucoes[NUM_FASES];    ///< Número de execuções de cada fase
+    unsigned long long tempo_ns[NUM_FASES];     ///< Tempo total de cada fase, em nanossegundos
+};
+
+#ifdef EDA_ESTATISTICAS
+/** @brief Soma n a um contador */
+#define ESTAT_SOMAR(contador, n) ((contador) += (unsigned long long)(n))
+/** @brief Guarda v num contador, se for maior do que o valor guardado */
+#define ESTAT_MAXIMO(contador, v) \
+    do { if ((unsigned long long)(v) > (contador)) (contador) = (unsigned long long)(v); } while (0)
+/** @brief Declara a variável inicio com o instante atual */
+#define ESTAT_INICIAR_TEMPO(inicio) unsigned long long inicio = relogio_monotono_ns()
+/** @brief Acumula na fase o tempo decorrido desde inicio */
+#define ESTAT_TERMINAR_TEMPO(estatisticas, fase, inicio) \
+    estatisticas_registar_fase((estatisticas), (fase), relogio_monotono_ns() - (inicio))
+#else
+#define ESTAT_SOMAR(contador, n) ((void)0)
+#define ESTAT_MAXIMO(contador, v) ((void)0)
+#define ESTAT_INICIAR_TEMPO(inicio) ((void)0)
+#define ESTAT_TERMINAR_TEMPO(estatisticas, fase, inicio) ((void)0)
+#endif
+
+/**
+ * @brief Lê o relógio monótono do sistema
+ * @return Instante atual em nanossegundos, a partir de uma origem arbitrária
+ */
+unsigned long long relogio_monotono_ns(void);
+
+/**
+ * @brief Indica se a biblioteca foi compilada com as estatísticas ativas
+ * @return true se EDA_ESTATISTICAS estava definido
+ */
+bool estatisticas_ativas(void);
+
+/**
+ * @brief Põe todos os contadores e tempos a 0
+ * @param estatisticas Estatísticas a limpar
+ */
+void estatisticas_limpar(EstatisticasGrafo* estatisticas);
+
+/**
+ * @brief Acumula uma execução de uma fase
+ * @param estatisticas Estatísticas a atualizar
+ * @param fase Fase executada
+ * @param tempo_ns Duração da execução, em nanossegundos
+ */
+void estatisticas_registar_fase(EstatisticasGrafo* estatisticas, FaseEstatisticas fase, unsigned long long tempo_ns);
+
+/**
+ * @brief Junta umas estatísticas a outras
+ * @param destino Estatísticas a que se soma
+ * @param origem Estatísticas a somar
+ */
+void estatisticas_juntar(EstatisticasGrafo* destino, const EstatisticasGrafo* origem);
+
+/**
+ * @brief Obtém o nome de uma fase, tal como aparece no JSON
+ * @param fase Fase
+ * @return Nome da fase, ou "desconhecida"
+ */
+const char* nome_fase(FaseEstatisticas fase);
+
+/**
+ * @brief Escreve as estatísticas num objeto JSON
+ * @param estatisticas Estatísticas a escrever
+ * @param f Ficheiro de saída
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int escrever_estatisticas_json(const EstatisticasGrafo* estatisticas, FILE* f);
+
+#endif // ESTATISTICAS_H
@@ -8,6 +8,10 @@
  * - Algoritmos de procura em grafos (DFS e BFS)
  * - Cálculo de caminhos entre antenas
  * - Deteção de intersecções entre frequências diferentes
+ * - Alterações incrementais: adicionar, remover e mover antenas sem recarregar
+ * - Contadores e tempos opcionais das operações (ver estatisticas.h)
+ * - Contextos de procura, para vários fios consultarem o mesmo grafo em simultâneo
+ * - Consultas espaciais por retângulo, raio e antenas mais próximas (ver espacial.h)
  * 
  * @author Diogo Pereira
  * @date 18 Maio 2025
@@ -23,6 +27,10 @@
 #define GRAFO_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include "estatisticas.h"
+#include "saida.h"
+#include "espacial.h"
 
 /**
  * @brief Estrutura que representa um vértice do grafo (antena)
@@ -45,26 +53,90 @@ typedef struct Grafo Grafo;
 typedef struct CaminhoNode CaminhoNode;
 
 /**
- * @brief Estrutura auxiliar para implementação de filas (usada em BFS)
+ * @brief Estrutura para representação de intersecções entre frequências
  */
-typedef struct NodeFila NodeFila;
+typedef struct Intersecao Intersecao;
 
 /**
- * @brief Estrutura para representação de intersecções entre frequências
+ * @brief Iterador sobre os vizinhos de um vértice, independente da representação
  */
-typedef struct Intersecao Intersecao;
+typedef struct IteradorVizinhos IteradorVizinhos;
+
+/**
+ * @brief Bloco de memória de um pool de nós
+ */
+typedef struct BlocoPool BlocoPool;
+
+/**
+ * @brief Pool de nós de tamanho fixo, reservados em blocos
+ */
+typedef struct Pool Pool;
+
+/**
+ * @brief Estado de rascunho de uma procura, separado do grafo
+ */
+typedef struct ContextoProcura ContextoProcura;
+
+/**
+ * @brief Antenas a juntar de uma vez a um grafo (ver adicionar_vertices_lotes)
+ */
+typedef struct LoteAntenas LoteAntenas;
+
+/**
+ * @brief Número de frequências distintas possíveis (uma por valor de char)
+ */
+#define NUM_FREQUENCIAS 256
+
+/**
+ * @brief Valor de frequência que, nas consultas espaciais, abrange todas as frequências
+ */
+#define TODAS_FREQUENCIAS NUM_FREQUENCIAS
+
+/**
+ * @brief Forma como as arestas entre antenas da mesma frequência são guardadas
+ */
+typedef enum {
+    ARESTAS_EXPLICITAS,     ///< Cada ligação é um nó Aresta na lista do vértice
+    ARESTAS_IMPLICITAS      ///< Vizinhos derivados do vetor de vértices da frequência
+} ModoArestas;
+
+/**
+ * @brief Função chamada para cada vértice visitado por uma procura
+ * @param v Vértice visitado
+ * @param dados Apontador fornecido por quem iniciou a procura
+ * @return 0 para continuar a procura, outro valor para a terminar
+ */
+typedef int (*FuncaoVisita)(Vertice* v, void* dados);
+
+/**
+ * @brief Função chamada para cada caminho encontrado entre duas antenas
+ * @param caminho Último nó do caminho (o destino); os nós seguintes recuam até à origem
+ * @param comprimento Número de vértices no caminho
+ * @param dados Apontador fornecido por quem iniciou a procura
+ * @return 0 para continuar a procura, outro valor para a terminar
+ */
+typedef int (*FuncaoCaminho)(CaminhoNode* caminho, int comprimento, void* dados);
+
+/**
+ * @brief Função chamada para cada intersecção encontrada entre duas frequências
+ * @param intersecao Ponto e extremos das duas linhas (o campo prox não é usado)
+ * @param dados Apontador fornecido por quem iniciou a procura
+ * @return 0 para continuar, outro valor para terminar
+ */
+typedef int (*FuncaoIntersecao)(Intersecao* intersecao, void* dados);
 
 /**
  * @struct Vertice
  * @brief Representa uma antena no grafo
  */
 struct Vertice {
+    int id;                 ///< Índice denso do vértice (0 .. num_vertices-1, por ordem de inserção enquanto não houver remoções)
     char frequencia;        ///< Caracter que representa a frequência da antena
     int x;                  ///< Coordenada x (coluna) da antena no mapa
     int y;                  ///< Coordenada y (linha) da antena no mapa
-    bool visitado;          ///< Flag para marcar se o vértice foi visitado em algoritmos de procura
     Aresta* arestas;        ///< Lista de arestas que partem deste vértice
     Vertice* proximo;       ///< Próximo vértice na lista de vértices do grafo
+    Vertice* anterior;      ///< Vértice anterior na lista de vértices do grafo (NULL no primeiro)
 };
 
 /**
@@ -74,6 +146,58 @@ struct Vertice {
 struct Aresta {
     Vertice* destino;       ///< Vértice de destino da aresta
     Aresta* proxima;        ///< Próxima aresta na lista de arestas do vértice
+    Aresta* anterior;       ///< Aresta anterior na lista de arestas do vértice (NULL na primeira)
+    Aresta* par;            ///< Aresta do sentido oposto, na lista do destino
+};
+
+/**
+ * @struct LoteAntenas
+ * @brief Frequência e posição de uma sequência de antenas, em vetores paralelos
+ */
+struct LoteAntenas {
+    const char* frequencia; ///< Frequência de cada antena
+    const int* x;           ///< Coordenada x (coluna) de cada antena
+    const int* y;           ///< Coordenada y (linha) de cada antena
+    int num;                ///< Número de antenas
+};
+
+/**
+ * @struct Pool
+ * @brief Reserva nós de tamanho fixo em blocos grandes, em vez de um malloc por nó
+ * 
+ * @details Os nós devolvidos ficam numa lista de livres para reutilização.
+ * Um pool pode ser reiniciado (todos os nós passam a livres, os blocos mantêm-se)
+ * ou libertado de uma vez, sem percorrer os nós um a um.
+ */
+struct Pool {
+    size_t tamanho;         ///< Tamanho de cada nó em bytes (arredondado ao alinhamento)
+    size_t por_bloco;       ///< Número de nós em cada bloco
+    BlocoPool* blocos;      ///< Primeiro bloco alocado
+    BlocoPool* atual;       ///< Bloco de onde se estão a reservar nós novos
+    size_t usados;          ///< Nós já reservados do bloco atual
+    void* livres;           ///< Lista de nós devolvidos, prontos a reutilizar
+};
+
+/**
+ * @struct ContextoProcura
+ * @brief Marcas de visita, antecessores, fila, pilha, nós de caminho e contadores de uma procura
+ * 
+ * @details As procuras só escrevem no contexto que recebem e apenas leem o grafo.
+ * Com um contexto por fio de execução, vários fios podem consultar o mesmo grafo
+ * ao mesmo tempo, desde que nenhum o altere durante as consultas. As marcas são
+ * indexadas pelo índice denso dos vértices e crescem com o grafo.
+ */
+struct ContextoProcura {
+    unsigned int* marcas;   ///< Época da última procura que visitou cada vértice, por índice denso
+    int cap_marcas;         ///< Número de posições de marcas e de anteriores
+    Vertice** anteriores;   ///< Vértice de onde cada vértice foi alcançado no caminho mais curto, por índice denso
+    unsigned int epoca;     ///< Época da procura atual; um vértice está visitado se marcas[id] == epoca
+    Vertice** fila;         ///< Fila circular da procura em largura, reutilizada entre procuras
+    int cap_fila;           ///< Capacidade da fila (acompanha num_vertices)
+    IteradorVizinhos* pilha;  ///< Pilha da procura em profundidade, reutilizada entre procuras
+    int cap_pilha;          ///< Capacidade da pilha (cresce por duplicação)
+    Pool pool_caminho;      ///< Pool de rascunho para os nós de caminho
+    EstatisticasGrafo estatisticas;  ///< Contadores e tempos das procuras feitas com o contexto
 };
 
 /**
@@ -83,15 +207,20 @@ struct Aresta {
 struct Grafo {
     Vertice* vertices;      ///< Lista de vértices (antenas) do grafo
     int num_vertices;       ///< Contador do número total de vértices no grafo
-};
-
-/**
- * @struct NodeFila
- * @brief Nó auxiliar para implementação de filas (usada em BFS)
- */
-struct NodeFila {
-    Vertice* vertice;       ///< Vértice armazenado no nó
-    NodeFila* prox;         ///< Próximo nó na fila
+    ModoArestas modo;       ///< Representação das arestas (explícita ou implícita)
+    Vertice** por_frequencia[NUM_FREQUENCIAS];  ///< Vértices de cada frequência, por ordem de inserção
+    int num_por_frequencia[NUM_FREQUENCIAS];    ///< Número de vértices de cada frequência
+    int cap_por_frequencia[NUM_FREQUENCIAS];    ///< Capacidade alocada de cada vetor de frequência
+    Vertice** por_id;       ///< Vértice de cada índice denso
+    int cap_por_id;         ///< Capacidade alocada de por_id
+    unsigned long long assinatura[NUM_FREQUENCIAS];  ///< Assinatura do conteúdo de cada frequência (ver assinatura_frequencia)
+    Vertice** indice;       ///< Tabela de dispersão por coordenadas (endereçamento aberto)
+    int cap_indice;         ///< Número de posições da tabela (potência de 2, 0 se vazia)
+    Pool pool_vertices;     ///< Pool de onde são reservados os vértices
+    Pool pool_arestas;      ///< Pool de onde são reservadas as arestas
+    GrelhaPontos espacial[NUM_FREQUENCIAS];  ///< Índice espacial de cada frequência, por posição em por_frequencia (ver indexar_grafo)
+    ContextoProcura contexto;  ///< Contexto usado pelas procuras que não recebem um
+    EstatisticasGrafo estatisticas;  ///< Contadores da construção do grafo (só atualizados com EDA_ESTATISTICAS)
 };
 
 /**
@@ -114,11 +243,74 @@ struct Intersecao {
     Intersecao* prox;       ///< Próxima intersecção na lista
 };
 
+/**
+ * @struct IteradorVizinhos
+ * @brief Estado de iteração sobre os vizinhos de um vértice
+ * 
+ * @details No modo explícito percorre a lista de arestas; no modo implícito
+ * percorre o vetor de vértices da mesma frequência, saltando o próprio vértice.
+ */
+struct IteradorVizinhos {
+    Vertice* origem;        ///< Vértice cujos vizinhos estão a ser percorridos
+    Aresta* aresta;         ///< Próxima aresta a devolver (modo explícito)
+    Vertice** balde;        ///< Vértices da frequência da origem (modo implícito)
+    int indice;             ///< Próxima posição do balde a devolver (modo implícito)
+    int total;              ///< Número de vértices no balde (modo implícito)
+};
+
+/**
+ * @brief Prepara um pool vazio para nós de um dado tamanho
+ * @param pool Pool a inicializar
+ * @param tamanho Tamanho de cada nó em bytes
+ */
+int pool_iniciar(Pool* pool, size_t tamanho);
+
+/**
+ * @brief Reserva um nó do pool
+ * @param pool Pool de onde reservar
+ * @return Apontador para o nó ou NULL em caso de erro de memória
+ */
+void* pool_reservar(Pool* pool);
+
+/**
+ * @brief Devolve um nó ao pool para ser reutilizado
+ * @param pool Pool de onde o nó foi reservado
+ * @param no Nó a devolver
+ */
+void pool_devolver(Pool* pool, void* no);
+
+/**
+ * @brief Reserva vários nós contíguos do pool, num bloco próprio
+ * @param pool Pool de onde reservar
+ * @param num Número de nós
+ * @return Apontador para o primeiro nó (os seguintes estão a pool->tamanho bytes
+ * uns dos outros) ou NULL se num for 0 ou em caso de erro de memória
+ */
+void* pool_reservar_vetor(Pool* pool, size_t num);
+
+/**
+ * @brief Marca todos os nós do pool como livres, mantendo os blocos alocados
+ * @param pool Pool a reiniciar
+ */
+void pool_reiniciar(Pool* pool);
+
+/**
+ * @brief Liberta todos os blocos do pool
+ * @param pool Pool a libertar
+ */
+void pool_libertar(Pool* pool);
+
 /**
  * @brief Cria um novo grafo vazio
  */
 Grafo* criar_grafo();
 
+/**
+ * @brief Cria um novo grafo vazio com a representação de arestas indicada
+ * @param modo ARESTAS_EXPLICITAS ou ARESTAS_IMPLICITAS
+ */
+Grafo* criar_grafo_modo(ModoArestas modo);
+
 /**
  * @brief Liberta toda a memória associada ao grafo
  * @param grafo Apontador para o grafo a destruir
@@ -134,18 +326,102 @@ int destruir_grafo(Grafo* grafo);
  */
 Vertice* adicionar_vertice(Grafo* grafo, char freq, int x, int y);
 
+/**
+ * @brief Adiciona uma antena e liga-a às restantes antenas da sua frequência
+ * @param grafo Apontador para o grafo
+ * @param freq Frequência da antena (caracter)
+ * @param x Coordenada x (coluna) da antena
+ * @param y Coordenada y (linha) da antena
+ * @return Apontador para o novo vértice, ou NULL se a posição estiver ocupada ou em caso de erro
+ */
+Vertice* adicionar_vertice_ligado(Grafo* grafo, char freq, int x, int y);
+
+/**
+ * @brief Adiciona ao grafo as antenas de vários lotes, repartindo o trabalho por vários fios
+ * @param grafo Apontador para o grafo
+ * @param lotes Lotes de antenas
+ * @param num_lotes Número de lotes
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Equivale a chamar adicionar_vertice para cada antena, lote a lote
+ */
+int adicionar_vertices_lotes(Grafo* grafo, const LoteAntenas* lotes, int num_lotes, int num_fios);
+
+/**
+ * @brief Indica se um vértice pertence ao grafo (não foi removido)
+ * @param grafo Apontador para o grafo
+ * @param v Vértice a confirmar
+ * @return true se v for um vértice atual do grafo
+ */
+bool vertice_pertence(const Grafo* grafo, const Vertice* v);
+
+/**
+ * @brief Remove uma antena do grafo, com todas as suas arestas
+ * @param grafo Apontador para o grafo
+ * @param v Vértice a remover
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int remover_vertice(Grafo* grafo, Vertice* v);
+
+/**
+ * @brief Muda uma antena de posição
+ * @param grafo Apontador para o grafo
+ * @param v Vértice a mover
+ * @param x Nova coordenada x (coluna)
+ * @param y Nova coordenada y (linha)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 se a nova posição estiver ocupada
+ */
+int mover_vertice(Grafo* grafo, Vertice* v, int x, int y);
+
+/**
+ * @brief Obtém a assinatura do conjunto de antenas de uma frequência
+ * @param grafo Apontador para o grafo
+ * @param freq Frequência
+ * @return Assinatura (0 se a frequência não tiver antenas)
+ */
+unsigned long long assinatura_frequencia(Grafo* grafo, char freq);
+
 /**
  * @brief Adiciona uma aresta entre dois vértices (antenas da mesma frequência)
+ * @param grafo Apontador para o grafo
  * @param origem Vértice de origem
  * @param destino Vértice de destino
  */
-int adicionar_aresta(Vertice* origem, Vertice* destino);
+int adicionar_aresta(Grafo* grafo, Vertice* origem, Vertice* destino);
 
 /**
- * @brief Função recursiva auxiliar para procura em profundidade (DFS)
- * @param v Vértice atual a visitar
+ * @brief Adiciona uma aresta entre dois vértices sem verificar se já existe
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ */
+int adicionar_aresta_nova(Grafo* grafo, Vertice* origem, Vertice* destino);
+
+/**
+ * @brief Liga entre si todas as antenas de cada frequência, repartindo as frequências por vários fios
+ * @param grafo Apontador para o grafo (modo explícito)
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Não procura duplicados: destina-se a grafos cujas antenas ainda não têm arestas
+ */
+int ligar_frequencias(Grafo* grafo, int num_fios);
+
+/**
+ * @brief Prepara um iterador sobre os vizinhos de um vértice
+ * @param grafo Apontador para o grafo
+ * @param v Vértice cujos vizinhos se pretende percorrer
+ * @param[out] it Iterador a inicializar
+ */
+int iniciar_vizinhos(const Grafo* grafo, Vertice* v, IteradorVizinhos* it);
+
+/**
+ * @brief Devolve o próximo vizinho de um iterador
+ * @param it Iterador inicializado com iniciar_vizinhos
+ * @return Próximo vizinho ou NULL quando não existem mais
  */
-int procura_profundidade_rec(Vertice* v);
+Vertice* proximo_vizinho(IteradorVizinhos* it);
 
 /**
  * @brief Executa uma procura em profundidade (DFS) a partir de um vértice
@@ -154,6 +430,42 @@ int procura_profundidade_rec(Vertice* v);
  */
 int procura_profundidade(Grafo* grafo, Vertice* inicio);
 
+/**
+ * @brief Executa uma procura em profundidade chamando uma função para cada vértice
+ * @param grafo Apontador para o grafo
+ * @param inicio Vértice de início da procura
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ */
+int procura_profundidade_visitar(Grafo* grafo, Vertice* inicio, FuncaoVisita visita, void* dados);
+
+/**
+ * @brief Prepara um contexto de procura vazio
+ * @param ctx Contexto a inicializar
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int contexto_iniciar(ContextoProcura* ctx);
+
+/**
+ * @brief Liberta a memória de um contexto de procura
+ * @param ctx Contexto a libertar
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int contexto_libertar(ContextoProcura* ctx);
+
+/**
+ * @brief Igual a procura_profundidade_visitar, mas com o estado da procura num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto da procura (marcas, pilha e contadores)
+ * @param inicio Vértice de início da procura
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 se a procura terminou, 1 se foi interrompida pela função de visita,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ */
+int procura_profundidade_visitar_ctx(const Grafo* grafo, ContextoProcura* ctx, Vertice* inicio,
+                                     FuncaoVisita visita, void* dados);
+
 /**
  * @brief Executa uma procura em largura (BFS) a partir de um vértice
  * @param grafo Apontador para o grafo
@@ -161,19 +473,70 @@ int procura_profundidade(Grafo* grafo, Vertice* inicio);
  */
 int procura_largura(Grafo* grafo, Vertice* inicio);
 
+/**
+ * @brief Executa uma procura em largura chamando uma função para cada vértice
+ * @param grafo Apontador para o grafo
+ * @param inicio Vértice de início da procura
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ */
+int procura_largura_visitar(Grafo* grafo, Vertice* inicio, FuncaoVisita visita, void* dados);
+
+/**
+ * @brief Igual a procura_largura_visitar, mas com o estado da procura num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto da procura (marcas, fila e contadores)
+ * @param inicio Vértice de início da procura
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 se a procura terminou, 1 se foi interrompida pela função de visita,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ */
+int procura_largura_visitar_ctx(const Grafo* grafo, ContextoProcura* ctx, Vertice* inicio,
+                                FuncaoVisita visita, void* dados);
+
+/**
+ * @brief Função de visita que imprime o vértice visitado
+ * @param v Vértice visitado
+ * @param dados Não usado
+ */
+int imprimir_visita(Vertice* v, void* dados);
+
+/**
+ * @brief Função de intersecção que imprime a linha de cada intersecção
+ * @param intersecao Intersecção encontrada
+ * @param dados Apontador para um bool, inicialmente false, que indica se o cabeçalho já foi impresso
+ * @return 0, para a enumeração continuar
+ */
+int imprimir_intersecao(Intersecao* intersecao, void* dados);
+
 /**
  * @brief Imprime um caminho na ordem inversa (auxiliar para encontrar_caminhos_rec)
  * @param caminho Apontador para o nó do caminho a imprimir
  */
 void imprimir_caminho_inverso(CaminhoNode* caminho);
 
+/**
+ * @brief Função de caminho que imprime o caminho numerado
+ * @param caminho Último nó do caminho
+ * @param comprimento Número de vértices no caminho
+ * @param dados Apontador para o contador de caminhos (int), incrementado a cada caminho
+ */
+int imprimir_caminho(CaminhoNode* caminho, int comprimento, void* dados);
+
 /**
  * @brief Função recursiva auxiliar para encontrar todos os caminhos entre dois vértices
+ * @param grafo Apontador para o grafo
  * @param atual Vértice atual na procura
  * @param destino Vértice de destino
  * @param caminho_atual Caminho percorrido até ao momento
+ * @param comprimento Número de vértices em caminho_atual
+ * @param max_saltos Número máximo de arestas por caminho (0 para não limitar)
+ * @param visita Função chamada para cada caminho encontrado
+ * @param dados Apontador passado a cada chamada de visita
  */
-int encontrar_caminhos_rec(Vertice* atual, Vertice* destino, CaminhoNode* caminho_atual);
+int encontrar_caminhos_rec(Grafo* grafo, Vertice* atual, Vertice* destino, CaminhoNode* caminho_atual,
+                           int comprimento, int max_saltos, FuncaoCaminho visita, void* dados);
 
 /**
  * @brief Encontra e imprime todos os caminhos entre duas antenas
@@ -183,6 +546,152 @@ int encontrar_caminhos_rec(Vertice* atual, Vertice* destino, CaminhoNode* caminh
  */
 int encontrar_caminhos(Grafo* grafo, Vertice* origem, Vertice* destino);
 
+/**
+ * @brief Encontra todos os caminhos entre duas antenas, chamando uma função para cada um
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param visita Função chamada para cada caminho encontrado
+ * @param dados Apontador passado a cada chamada de visita
+ */
+int encontrar_caminhos_visitar(Grafo* grafo, Vertice* origem, Vertice* destino, FuncaoCaminho visita, void* dados);
+
+/**
+ * @brief Igual a encontrar_caminhos_visitar, mas ignora caminhos com mais de max_saltos arestas
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas por caminho (0 para não limitar)
+ * @param visita Função chamada para cada caminho encontrado
+ * @param dados Apontador passado a cada chamada de visita
+ */
+int encontrar_caminhos_visitar_limitado(Grafo* grafo, Vertice* origem, Vertice* destino, int max_saltos,
+                                        FuncaoCaminho visita, void* dados);
+
+/**
+ * @brief Igual a encontrar_caminhos_visitar_limitado, mas com o estado da procura num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto da procura (marcas, nós de caminho e contadores)
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas por caminho (0 para não limitar)
+ * @param visita Função chamada para cada caminho encontrado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 em caso de sucesso, 1 se a função de visita pediu para terminar,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ */
+int encontrar_caminhos_visitar_limitado_ctx(const Grafo* grafo, ContextoProcura* ctx, Vertice* origem,
+                                            Vertice* destino, int max_saltos, FuncaoCaminho visita, void* dados);
+
+/**
+ * @brief Imprime no máximo max_caminhos caminhos com no máximo max_saltos arestas
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_caminhos Número máximo de caminhos a imprimir (0 para não limitar)
+ * @param max_saltos Número máximo de arestas por caminho (0 para não limitar)
+ */
+int encontrar_caminhos_limitado(Grafo* grafo, Vertice* origem, Vertice* destino, int max_caminhos, int max_saltos);
+
+/**
+ * @brief Conta os caminhos simples entre duas antenas sem os enumerar
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas por caminho (0 para não limitar)
+ * @param[out] total Número de caminhos (saturado em ULLONG_MAX)
+ * @return 0 se o valor é exato, 1 se saturou, valor negativo em caso de erro
+ */
+int contar_caminhos(Grafo* grafo, Vertice* origem, Vertice* destino, int max_saltos, unsigned long long* total);
+
+/**
+ * @brief Igual a contar_caminhos, mas enumera (quando precisa) com um contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto da procura
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas por caminho (0 para não limitar)
+ * @param[out] total Número de caminhos (saturado em ULLONG_MAX)
+ * @return 0 se o valor é exato, 1 se saturou, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int contar_caminhos_ctx(const Grafo* grafo, ContextoProcura* ctx, Vertice* origem, Vertice* destino,
+                        int max_saltos, unsigned long long* total);
+
+/**
+ * @brief Encontra um caminho com o menor número de saltos entre duas antenas
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas do caminho (0 para não limitar)
+ * @param[out] caminho Vetor alocado com os vértices do caminho, de origem a destino
+ * (a libertar com free; pode ser NULL se só interessar o comprimento)
+ * @return Número de vértices do caminho, 0 se destino não é alcançável,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ */
+int caminho_mais_curto(Grafo* grafo, Vertice* origem, Vertice* destino, int max_saltos, Vertice*** caminho);
+
+/**
+ * @brief Igual a caminho_mais_curto, mas com o estado da procura num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto da procura
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas do caminho (0 para não limitar)
+ * @param[out] caminho Vetor alocado com os vértices do caminho (pode ser NULL)
+ * @return Número de vértices do caminho, 0 se destino não é alcançável,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ */
+int caminho_mais_curto_ctx(const Grafo* grafo, ContextoProcura* ctx, Vertice* origem, Vertice* destino,
+                           int max_saltos, Vertice*** caminho);
+
+/**
+ * @brief Encontra um caminho mais curto com uma procura em largura a partir das duas pontas
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas do caminho (0 para não limitar)
+ * @param[out] caminho Vetor alocado com os vértices do caminho (pode ser NULL)
+ * @return Número de vértices do caminho, 0 se destino não é alcançável,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ */
+int caminho_mais_curto_bidirecional(Grafo* grafo, Vertice* origem, Vertice* destino, int max_saltos,
+                                    Vertice*** caminho);
+
+/**
+ * @brief Igual a caminho_mais_curto_bidirecional, mas com o estado da procura num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto da procura
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas do caminho (0 para não limitar)
+ * @param[out] caminho Vetor alocado com os vértices do caminho (pode ser NULL)
+ * @return Número de vértices do caminho, 0 se destino não é alcançável,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ */
+int caminho_mais_curto_bidirecional_ctx(const Grafo* grafo, ContextoProcura* ctx, Vertice* origem,
+                                        Vertice* destino, int max_saltos, Vertice*** caminho);
+
+/**
+ * @brief Indica se uma antena é alcançável a partir de outra em até max_saltos saltos
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas (0 para não limitar)
+ * @return 1 se é alcançável, 0 se não é, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int alcancavel(Grafo* grafo, Vertice* origem, Vertice* destino, int max_saltos);
+
+/**
+ * @brief Igual a alcancavel, mas com o estado da procura num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto da procura
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas (0 para não limitar)
+ * @return 1 se é alcançável, 0 se não é, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int alcancavel_ctx(const Grafo* grafo, ContextoProcura* ctx, Vertice* origem, Vertice* destino, int max_saltos);
+
 /**
  * @brief Calcula o ponto de intersecção entre duas linhas definidas por pares de pontos
  * @param p1 Primeiro ponto da primeira linha (frequência A)
@@ -203,6 +712,71 @@ bool calcular_intersecao(Vertice* p1, Vertice* p2, Vertice* p3, Vertice* p4, int
  */
 int intersecoes_frequencias(Grafo* grafo, char freqA, char freqB);
 
+/**
+ * @brief Encontra e imprime as intersecções entre duas frequências, repartindo a deteção por vários fios
+ * @param grafo Apontador para o grafo
+ * @param freqA Primeira frequência a considerar
+ * @param freqB Segunda frequência a considerar
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @return Número de intersecções encontradas, ou -1 em caso de erro
+ */
+int intersecoes_frequencias_paralelo(Grafo* grafo, char freqA, char freqB, int num_fios);
+
+/**
+ * @brief Igual a intersecoes_frequencias_paralelo, mas com os contadores num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto que recebe os contadores e os tempos
+ * @param freqA Primeira frequência a considerar
+ * @param freqB Segunda frequência a considerar
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @return Número de intersecções encontradas, ou -1 em caso de erro
+ */
+int intersecoes_frequencias_ctx(const Grafo* grafo, ContextoProcura* ctx, char freqA, char freqB, int num_fios);
+
+/**
+ * @brief Encontra as intersecções entre duas frequências, chamando uma função para cada uma
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto que recebe os contadores e os tempos
+ * @param freqA Primeira frequência a considerar
+ * @param freqB Segunda frequência a considerar
+ * @param num_fios Número de fios de execução da deteção (0 para usar um por processador)
+ * @param visita Função chamada para cada intersecção (NULL para só contar)
+ * @param dados Apontador passado a cada chamada de visita
+ * @return Número de intersecções encontradas, ou -1 em caso de erro
+ */
+int intersecoes_frequencias_visitar_ctx(const Grafo* grafo, ContextoProcura* ctx, char freqA, char freqB,
+                                        int num_fios, FuncaoIntersecao visita, void* dados);
+
+/**
+ * @brief Conta as intersecções entre duas frequências, sem as imprimir
+ * @param grafo Apontador para o grafo
+ * @param freqA Primeira frequência a considerar
+ * @param freqB Segunda frequência a considerar
+ * @return Número de intersecções, ou -1 em caso de erro
+ */
+int contar_intersecoes(Grafo* grafo, char freqA, char freqB);
+
+/**
+ * @brief Igual a contar_intersecoes, mas com os contadores num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto que recebe os contadores e os tempos
+ * @param freqA Primeira frequência a considerar
+ * @param freqB Segunda frequência a considerar
+ * @return Número de intersecções, ou -1 em caso de erro
+ */
+int contar_intersecoes_ctx(const Grafo* grafo, ContextoProcura* ctx, char freqA, char freqB);
+
+/**
+ * @brief Conta, num só passo, as intersecções entre todos os pares de frequências
+ * @param grafo Apontador para o grafo
+ * @param[out] matriz Matriz de NUM_FREQUENCIAS x NUM_FREQUENCIAS; matriz[a * NUM_FREQUENCIAS + b]
+ * fica com o número de intersecções entre as frequências a e b
+ * @param visita Função chamada para cada intersecção (pode ser NULL)
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 em caso de sucesso, 1 se visita terminou a enumeração, -1 em caso de erro
+ */
+int matriz_interferencia(Grafo* grafo, unsigned int* matriz, FuncaoIntersecao visita, void* dados);
+
 /**
  * @brief Encontra um vértice no grafo pelas suas coordenadas
  * @param grafo Apontador para o grafo
@@ -212,15 +786,101 @@ int intersecoes_frequencias(Grafo* grafo, char freqA, char freqB);
 Vertice* encontrar_vertice(Grafo* grafo, int x, int y);
 
 /**
- * @brief Reinicia o estado 'visitado' de todos os vértices do grafo
+ * @brief Constrói o índice espacial das frequências alteradas desde a última indexação
+ * @param grafo Apontador para o grafo
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int indexar_grafo(Grafo* grafo);
+
+/**
+ * @brief Constrói o índice espacial das frequências alteradas, repartindo-as por vários fios
+ * @param grafo Apontador para o grafo
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int indexar_grafo_paralelo(Grafo* grafo, int num_fios);
+
+/**
+ * @brief Enumera as antenas dentro de um retângulo
+ * @param grafo Apontador para o grafo (só lido)
+ * @param freq Frequência das antenas, ou TODAS_FREQUENCIAS
+ * @param x0 Coordenada x de um canto
+ * @param y0 Coordenada y de um canto
+ * @param x1 Coordenada x do canto oposto (inclusive)
+ * @param y1 Coordenada y do canto oposto (inclusive)
+ * @param visita Função chamada para cada antena
+ * @param dados Apontador passado a cada chamada de visita
+ * @return Número de antenas passadas a visita, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int antenas_no_retangulo(const Grafo* grafo, int freq, int x0, int y0, int x1, int y1,
+                         FuncaoVisita visita, void* dados);
+
+/**
+ * @brief Enumera as antenas a uma distância não superior a raio de uma posição
+ * @param grafo Apontador para o grafo (só lido)
+ * @param freq Frequência das antenas, ou TODAS_FREQUENCIAS
+ * @param x Coordenada x do centro
+ * @param y Coordenada y do centro
+ * @param raio Raio (distância euclidiana, inclusive)
+ * @param visita Função chamada para cada antena
+ * @param dados Apontador passado a cada chamada de visita
+ * @return Número de antenas passadas a visita, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int antenas_no_raio(const Grafo* grafo, int freq, int x, int y, int raio, FuncaoVisita visita, void* dados);
+
+/**
+ * @brief Encontra as k antenas mais próximas de uma posição
+ * @param grafo Apontador para o grafo (só lido)
+ * @param freq Frequência das antenas, ou TODAS_FREQUENCIAS
+ * @param x Coordenada x da posição
+ * @param y Coordenada y da posição
+ * @param k Número de antenas pretendido
+ * @param[out] resultado Antenas encontradas (k entradas), da mais próxima para a mais afastada
+ * @return Número de antenas encontradas, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int antenas_mais_proximas(const Grafo* grafo, int freq, int x, int y, int k, Vertice** resultado);
+
+/**
+ * @brief Reinicia o estado de visita de todos os vértices do grafo (em O(1))
  * @param grafo Apontador para o grafo
  */
 int reiniciar_visitados(Grafo* grafo);
 
+/**
+ * @brief Escreve a representação do grafo numa saída com buffer
+ * @param grafo Apontador para o grafo a escrever
+ * @param saida Saída de destino (não é fechada)
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int escrever_grafo(const Grafo* grafo, Saida* saida);
+
 /**
  * @brief Imprime a representação do grafo na consola
  * @param grafo Apontador para o grafo a imprimir
  */
 void imprimir_grafo(Grafo* grafo);
 
+/**
+ * @brief Copia as estatísticas acumuladas do grafo
+ * @param grafo Apontador para o grafo
+ * @param[out] estatisticas Cópia dos contadores e tempos
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int obter_estatisticas(const Grafo* grafo, EstatisticasGrafo* estatisticas);
+
+/**
+ * @brief Põe a 0 as estatísticas acumuladas do grafo
+ * @param grafo Apontador para o grafo
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int reiniciar_estatisticas(Grafo* grafo);
+
+/**
+ * @brief Copia as estatísticas acumuladas das procuras feitas com um contexto
+ * @param ctx Contexto da procura
+ * @param[out] estatisticas Cópia dos contadores e tempos
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int obter_estatisticas_contexto(const ContextoProcura* ctx, EstatisticasGrafo* estatisticas);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,227 @@
+/**
+ * @file intersecao.h
+ * @brief Núcleo geométrico exato para intersecção de segmentos de reta
+ *
+ * @details Implementa as operações de:
+ * - Teste exato de intersecção entre dois segmentos com coordenadas inteiras
+ * - Cálculo das coordenadas inteiras do ponto de intersecção
+ * - Teste em lote de um segmento contra um vetor de segmentos (vetorizável)
+ * - Índice em grelha uniforme para encontrar todos os cruzamentos entre dois
+ *   conjuntos de segmentos sem testar todos os pares
+ * - Contagem num só passo dos cruzamentos entre todos os pares de grupos
+ * - Deteção de cruzamentos em paralelo, com resultados por bloco juntos no fim
+ *
+ * Todo o teste usa aritmética inteira de 64 bits, sem vírgula flutuante.
+ * As coordenadas devem estar no intervalo [-2^30, 2^30).
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#ifndef INTERSECAO_H
+#define INTERSECAO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "estatisticas.h"
+
+/**
+ * @brief Número de grupos distintos em cruzamentos_agrupados (um por valor de unsigned char)
+ */
+#define NUM_GRUPOS 256
+
+/**
+ * @brief Segmento de reta entre dois pontos de coordenadas inteiras
+ */
+typedef struct Segmento Segmento;
+
+/**
+ * @brief Vetor de segmentos guardado por coordenada (estrutura de vetores)
+ */
+typedef struct LoteSegmentos LoteSegmentos;
+
+/**
+ * @brief Ponto de intersecção entre um segmento de cada conjunto
+ */
+typedef struct Cruzamento Cruzamento;
+
+/**
+ * @brief Grelha uniforme com os segmentos que atravessam cada célula
+ */
+typedef struct IndiceSegmentos IndiceSegmentos;
+
+/**
+ * @struct Segmento
+ * @brief Segmento de reta de (x1,y1) a (x2,y2)
+ */
+struct Segmento {
+    int x1, y1;             ///< Primeiro extremo
+    int x2, y2;             ///< Segundo extremo
+};
+
+/**
+ * @struct LoteSegmentos
+ * @brief Segmentos com cada coordenada num vetor contíguo próprio
+ *
+ * @details Esta disposição permite ao compilador vetorizar o ciclo de
+ * intersetar_lote, que lê as quatro coordenadas de segmentos consecutivos.
+ */
+struct LoteSegmentos {
+    int* x1;                ///< Coordenada x do primeiro extremo de cada segmento
+    int* y1;                ///< Coordenada y do primeiro extremo de cada segmento
+    int* x2;                ///< Coordenada x do segundo extremo de cada segmento
+    int* y2;                ///< Coordenada y do segundo extremo de cada segmento
+    int num;                ///< Número de segmentos no lote
+    int cap;                ///< Capacidade alocada
+};
+
+/**
+ * @struct Cruzamento
+ * @brief Intersecção entre o segmento a do primeiro conjunto e o segmento b do segundo
+ */
+struct Cruzamento {
+    int a;                  ///< Índice do segmento no primeiro conjunto
+    int b;                  ///< Índice do segmento no segundo conjunto
+    int x, y;               ///< Coordenadas (truncadas) do ponto de intersecção
+};
+
+/**
+ * @struct IndiceSegmentos
+ * @brief Grelha de células quadradas de lado 'lado' sobre a caixa envolvente dos segmentos
+ *
+ * @details As listas das células estão guardadas de forma contígua: os segmentos
+ * da célula c são segmentos[inicio[c]] .. segmentos[inicio[c+1]-1]. Um segmento
+ * aparece em todas as células que atravessa.
+ */
+struct IndiceSegmentos {
+    int min_x, min_y;       ///< Canto da grelha (mínimos da caixa envolvente)
+    int lado;               ///< Lado de cada célula
+    int colunas, linhas;    ///< Dimensões da grelha em células
+    size_t* inicio;         ///< Início da lista de cada célula (colunas * linhas + 1 entradas)
+    int* segmentos;         ///< Índices dos segmentos, célula a célula
+};
+
+/**
+ * @brief Verifica se dois segmentos se intersectam e calcula o ponto
+ * @param a Primeiro segmento
+ * @param b Segundo segmento
+ * @param[out] x Coordenada x da intersecção (truncada para inteiro), se existir
+ * @param[out] y Coordenada y da intersecção (truncada para inteiro), se existir
+ * @return true se os segmentos se intersectam num único ponto
+ */
+bool intersetar_segmentos(const Segmento* a, const Segmento* b, int* x, int* y);
+
+/**
+ * @brief Calcula o ponto de intersecção de dois segmentos que já se sabe intersectarem
+ * @param a Primeiro segmento
+ * @param b Segundo segmento
+ * @param[out] x Coordenada x da intersecção (truncada para inteiro)
+ * @param[out] y Coordenada y da intersecção (truncada para inteiro)
+ */
+void ponto_intersecao(const Segmento* a, const Segmento* b, int* x, int* y);
+
+/**
+ * @brief Testa um segmento contra todos os segmentos de um lote
+ * @param a Segmento a testar
+ * @param lote Segmentos contra os quais testar
+ * @param[out] acerto Vetor com lote->num posições; fica a 1 onde há intersecção, 0 caso contrário
+ * @return Número de segmentos do lote intersectados por a
+ */
+int intersetar_lote(const Segmento* a, const LoteSegmentos* lote, unsigned char* acerto);
+
+/**
+ * @brief Constrói o índice em grelha de um lote de segmentos
+ * @param indice Índice a construir
+ * @param lote Segmentos a indexar
+ */
+int indice_construir(IndiceSegmentos* indice, const LoteSegmentos* lote);
+
+/**
+ * @brief Liberta a memória de um índice em grelha
+ * @param indice Índice a libertar
+ */
+void indice_libertar(IndiceSegmentos* indice);
+
+/**
+ * @brief Encontra os pontos de intersecção distintos entre dois conjuntos de segmentos
+ * @param a Primeiro conjunto de segmentos
+ * @param b Segundo conjunto de segmentos
+ * @param[out] resultado Vetor alocado com os cruzamentos (libertar com free), ou NULL se vazio
+ * @return Número de pontos distintos, ou -1 em caso de erro de memória
+ */
+int detetar_intersecoes(const LoteSegmentos* a, const LoteSegmentos* b, Cruzamento** resultado);
+
+/**
+ * @brief Encontra os pontos de intersecção distintos entre dois conjuntos, repartindo o trabalho por vários fios
+ * @param a Primeiro conjunto de segmentos
+ * @param b Segundo conjunto de segmentos
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @param[out] resultado Vetor alocado com os cruzamentos (libertar com free), ou NULL se vazio
+ * @return Número de pontos distintos, ou -1 em caso de erro
+ */
+int detetar_intersecoes_paralelo(const LoteSegmentos* a, const LoteSegmentos* b, int num_fios,
+                                 Cruzamento** resultado);
+
+/**
+ * @brief Igual a detetar_intersecoes_paralelo, acumulando também o trabalho feito
+ * @param a Primeiro conjunto de segmentos
+ * @param b Segundo conjunto de segmentos
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @param[out] resultado Vetor alocado com os cruzamentos (libertar com free), ou NULL se vazio
+ * @param[in,out] contadores Contadores a que é somado o trabalho feito (pode ser NULL)
+ * @return Número de pontos distintos, ou -1 em caso de erro
+ */
+int detetar_intersecoes_estatisticas(const LoteSegmentos* a, const LoteSegmentos* b, int num_fios,
+                                     Cruzamento** resultado, ContadoresIntersecao* contadores);
+
+/**
+ * @brief Obtém o número de processadores disponíveis
+ * @return Número de processadores (pelo menos 1)
+ */
+int numero_processadores(void);
+
+/**
+ * @brief Encontra os pontos de intersecção distintos entre todos os pares de grupos de um lote
+ * @param lote Segmentos de todos os grupos
+ * @param grupo Grupo de cada segmento (lote->num entradas)
+ * @param[out] contagem Matriz de NUM_GRUPOS x NUM_GRUPOS com o número de pontos por par de grupos (pode ser NULL)
+ * @param[out] resultado Vetor alocado com os cruzamentos (libertar com free), ou NULL para não os guardar
+ * @return Número total de cruzamentos distintos, ou -1 em caso de erro de memória
+ */
+int cruzamentos_agrupados(const LoteSegmentos* lote, const unsigned char* grupo, unsigned int* contagem,
+                          Cruzamento** resultado);
+
+/**
+ * @brief Prepara um lote vazio
+ * @param lote Lote a inicializar
+ */
+int lote_iniciar(LoteSegmentos* lote);
+
+/**
+ * @brief Acrescenta um segmento ao fim de um lote
+ * @param lote Lote a alterar
+ * @param s Segmento a acrescentar
+ */
+int lote_acrescentar(LoteSegmentos* lote, const Segmento* s);
+
+/**
+ * @brief Obtém o segmento numa posição de um lote
+ * @param lote Lote a consultar
+ * @param i Posição do segmento
+ * @param[out] s Segmento lido
+ */
+void lote_obter(const LoteSegmentos* lote, int i, Segmento* s);
+
+/**
+ * @brief Liberta a memória de um lote
+ * @param lote Lote a libertar
+ */
+void lote_libertar(LoteSegmentos* lote);
+
+#endif // INTERSECAO_H
@@ -4,9 +4,15 @@
  * 
  * @details Implementa as operações de:
  * - Carregamento de mapas a partir de ficheiros de texto
+ * - Mapeamento de ficheiros em memória para leitura sem cópias
  * - Representação de mapas na memória
  * - Conversão entre mapas e grafos de antenas
  * - Visualização de mapas com antenas e efeitos nefastos
+ * - Cálculo dos efeitos nefastos numa grelha contígua, sem imprimir
+ * - Cabeçalho da versão 2 (dimensões de 64 bits) e processamento em faixas
+ * - Grelha de efeitos atualizada incrementalmente ao alterar antenas
+ * - Carregamento paralelo em faixas de linhas
+ * - Efeitos nefastos servidos por uma cache de resultados, frequência a frequência
  * 
  * @author Diogo Pereira
  * @date 18 Maio 2025
@@ -21,7 +27,35 @@
 #ifndef MAPA_H
 #define MAPA_H
   
+#include <stdio.h>
+#include <stddef.h>
 #include "grafo.h"
+#include "cache.h"
+
+/**
+ * @brief Identificação dos ficheiros de mapa da versão 2 (dimensões de 64 bits)
+ */
+#define MAGIA_MAPA_V2 "EDAMAPA2"
+
+/**
+ * @brief Tamanho em bytes do cabeçalho da versão 2 (identificação, linhas e colunas)
+ */
+#define TAMANHO_CABECALHO_V2 24
+
+/**
+ * @brief Trabalho mínimo de cada fio no carregamento paralelo (células do mapa ou pares de antenas)
+ */
+#define TRABALHO_POR_FIO_CARREGAMENTO (1u << 20)
+
+/**
+ * @brief Faixas de linhas por fio no carregamento paralelo, para equilibrar zonas com densidades diferentes
+ */
+#define FAIXAS_POR_FIO 4
+
+/**
+ * @brief Máximo de segmentos de cada frequência em memória de uma vez em intersecoes_faixa
+ */
+#define SEGMENTOS_POR_BLOCO (1 << 20)
 
 /**
  * @struct Mapa
@@ -37,6 +71,122 @@ struct Mapa {
     char* dados;    ///< Array de caracteres representando uma linha do mapa
     Mapa* prox;     ///< Apontador para a próxima linha do mapa
 };
+
+/**
+ * @brief Conteúdo de um ficheiro mapeado em memória
+ */
+typedef struct FicheiroMapeado FicheiroMapeado;
+
+/**
+ * @struct FicheiroMapeado
+ * @brief Vista só de leitura de um ficheiro inteiro
+ */
+struct FicheiroMapeado {
+    const char* dados;  ///< Primeiro byte do ficheiro (NULL se o ficheiro estiver vazio)
+    size_t tamanho;     ///< Tamanho do ficheiro em bytes
+};
+
+/**
+ * @brief Dimensões lidas do cabeçalho de um ficheiro de mapa
+ */
+typedef struct CabecalhoMapa CabecalhoMapa;
+
+/**
+ * @struct CabecalhoMapa
+ * @brief Versão e dimensões de um ficheiro de mapa
+ */
+struct CabecalhoMapa {
+    int versao;             ///< 1 (dois int) ou 2 (MAGIA_MAPA_V2 e dois inteiros de 64 bits)
+    long long linhas;       ///< Número de linhas
+    long long colunas;      ///< Número de colunas
+    size_t tamanho;         ///< Bytes ocupados pelo cabeçalho; os carateres começam aqui
+};
+
+/**
+ * @brief Posições das antenas de uma frequência, guardadas sem o grafo
+ */
+typedef struct AntenasFrequencia AntenasFrequencia;
+
+/**
+ * @struct AntenasFrequencia
+ * @brief Vetores de coordenadas de 64 bits, ordenados por linha e depois por coluna
+ */
+struct AntenasFrequencia {
+    long long* x;           ///< Coluna de cada antena
+    long long* y;           ///< Linha de cada antena
+    size_t num;             ///< Número de antenas
+    size_t cap;             ///< Capacidade alocada
+};
+
+/**
+ * @brief Mapa aberto para processamento em faixas horizontais
+ */
+typedef struct MapaFaixas MapaFaixas;
+
+/**
+ * @struct MapaFaixas
+ * @brief Ficheiro de mapa lido faixa a faixa, com as antenas já recolhidas
+ */
+struct MapaFaixas {
+    FILE* ficheiro;                                 ///< Ficheiro do mapa
+    CabecalhoMapa cabecalho;                        ///< Dimensões do mapa
+    int linhas_por_faixa;                           ///< Número máximo de linhas por faixa
+    long long proxima_linha;                        ///< Primeira linha da próxima faixa
+    char* celulas;                                  ///< Carateres da faixa atual
+    AntenasFrequencia antenas[NUM_FREQUENCIAS];     ///< Antenas de cada frequência
+    long long num_antenas;                          ///< Número total de antenas
+};
+
+/**
+ * @brief Uma faixa horizontal de um mapa, já com os efeitos nefastos marcados
+ */
+typedef struct FaixaMapa FaixaMapa;
+
+/**
+ * @struct FaixaMapa
+ * @brief Linhas [y0, y0 + num_linhas) do mapa
+ */
+struct FaixaMapa {
+    long long y0;           ///< Primeira linha da faixa
+    int num_linhas;         ///< Número de linhas da faixa
+    long long colunas;      ///< Número de colunas do mapa
+    const char* celulas;    ///< num_linhas * colunas carateres: antenas, '#' e '.'
+    long long num_antenas;  ///< Antenas na faixa
+    long long num_efeitos;  ///< Posições com efeito nefasto na faixa
+};
+
+/**
+ * @brief Posição (coluna, linha) de uma célula do mapa
+ */
+typedef struct Posicao Posicao;
+
+/**
+ * @struct Posicao
+ * @brief Coordenadas de uma célula do mapa
+ */
+struct Posicao {
+    int x;          ///< Coluna
+    int y;          ///< Linha
+};
+
+/**
+ * @brief Contagem, por célula, dos pares de antenas que lhe dão efeito nefasto
+ */
+typedef struct GrelhaEfeitos GrelhaEfeitos;
+
+/**
+ * @struct GrelhaEfeitos
+ * @brief Número de pares alinhados que marcam cada posição do mapa
+ *
+ * @details Uma posição tem efeito nefasto se a contagem for positiva e não
+ * houver lá uma antena. Guardar contagens em vez de marcas permite retirar
+ * a contribuição de uma antena sem voltar a percorrer os outros pares.
+ */
+struct GrelhaEfeitos {
+    int linhas;                 ///< Número de linhas do mapa
+    int colunas;                ///< Número de colunas do mapa
+    unsigned int* contagem;     ///< linhas * colunas contagens; a posição (x,y) é contagem[y * colunas + x]
+};
   
 
 /**
@@ -46,6 +196,38 @@ struct Mapa {
  */
 int criar_mapa_padrao();
 
+/**
+ * @brief Mapeia um ficheiro inteiro em memória, só para leitura
+ * @param nome Caminho do ficheiro
+ * @param[out] mapeamento Endereço e tamanho do conteúdo mapeado
+ * @return 0 em caso de sucesso, -1 se o ficheiro não puder ser aberto, -2 se não puder ser mapeado
+ */
+int mapear_ficheiro(const char* nome, FicheiroMapeado* mapeamento);
+
+/**
+ * @brief Liberta um ficheiro mapeado com mapear_ficheiro
+ * @param mapeamento Mapeamento a libertar
+ */
+void libertar_mapeamento(FicheiroMapeado* mapeamento);
+
+/**
+ * @brief Interpreta o cabeçalho de um ficheiro de mapa (versão 1 ou 2)
+ * @param bytes Primeiros bytes do ficheiro
+ * @param disponiveis Número de bytes disponíveis em bytes
+ * @param[out] cabecalho Versão, dimensões e tamanho do cabeçalho
+ * @return 0 em caso de sucesso, -1 se o cabeçalho for inválido ou estiver incompleto
+ */
+int ler_cabecalho_mapa(const char* bytes, size_t disponiveis, CabecalhoMapa* cabecalho);
+
+/**
+ * @brief Escreve um cabeçalho da versão 2 (dimensões de 64 bits)
+ * @param f Ficheiro aberto para escrita, posicionado no início
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int escrever_cabecalho_mapa(FILE* f, long long linhas, long long colunas);
+
 /**
  * @brief Carrega um mapa a partir de um ficheiro binário e converte para grafo
  * @param ficheiro Nome do ficheiro binário contendo o mapa
@@ -55,9 +237,36 @@ int criar_mapa_padrao();
  * - 4 bytes: número de linhas (int)
  * - 4 bytes: número de colunas (int)
  * - Seguido pelos caracteres do mapa (sem quebras de linha)
+ * 
+ * Também aceita o cabeçalho da versão 2 (MAGIA_MAPA_V2 e dimensões de 64 bits),
+ * desde que as dimensões caibam num int.
  */
 Grafo* carregar_mapa(const char* ficheiro);
 
+/**
+ * @brief Carrega um mapa escolhendo a representação das arestas do grafo
+ * @param ficheiro Nome do ficheiro binário contendo o mapa
+ * @param modo ARESTAS_EXPLICITAS (listas de arestas) ou ARESTAS_IMPLICITAS
+ * @return Apontador para o grafo criado ou NULL em caso de erro
+ * 
+ * @details No modo implícito não é criada nenhuma aresta: os vizinhos de cada
+ * antena são obtidos a partir do vetor de antenas da mesma frequência.
+ */
+Grafo* carregar_mapa_modo(const char* ficheiro, ModoArestas modo);
+
+/**
+ * @brief Carrega um mapa repartindo a leitura e a construção do grafo por vários fios
+ * @param ficheiro Nome do ficheiro binário contendo o mapa
+ * @param modo ARESTAS_EXPLICITAS (listas de arestas) ou ARESTAS_IMPLICITAS
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @return Apontador para o grafo criado ou NULL em caso de erro
+ * 
+ * @details O mapa é lido em faixas de linhas e as antenas de cada faixa são
+ * juntadas ao grafo pela ordem das faixas; o grafo é igual ao da leitura por um
+ * só fio. carregar_mapa e carregar_mapa_modo usam um fio por processador.
+ */
+Grafo* carregar_mapa_paralelo(const char* ficheiro, ModoArestas modo, int num_fios);
+
 /**
  * @brief Imprime um mapa na consola com as antenas e efeitos nefastos
  * @param grafo Apontador para o grafo contendo as antenas
@@ -70,5 +279,183 @@ Grafo* carregar_mapa(const char* ficheiro);
  * - '.' para posições vazias
  */
 void imprimir_mapa(Grafo* grafo, int linhas, int colunas);
+
+/**
+ * @brief Imprime um mapa na consola com as antenas e efeitos nefastos, usando uma cache de resultados
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param cache Cache de resultados (NULL para calcular sempre)
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ */
+void imprimir_mapa_cache(Grafo* grafo, CacheResultados* cache, int linhas, int colunas);
+
+/**
+ * @brief Escreve o mapa com as antenas e efeitos nefastos numa saída com buffer
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @param saida Saída de destino (não é fechada)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int escrever_mapa(Grafo* grafo, int linhas, int colunas, Saida* saida);
+
+/**
+ * @brief Escreve o mapa com as antenas e efeitos nefastos numa saída com buffer, usando uma cache de resultados
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param cache Cache de resultados (NULL para calcular sempre)
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @param saida Saída de destino (não é fechada)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int escrever_mapa_cache(Grafo* grafo, CacheResultados* cache, int linhas, int colunas, Saida* saida);
+
+/**
+ * @brief Preenche uma grelha contígua com as antenas e os efeitos nefastos
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @param[out] celulas Grelha com linhas * colunas carateres; a posição (x,y) é celulas[y * colunas + x]
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int calcular_efeitos(Grafo* grafo, int linhas, int colunas, char* celulas);
+
+/**
+ * @brief Preenche uma grelha contígua com as antenas e os efeitos nefastos, usando uma cache de resultados
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param cache Cache de resultados (NULL para calcular sempre)
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @param[out] celulas Grelha com linhas * colunas carateres; a posição (x,y) é celulas[y * colunas + x]
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details As posições de efeito de cada frequência ficam na cache com a
+ * assinatura dessa frequência, pelo que uma alteração incremental só obriga a
+ * calcular outra vez a frequência alterada
+ */
+int calcular_efeitos_cache(Grafo* grafo, CacheResultados* cache, int linhas, int colunas, char* celulas);
+
+/**
+ * @brief Obtém as posições com efeito nefasto, sem imprimir o mapa
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @param[out] posicoes Vetor alocado com as posições (libertar com free), ou NULL se não houver
+ * @param[out] num Número de posições
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int posicoes_efeito(Grafo* grafo, int linhas, int colunas, Posicao** posicoes, int* num);
+
+/**
+ * @brief Obtém as posições com efeito nefasto, usando uma cache de resultados
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param cache Cache de resultados (NULL para calcular sempre)
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @param[out] posicoes Vetor alocado com as posições (libertar com free), ou NULL se não houver
+ * @param[out] num Número de posições
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int posicoes_efeito_cache(Grafo* grafo, CacheResultados* cache, int linhas, int colunas, Posicao** posicoes, int* num);
+
+/**
+ * @brief Calcula a grelha de contagens de efeitos de todas as antenas do grafo
+ * @param grelha Grelha a inicializar
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int grelha_efeitos_iniciar(GrelhaEfeitos* grelha, Grafo* grafo, int linhas, int colunas);
+
+/**
+ * @brief Liberta a memória de uma grelha de efeitos
+ * @param grelha Grelha a libertar
+ */
+void grelha_efeitos_libertar(GrelhaEfeitos* grelha);
+
+/**
+ * @brief Preenche uma grelha de carateres a partir das contagens, como calcular_efeitos
+ * @param grelha Grelha de contagens
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param[out] celulas Grelha com linhas * colunas carateres
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int grelha_efeitos_celulas(const GrelhaEfeitos* grelha, Grafo* grafo, char* celulas);
+
+/**
+ * @brief Adiciona uma antena ao grafo e os seus efeitos à grelha
+ * @param grafo Apontador para o grafo
+ * @param grelha Grelha de efeitos do grafo (pode ser NULL)
+ * @param cache Cache de resultados de onde descartar os da frequência (pode ser NULL)
+ * @param freq Frequência da antena
+ * @param x Coluna da antena
+ * @param y Linha da antena
+ * @return Apontador para o novo vértice, ou NULL se a posição estiver ocupada ou em caso de erro
+ */
+Vertice* adicionar_antena(Grafo* grafo, GrelhaEfeitos* grelha, CacheResultados* cache, char freq, int x, int y);
+
+/**
+ * @brief Retira os efeitos de uma antena da grelha e remove-a do grafo
+ * @param grafo Apontador para o grafo
+ * @param grelha Grelha de efeitos do grafo (pode ser NULL)
+ * @param cache Cache de resultados de onde descartar os da frequência (pode ser NULL)
+ * @param v Antena a remover
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int remover_antena(Grafo* grafo, GrelhaEfeitos* grelha, CacheResultados* cache, Vertice* v);
+
+/**
+ * @brief Muda uma antena de posição, atualizando os seus efeitos na grelha
+ * @param grafo Apontador para o grafo
+ * @param grelha Grelha de efeitos do grafo (pode ser NULL)
+ * @param cache Cache de resultados de onde descartar os da frequência (pode ser NULL)
+ * @param v Antena a mover
+ * @param x Nova coluna
+ * @param y Nova linha
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 se a nova posição estiver ocupada
+ */
+int mover_antena(Grafo* grafo, GrelhaEfeitos* grelha, CacheResultados* cache, Vertice* v, int x, int y);
   
+/**
+ * @brief Abre um mapa para processamento em faixas horizontais
+ * @param ficheiro Caminho do mapa (cabeçalho da versão 1 ou 2)
+ * @param linhas_por_faixa Número máximo de linhas em memória de cada vez
+ * @return Apontador para o mapa em faixas ou NULL em caso de erro
+ */
+MapaFaixas* abrir_mapa_faixas(const char* ficheiro, int linhas_por_faixa);
+
+/**
+ * @brief Lê a faixa seguinte e marca nela as antenas e os efeitos nefastos
+ * @param m Mapa em faixas
+ * @param[out] faixa Faixa lida (válida até à chamada seguinte)
+ * @return 1 se leu uma faixa, 0 se o mapa terminou, -1 em caso de erro
+ */
+int proxima_faixa(MapaFaixas* m, FaixaMapa* faixa);
+
+/**
+ * @brief Conta as intersecções entre duas frequências cujo ponto fica numa faixa
+ * @param m Mapa em faixas
+ * @param faixa Faixa devolvida por proxima_faixa
+ * @param freqA Primeira frequência
+ * @param freqB Segunda frequência
+ * @return Número de intersecções com ponto na faixa, ou -1 em caso de erro
+ */
+long long intersecoes_faixa(const MapaFaixas* m, const FaixaMapa* faixa, char freqA, char freqB);
+
+/**
+ * @brief Fecha um mapa em faixas, libertando toda a memória
+ * @param m Mapa em faixas
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int fechar_mapa_faixas(MapaFaixas* m);
+
+/**
+ * @brief Imprime um mapa com os efeitos nefastos, uma faixa de cada vez
+ * @param ficheiro Caminho do mapa
+ * @param linhas_por_faixa Número máximo de linhas em memória de cada vez
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int imprimir_mapa_faixas(const char* ficheiro, int linhas_por_faixa);
+
 #endif // MAPA_H
\ No newline at end of file
@@ -0,0 +1,142 @@
+/**
+ * @file saida.h
+ * @brief Escrita com buffer próprio para um FILE, um descritor ou um ficheiro comprimido
+ *
+ * @details Define um destino de escrita que acumula o texto num buffer dado
+ * por quem chama e só o entrega ao sistema quando o buffer enche:
+ * - Escrita de texto, carateres e inteiros sem printf nem alocações
+ * - Destinos FILE (mantém a ordem com o resto da escrita no mesmo FILE),
+ *   descritor de ficheiro (sem passar pela biblioteca de C) ou ficheiro gzip
+ *
+ * A escrita comprimida só está disponível se o código for compilado com
+ * EDA_ZLIB definido (por exemplo, make ZLIB=1, que também junta -lz).
+ * A estrutura tem sempre o mesmo formato, com ou sem a opção.
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#ifndef SAIDA_H
+#define SAIDA_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+#define TAMANHO_BUFFER_ESCRITA (1 << 16)   ///< Tamanho recomendado do buffer de uma Saida
+#define MIN_BUFFER_ESCRITA 32               ///< Tamanho mínimo do buffer (cabe qualquer inteiro)
+
+/**
+ * @brief Tipos de destino de uma Saida
+ */
+typedef enum TipoSaida {
+    SAIDA_FICHEIRO,     ///< FILE da biblioteca de C, escrito com fwrite
+    SAIDA_DESCRITOR,    ///< Descritor de ficheiro, escrito com write
+    SAIDA_COMPRIMIDA    ///< Ficheiro gzip (só com EDA_ZLIB)
+} TipoSaida;
+
+/**
+ * @brief Destino de escrita com buffer
+ */
+typedef struct Saida Saida;
+
+/**
+ * @struct Saida
+ * @brief Buffer de escrita e o destino para onde é despejado
+ */
+struct Saida {
+    char* buffer;           ///< Buffer dado por quem chama
+    size_t capacidade;      ///< Tamanho do buffer
+    size_t usados;          ///< Bytes por despejar
+    TipoSaida tipo;         ///< Tipo do destino
+    FILE* ficheiro;         ///< Destino SAIDA_FICHEIRO
+    int descritor;          ///< Destino SAIDA_DESCRITOR
+    void* comprimido;       ///< Destino SAIDA_COMPRIMIDA (gzFile)
+    int erro;               ///< Diferente de 0 depois de uma escrita falhar
+};
+
+/**
+ * @brief Prepara uma saída para um FILE
+ * @param saida Saída a preparar
+ * @param ficheiro Ficheiro de destino
+ * @param buffer Buffer de escrita (pelo menos MIN_BUFFER_ESCRITA bytes)
+ * @param capacidade Tamanho do buffer
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int saida_ficheiro(Saida* saida, FILE* ficheiro, char* buffer, size_t capacidade);
+
+/**
+ * @brief Prepara uma saída para um descritor de ficheiro
+ * @param saida Saída a preparar
+ * @param descritor Descritor de destino (por exemplo 1 para a saída padrão)
+ * @param buffer Buffer de escrita (pelo menos MIN_BUFFER_ESCRITA bytes)
+ * @param capacidade Tamanho do buffer
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int saida_descritor(Saida* saida, int descritor, char* buffer, size_t capacidade);
+
+/**
+ * @brief Abre um ficheiro gzip para escrita
+ * @param saida Saída a preparar
+ * @param nome Caminho do ficheiro a criar
+ * @param buffer Buffer de escrita (pelo menos MIN_BUFFER_ESCRITA bytes)
+ * @param capacidade Tamanho do buffer
+ * @return 0 em caso de sucesso, -1 em caso de erro ou se EDA_ZLIB não estiver definido
+ */
+int saida_comprimida(Saida* saida, const char* nome, char* buffer, size_t capacidade);
+
+/**
+ * @brief Entrega ao destino tudo o que está no buffer
+ * @param saida Saída
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int saida_despejar(Saida* saida);
+
+/**
+ * @brief Despeja o buffer e termina a saída
+ * @param saida Saída
+ * @return 0 se todas as escritas correram bem, -1 caso contrário
+ *
+ * @details Fecha o ficheiro gzip; os FILE e os descritores não são fechados
+ */
+int saida_fechar(Saida* saida);
+
+/**
+ * @brief Escreve um bloco de bytes
+ * @param saida Saída
+ * @param dados Bytes a escrever
+ * @param tamanho Número de bytes
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int saida_escrever(Saida* saida, const char* dados, size_t tamanho);
+
+/**
+ * @brief Escreve um texto terminado em '\0'
+ * @param saida Saída
+ * @param texto Texto a escrever
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int saida_texto(Saida* saida, const char* texto);
+
+/**
+ * @brief Escreve um caráter
+ * @param saida Saída
+ * @param c Caráter a escrever
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int saida_caracter(Saida* saida, char c);
+
+/**
+ * @brief Escreve um inteiro em base 10, como "%lld"
+ * @param saida Saída
+ * @param valor Inteiro a escrever
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int saida_inteiro(Saida* saida, long long valor);
+
+#endif // SAIDA_H
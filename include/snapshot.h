@@ -0,0 +1,116 @@
+/**
+ * @file snapshot.h
+ * @brief Instantâneo binário de um grafo já construído, para arranque rápido
+ *
+ * @details Implementa as operações de:
+ * - Gravação de um GrafoCSR num ficheiro versionado, sem apontadores
+ * - Abertura do ficheiro por mapeamento em memória, sem reconstruir arestas
+ * - Validação do cabeçalho (soma de verificação, tamanhos e posições) e,
+ *   opcionalmente, dos dados
+ * - Carregamento de um mapa através do instantâneo guardado ao lado dele
+ *
+ * Formato (inteiros na ordem de bytes da máquina, secções alinhadas a 8 bytes):
+ * - Cabeçalho de tamanho fixo com a versão, as dimensões, a posição de cada
+ *   secção, o tamanho, a data (com nanossegundos), o inode e, se foi modificado
+ *   perto da gravação, a soma do conteúdo do mapa de origem, a data de gravação
+ *   e as somas de verificação
+ * - offsets: num_vertices + 1 inteiros de 64 bits
+ * - destinos: num_arestas inteiros de 32 bits
+ * - x, y: num_vertices inteiros de 32 bits cada
+ * - frequencia: num_vertices bytes
+ * - inicio_frequencia: NUM_FREQUENCIAS + 1 inteiros de 64 bits
+ * - por_frequencia: num_vertices inteiros de 32 bits (vértices de cada
+ *   frequência, por ordem de inserção)
+ * - por_posicao: num_vertices inteiros de 32 bits (índice de posições do CSR)
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stddef.h>
+#include "grafo.h"
+#include "csr.h"
+#include "mapa.h"
+
+/**
+ * @brief Versão atual do formato dos instantâneos
+ */
+#define VERSAO_SNAPSHOT 4
+
+/**
+ * @brief Instantâneo aberto, com os vetores a apontar para o ficheiro mapeado
+ */
+typedef struct GrafoSnapshot GrafoSnapshot;
+
+/**
+ * @struct GrafoSnapshot
+ * @brief Grafo CSR e índice de frequências lidos diretamente do ficheiro
+ *
+ * @details Os vetores de csr apontam para a memória mapeada, que é só de
+ * leitura: csr pode ser passado às funções csr_*, mas não deve ser alterado nem
+ * destruído com destruir_grafo_csr (usar fechar_snapshot).
+ */
+struct GrafoSnapshot {
+    GrafoCSR csr;                       ///< Grafo CSR (vetores no ficheiro mapeado)
+    const size_t* inicio_frequencia;    ///< Início dos vértices de cada frequência em por_frequencia (NUM_FREQUENCIAS + 1 entradas)
+    const int* por_frequencia;          ///< Vértices agrupados por frequência, por ordem de inserção
+    FicheiroMapeado mapeamento;         ///< Ficheiro mapeado
+};
+
+/**
+ * @brief Grava um grafo CSR num ficheiro de instantâneo
+ * @param csr Grafo a gravar
+ * @param ficheiro Caminho do instantâneo
+ * @param origem Mapa de onde o grafo foi carregado (pode ser NULL)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de escrita
+ */
+int gravar_snapshot(const GrafoCSR* csr, const char* ficheiro, const char* origem);
+
+/**
+ * @brief Abre um instantâneo por mapeamento em memória
+ * @param ficheiro Caminho do instantâneo
+ * @param origem Mapa correspondente, para confirmar que o instantâneo está atualizado (pode ser NULL)
+ * @return Apontador para o instantâneo, ou NULL se não existir, for inválido ou estiver desatualizado
+ */
+GrafoSnapshot* abrir_snapshot(const char* ficheiro, const char* origem);
+
+/**
+ * @brief Confirma a soma de verificação dos dados de um instantâneo aberto
+ * @param snapshot Instantâneo a verificar
+ * @return 0 se os dados estiverem íntegros, -1 caso contrário
+ */
+int verificar_snapshot(const GrafoSnapshot* snapshot);
+
+/**
+ * @brief Fecha um instantâneo, libertando o mapeamento
+ * @param snapshot Instantâneo a fechar
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int fechar_snapshot(GrafoSnapshot* snapshot);
+
+/**
+ * @brief Obtém o caminho do instantâneo guardado ao lado de um mapa
+ * @param mapa Caminho do mapa (por exemplo, "data/mapa.bin")
+ * @param[out] destino Memória onde escrever o caminho (por exemplo, "data/mapa.snap")
+ * @param tamanho Tamanho de destino em bytes
+ * @return 0 em caso de sucesso, -1 se destino for pequeno demais
+ */
+int caminho_snapshot(const char* mapa, char* destino, size_t tamanho);
+
+/**
+ * @brief Carrega um mapa através do seu instantâneo, criando-o se necessário
+ * @param ficheiro Caminho do mapa
+ * @return Apontador para o instantâneo, ou NULL em caso de erro
+ */
+GrafoSnapshot* carregar_mapa_snapshot(const char* ficheiro);
+
+#endif // SNAPSHOT_H
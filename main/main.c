@@ -8,6 +8,10 @@
  * - Inclui exemplos de uso de todas as operações principais
  * - Liberta todos os recursos no final
  * 
+ * Com argumentos, corre em modo de consultas: carrega o mapa uma vez e
+ * responde às consultas lidas de um ficheiro ou da entrada padrão (ver consultas.h):
+ *   projeto_edafase2 [-m mapa.bin] [-i] [-j fios] [-b lote] [-c] [consultas.txt | -]
+ * 
  * @author Diogo Pereira
  * @date 18 Maio 2025
  * @version 1.0
@@ -20,14 +24,127 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "grafo.h"
 #include "mapa.h"
+#include "consultas.h"
+
+#define TAMANHO_BUFFER_SAIDA (1 << 16)  ///< Buffer da saída padrão no modo de consultas
 
 /**
- * @brief Função principal do programa
+ * @brief Mostra a utilização do modo de consultas
+ * @param programa Nome do programa
+ */
+static void mostrar_utilizacao(const char* programa) {
+    fprintf(stderr, "Utilizacao: %s [-m mapa.bin] [-i] [-j fios] [-b lote] [-c] [consultas.txt | -]\n", programa);
+}
+
+/**
+ * @brief Modo de consultas: carrega o mapa uma vez e responde a todas as consultas
+ * @param argc Número de argumentos
+ * @param argv Argumentos
+ * @return 0 se todas as consultas foram respondidas, 1 em caso de erro
+ * 
+ * @details Opções:
+ * - -m mapa.bin: mapa a carregar (por omissão data/mapa.bin)
+ * - -i: arestas implícitas, para mapas grandes
+ * - -j fios: fios de execução do carregamento e das consultas (por omissão um por processador)
+ * - -b lote: consultas executadas de cada vez (1 para responder linha a linha)
+ * - -c: lê e grava a cache de resultados ao lado do mapa (mapa.cache, ver nome_cache_mapa)
+ * 
+ * Sem ficheiro de consultas, ou com "-", lê da entrada padrão. As intersecções
+ * e os efeitos repetidos são sempre servidos por uma cache em memória; com -c,
+ * a cache continua de uma execução para a seguinte enquanto as frequências
+ * envolvidas não mudarem.
+ */
+static int modo_consultas(int argc, char** argv) {
+    const char* mapa = "data/mapa.bin";
+    ModoArestas modo = ARESTAS_EXPLICITAS;
+    int num_fios = 0;
+    int lote = LOTE_CONSULTAS_OMISSAO;
+    const char* ficheiro = NULL;
+    bool persistir = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-i") == 0) {
+            modo = ARESTAS_IMPLICITAS;
+        } else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc) {
+            mapa = argv[++i];
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            num_fios = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) {
+            lote = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-c") == 0) {
+            persistir = true;
+        } else if (!ficheiro && (argv[i][0] != '-' || strcmp(argv[i], "-") == 0)) {
+            ficheiro = argv[i];
+        } else {
+            mostrar_utilizacao(argv[0]);
+            return 1;
+        }
+    }
+    if (num_fios < 0 || lote < 1) {
+        mostrar_utilizacao(argv[0]);
+        return 1;
+    }
+
+    // Sem isto, carregar_mapa criaria o mapa padrão no lugar de um ficheiro em falta
+    FILE* f = fopen(mapa, "rb");
+    if (!f) {
+        fprintf(stderr, "Erro ao abrir %s\n", mapa);
+        return 1;
+    }
+    fclose(f);
+    Grafo* grafo = carregar_mapa_paralelo(mapa, modo, num_fios);
+    if (!grafo) {
+        fprintf(stderr, "Erro ao carregar mapa\n");
+        return 1;
+    }
+
+    FILE* entrada = stdin;
+    if (ficheiro && strcmp(ficheiro, "-") != 0) {
+        entrada = fopen(ficheiro, "r");
+        if (!entrada) {
+            fprintf(stderr, "Erro ao abrir %s\n", ficheiro);
+            destruir_grafo(grafo);
+            return 1;
+        }
+    }
+
+    CacheResultados cache;
+    char nome_cache[FILENAME_MAX];
+    if (cache_resultados_iniciar(&cache, 0) != 0) {
+        fprintf(stderr, "Erro de memoria\n");
+        if (entrada != stdin) fclose(entrada);
+        destruir_grafo(grafo);
+        return 1;
+    }
+    if (persistir && nome_cache_mapa(mapa, nome_cache, sizeof(nome_cache)) != 0) persistir = false;
+    // Uma cache em falta ou de outra versão é ignorada: começa vazia
+    if (persistir) cache_resultados_ler(&cache, nome_cache);
+
+    setvbuf(stdout, NULL, _IOFBF, TAMANHO_BUFFER_SAIDA);
+    long long total = executar_consultas_cache(grafo, &cache, entrada, stdout, num_fios, lote);
+    if (entrada != stdin) fclose(entrada);
+    destruir_grafo(grafo);
+
+    if (persistir && total >= 0 && cache_resultados_gravar(&cache, nome_cache) != 0) {
+        fprintf(stderr, "Erro ao gravar %s\n", nome_cache);
+    }
+    cache_resultados_libertar(&cache);
+
+    if (total < 0) {
+        fprintf(stderr, total == -2 ? "Erro de memoria\n" : "Erro ao escrever os resultados\n");
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Demonstração das operações sobre o mapa padrão
  * @return 0 se executado com sucesso, 1 em caso de erro
  * 
- * @details O fluxo do programa é:
+ * @details O fluxo da demonstração é:
  * 1. Carregar o mapa a partir de ficheiro
  * 2. Mostrar representação do grafo e do mapa
  * 3. Executar procura em profundidade (DFS)
@@ -39,7 +156,7 @@
  * @note O programa assume que o ficheiro do mapa está em "data/mapa.bin"
  * e contém antenas nas posições esperadas para as demonstrações.
  */
-int main() {
+static int demonstracao(void) {
     // 1. Carregar mapa
     Grafo* grafo = carregar_mapa("data/mapa.bin");
     if (!grafo) {
@@ -83,4 +200,17 @@ int main() {
     // 7. Liberar recursos
     destruir_grafo(grafo);
     return 0;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Função principal do programa
+ * @param argc Número de argumentos
+ * @param argv Argumentos
+ * @return 0 se executado com sucesso, 1 em caso de erro
+ * 
+ * @details Sem argumentos corre a demonstração; com argumentos, o modo de consultas
+ */
+int main(int argc, char** argv) {
+    if (argc > 1) return modo_consultas(argc, argv);
+    return demonstracao();
+}
@@ -0,0 +1,682 @@
+/**
+ * @file cache.c
+ * @brief Implementação da cache de resultados de relatórios
+ *
+ * @details Implementa as funções declaradas em cache.h. As entradas estão numa
+ * tabela de dispersão com listas, indexada pela consulta (sem as assinaturas),
+ * e numa lista duplamente ligada pela ordem de utilização: cada acerto passa a
+ * entrada para o fim mais recente e, quando a memória ultrapassa o limite, saem
+ * as entradas do fim mais antigo.
+ *
+ * O ficheiro de cache tem MAGIA_CACHE_RESULTADOS, a versão e o número de
+ * entradas, seguidos de cada entrada (campos da chave, número de registos,
+ * assinaturas e valores), da mais antiga para a mais recente, para que a
+ * leitura reponha a mesma ordem de utilização.
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include "grafo.h"
+#include "cache.h"
+
+#define CAPACIDADE_INICIAL_TABELA 64    ///< Posições da tabela de uma cache vazia
+
+/**
+ * @brief Número de inteiros de cada registo de um tipo de resultado
+ * @param tipo Tipo do resultado
+ * @return VALORES_INTERSECAO ou VALORES_EFEITO
+ */
+static int valores_por_registo(int tipo) {
+    return tipo == RESULTADO_INTERSECOES ? VALORES_INTERSECAO : VALORES_EFEITO;
+}
+
+/**
+ * @brief Verifica se os campos de uma chave estão dentro dos limites
+ * @param chave Chave a verificar
+ * @return true se a chave for válida
+ */
+static bool chave_valida(const ChaveResultado* chave) {
+    return chave->tipo >= 0 && chave->tipo < NUM_TIPOS_RESULTADO &&
+           chave->freq_a >= 0 && chave->freq_a < NUM_FREQUENCIAS &&
+           chave->freq_b >= 0 && chave->freq_b < NUM_FREQUENCIAS &&
+           chave->linhas >= 0 && chave->colunas >= 0;
+}
+
+/**
+ * @brief Verifica se duas chaves identificam a mesma consulta (ignorando as assinaturas)
+ * @param a Primeira chave
+ * @param b Segunda chave
+ * @return true se a consulta for a mesma
+ */
+static bool mesma_consulta(const ChaveResultado* a, const ChaveResultado* b) {
+    return a->tipo == b->tipo && a->modo == b->modo && a->freq_a == b->freq_a && a->freq_b == b->freq_b &&
+           a->linhas == b->linhas && a->colunas == b->colunas;
+}
+
+/**
+ * @brief Calcula a posição de uma consulta na tabela
+ * @param chave Chave da consulta
+ * @param mascara Capacidade da tabela menos 1
+ * @return Posição na tabela
+ */
+static int posicao_consulta(const ChaveResultado* chave, int mascara) {
+    unsigned long long h = (unsigned long long)chave->tipo;
+    h = h * 0x9E3779B97F4A7C15ull + (unsigned long long)chave->modo;
+    h = h * 0x9E3779B97F4A7C15ull + (unsigned long long)chave->freq_a;
+    h = h * 0x9E3779B97F4A7C15ull + (unsigned long long)chave->freq_b;
+    h = h * 0x9E3779B97F4A7C15ull + (unsigned long long)(unsigned int)chave->linhas;
+    h = h * 0x9E3779B97F4A7C15ull + (unsigned long long)(unsigned int)chave->colunas;
+    h ^= h >> 29;
+    return (int)(h & (unsigned long long)mascara);
+}
+
+/**
+ * @brief Prepara uma cache vazia
+ * @param cache Cache a inicializar
+ * @param limite Memória máxima dos resultados em bytes (0 para LIMITE_CACHE_RESULTADOS)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ *
+ * @details O limite conta os valores e a estrutura de cada entrada; a tabela
+ * de dispersão não conta
+ */
+int cache_resultados_iniciar(CacheResultados* cache, size_t limite) {
+    if (!cache) return -1;
+    memset(cache, 0, sizeof(CacheResultados));
+    cache->limite = limite ? limite : LIMITE_CACHE_RESULTADOS;
+    cache->tabela = (EntradaResultado**)calloc(CAPACIDADE_INICIAL_TABELA, sizeof(EntradaResultado*));
+    if (!cache->tabela) return -2;
+    cache->cap_tabela = CAPACIDADE_INICIAL_TABELA;
+    if (pthread_mutex_init(&cache->trinco, NULL) != 0) {
+        free(cache->tabela);
+        cache->tabela = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Liberta todas as entradas e os recursos da cache
+ * @param cache Cache a libertar
+ */
+void cache_resultados_libertar(CacheResultados* cache) {
+    if (!cache || !cache->tabela) return;
+    EntradaResultado* e = cache->recente;
+    while (e != NULL) {
+        EntradaResultado* temp = e;
+        e = e->mais_antiga;
+        free(temp->valores);
+        free(temp);
+    }
+    free(cache->tabela);
+    pthread_mutex_destroy(&cache->trinco);
+    memset(cache, 0, sizeof(CacheResultados));
+}
+
+/**
+ * @brief Preenche a chave de um resultado com as assinaturas atuais do grafo
+ * @param[out] chave Chave a preencher
+ * @param grafo Grafo de onde vêm as assinaturas e o modo
+ * @param tipo Tipo do resultado
+ * @param freq_a Primeira frequência
+ * @param freq_b Segunda frequência (ignorada nos efeitos)
+ * @param linhas Linhas do mapa (ignoradas nas intersecções)
+ * @param colunas Colunas do mapa (ignoradas nas intersecções)
+ */
+void chave_resultado(ChaveResultado* chave, const Grafo* grafo, TipoResultado tipo, char freq_a, char freq_b,
+                     int linhas, int colunas) {
+    if (!chave || !grafo) return;
+    memset(chave, 0, sizeof(ChaveResultado));
+    chave->tipo = tipo;
+    chave->modo = grafo->modo;
+    chave->freq_a = (unsigned char)freq_a;
+    chave->assinatura_a = grafo->assinatura[(unsigned char)freq_a];
+    if (tipo == RESULTADO_INTERSECOES) {
+        chave->freq_b = (unsigned char)freq_b;
+        chave->assinatura_b = grafo->assinatura[(unsigned char)freq_b];
+    } else {
+        chave->linhas = linhas;
+        chave->colunas = colunas;
+    }
+}
+
+/**
+ * @brief Procura a entrada de uma consulta, com qualquer assinatura
+ * @param cache Cache
+ * @param chave Chave da consulta
+ * @return Entrada ou NULL se a consulta não tiver entrada
+ */
+static EntradaResultado* procurar_consulta(const CacheResultados* cache, const ChaveResultado* chave) {
+    EntradaResultado* e = cache->tabela[posicao_consulta(chave, cache->cap_tabela - 1)];
+    while (e != NULL && !mesma_consulta(&e->chave, chave)) e = e->seguinte;
+    return e;
+}
+
+/**
+ * @brief Retira uma entrada da lista de utilização
+ * @param cache Cache
+ * @param e Entrada a retirar
+ */
+static void desligar_utilizacao(CacheResultados* cache, EntradaResultado* e) {
+    if (e->mais_recente) {
+        e->mais_recente->mais_antiga = e->mais_antiga;
+    } else {
+        cache->recente = e->mais_antiga;
+    }
+    if (e->mais_antiga) {
+        e->mais_antiga->mais_recente = e->mais_recente;
+    } else {
+        cache->antiga = e->mais_recente;
+    }
+    e->mais_recente = NULL;
+    e->mais_antiga = NULL;
+}
+
+/**
+ * @brief Coloca uma entrada no fim mais recente da lista de utilização
+ * @param cache Cache
+ * @param e Entrada (fora da lista)
+ */
+static void ligar_recente(CacheResultados* cache, EntradaResultado* e) {
+    e->mais_recente = NULL;
+    e->mais_antiga = cache->recente;
+    if (cache->recente) {
+        cache->recente->mais_recente = e;
+    } else {
+        cache->antiga = e;
+    }
+    cache->recente = e;
+}
+
+/**
+ * @brief Retira uma entrada da tabela e da lista e liberta-a
+ * @param cache Cache
+ * @param e Entrada a descartar
+ */
+static void descartar_entrada(CacheResultados* cache, EntradaResultado* e) {
+    EntradaResultado** p = &cache->tabela[posicao_consulta(&e->chave, cache->cap_tabela - 1)];
+    while (*p != e) p = &(*p)->seguinte;
+    *p = e->seguinte;
+    desligar_utilizacao(cache, e);
+    cache->bytes -= e->bytes;
+    cache->num_entradas--;
+    free(e->valores);
+    free(e);
+}
+
+/**
+ * @brief Duplica a tabela quando o número de entradas ultrapassa o número de posições
+ * @param cache Cache
+ *
+ * @details Sem memória para a tabela nova, a antiga continua a ser usada
+ * (as listas ficam só mais compridas)
+ */
+static void crescer_tabela(CacheResultados* cache) {
+    if (cache->num_entradas < cache->cap_tabela || cache->cap_tabela > INT_MAX / 2) return;
+    int nova_cap = 2 * cache->cap_tabela;
+    EntradaResultado** nova = (EntradaResultado**)calloc((size_t)nova_cap, sizeof(EntradaResultado*));
+    if (!nova) return;
+    for (int i = 0; i < cache->cap_tabela; i++) {
+        EntradaResultado* e = cache->tabela[i];
+        while (e != NULL) {
+            EntradaResultado* seguinte = e->seguinte;
+            int p = posicao_consulta(&e->chave, nova_cap - 1);
+            e->seguinte = nova[p];
+            nova[p] = e;
+            e = seguinte;
+        }
+    }
+    free(cache->tabela);
+    cache->tabela = nova;
+    cache->cap_tabela = nova_cap;
+}
+
+/**
+ * @brief Guarda um resultado, ficando a cache com o vetor de valores
+ * @param cache Cache (com o trinco fechado)
+ * @param chave Chave do resultado (válida)
+ * @param valores Vetor alocado com os valores; passa a ser da cache, ou é libertado
+ * @param num Número de registos
+ * @return 0 em caso de sucesso, -2 em caso de erro de memória
+ *
+ * @details A entrada anterior da mesma consulta é sempre descartada. Um resultado
+ * maior do que o limite não é guardado; os outros fazem sair as entradas usadas
+ * há mais tempo até caberem.
+ */
+static int inserir_entrada(CacheResultados* cache, const ChaveResultado* chave, int* valores, int num) {
+    EntradaResultado* anterior = procurar_consulta(cache, chave);
+    if (anterior) descartar_entrada(cache, anterior);
+
+    size_t bytes = sizeof(EntradaResultado) + (size_t)num * (size_t)valores_por_registo(chave->tipo) * sizeof(int);
+    if (bytes > cache->limite) {
+        free(valores);
+        return 0;
+    }
+    EntradaResultado* e = (EntradaResultado*)malloc(sizeof(EntradaResultado));
+    if (!e) {
+        free(valores);
+        return -2;
+    }
+    while (cache->antiga && cache->bytes + bytes > cache->limite) descartar_entrada(cache, cache->antiga);
+
+    e->chave = *chave;
+    e->valores = valores;
+    e->num = num;
+    e->bytes = bytes;
+    int p = posicao_consulta(chave, cache->cap_tabela - 1);
+    e->seguinte = cache->tabela[p];
+    cache->tabela[p] = e;
+    ligar_recente(cache, e);
+    cache->bytes += bytes;
+    cache->num_entradas++;
+    crescer_tabela(cache);
+    return 0;
+}
+
+/**
+ * @brief Procura um resultado e devolve uma cópia dos seus valores
+ * @param cache Cache
+ * @param chave Chave do resultado
+ * @param[out] valores Vetor alocado com os valores (libertar com free; NULL se não houver registos)
+ * @param[out] num Número de registos
+ * @return 1 se o resultado foi encontrado, 0 se não, -1 em caso de erro, -2 em caso de erro de memória
+ *
+ * @details Só é encontrado um resultado com as mesmas assinaturas da chave.
+ * Os valores são copiados antes de abrir o trinco, pelo que a entrada pode sair
+ * da cache logo a seguir sem afetar quem os recebeu.
+ */
+int cache_resultados_obter(CacheResultados* cache, const ChaveResultado* chave, int** valores, int* num) {
+    if (!cache || !chave || !valores || !num || !chave_valida(chave)) return -1;
+    *valores = NULL;
+    *num = 0;
+
+    pthread_mutex_lock(&cache->trinco);
+    EntradaResultado* e = procurar_consulta(cache, chave);
+    int resultado = 0;
+    if (e && e->chave.assinatura_a == chave->assinatura_a && e->chave.assinatura_b == chave->assinatura_b) {
+        size_t tamanho = (size_t)e->num * (size_t)valores_por_registo(e->chave.tipo) * sizeof(int);
+        int* copia = tamanho ? (int*)malloc(tamanho) : NULL;
+        if (tamanho && !copia) {
+            resultado = -2;
+        } else {
+            if (tamanho) memcpy(copia, e->valores, tamanho);
+            *valores = copia;
+            *num = e->num;
+            desligar_utilizacao(cache, e);
+            ligar_recente(cache, e);
+            cache->acertos++;
+            resultado = 1;
+        }
+    } else {
+        cache->falhas++;
+    }
+    pthread_mutex_unlock(&cache->trinco);
+    return resultado;
+}
+
+/**
+ * @brief Guarda uma cópia de um resultado
+ * @param cache Cache
+ * @param chave Chave do resultado
+ * @param valores Valores (num registos)
+ * @param num Número de registos
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ *
+ * @details Substitui o resultado anterior da mesma consulta, mesmo que tenha
+ * outras assinaturas
+ */
+int cache_resultados_guardar(CacheResultados* cache, const ChaveResultado* chave, const int* valores, int num) {
+    if (!cache || !chave || !chave_valida(chave) || num < 0 || (num > 0 && !valores)) return -1;
+    int por_registo = valores_por_registo(chave->tipo);
+    if ((size_t)num > SIZE_MAX / sizeof(int) / (size_t)por_registo) return -2;
+
+    size_t tamanho = (size_t)num * (size_t)por_registo * sizeof(int);
+    int* copia = tamanho ? (int*)malloc(tamanho) : NULL;
+    if (tamanho && !copia) return -2;
+    if (tamanho) memcpy(copia, valores, tamanho);
+
+    pthread_mutex_lock(&cache->trinco);
+    int resultado = inserir_entrada(cache, chave, copia, num);
+    pthread_mutex_unlock(&cache->trinco);
+    return resultado;
+}
+
+/**
+ * @brief Descarta os resultados em que entra uma frequência
+ * @param cache Cache
+ * @param freq Frequência alterada
+ * @return Número de resultados descartados, ou -1 em caso de erro
+ *
+ * @details Os resultados de uma frequência alterada já não são encontrados,
+ * porque a assinatura mudou; descartá-los liberta logo a memória e tira-os do
+ * ficheiro gravado, em vez de esperar que saiam pelo limite. Os das outras
+ * frequências ficam. É chamada por adicionar_antena, remover_antena e mover_antena.
+ */
+int cache_resultados_invalidar(CacheResultados* cache, char freq) {
+    if (!cache) return -1;
+    int f = (unsigned char)freq;
+    int descartados = 0;
+
+    pthread_mutex_lock(&cache->trinco);
+    EntradaResultado* e = cache->recente;
+    while (e != NULL) {
+        EntradaResultado* seguinte = e->mais_antiga;
+        if (e->chave.freq_a == f || (e->chave.tipo == RESULTADO_INTERSECOES && e->chave.freq_b == f)) {
+            descartar_entrada(cache, e);
+            descartados++;
+        }
+        e = seguinte;
+    }
+    pthread_mutex_unlock(&cache->trinco);
+    return descartados;
+}
+
+/**
+ * @brief Grava todos os resultados da cache num ficheiro
+ * @param cache Cache
+ * @param ficheiro Caminho do ficheiro a criar
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ *
+ * @details Os inteiros são gravados na representação da máquina, como nos
+ * ficheiros de mapa
+ */
+int cache_resultados_gravar(CacheResultados* cache, const char* ficheiro) {
+    if (!cache || !ficheiro) return -1;
+    FILE* f = fopen(ficheiro, "wb");
+    if (!f) return -1;
+
+    pthread_mutex_lock(&cache->trinco);
+    int32_t cabecalho[2] = { VERSAO_CACHE_RESULTADOS, cache->num_entradas };
+    bool ok = fwrite(MAGIA_CACHE_RESULTADOS, 1, 8, f) == 8 && fwrite(cabecalho, sizeof(int32_t), 2, f) == 2;
+    for (EntradaResultado* e = cache->antiga; ok && e != NULL; e = e->mais_recente) {
+        const ChaveResultado* c = &e->chave;
+        int32_t campos[7] = { c->tipo, c->modo, c->freq_a, c->freq_b, c->linhas, c->colunas, e->num };
+        uint64_t assinaturas[2] = { c->assinatura_a, c->assinatura_b };
+        size_t inteiros = (size_t)e->num * (size_t)valores_por_registo(c->tipo);
+        ok = fwrite(campos, sizeof(int32_t), 7, f) == 7 && fwrite(assinaturas, sizeof(uint64_t), 2, f) == 2 &&
+             fwrite(e->valores, sizeof(int), inteiros, f) == inteiros;
+    }
+    pthread_mutex_unlock(&cache->trinco);
+
+    if (fclose(f) != 0) ok = false;
+    return ok ? 0 : -1;
+}
+
+/**
+ * @brief Junta à cache os resultados gravados num ficheiro
+ * @param cache Cache
+ * @param ficheiro Caminho do ficheiro
+ * @return Número de resultados lidos, -1 se o ficheiro não puder ser aberto ou
+ * for inválido, -2 em caso de erro de memória
+ *
+ * @details Os resultados lidos passam a ser os mais recentes, pela ordem do
+ * ficheiro, e substituem os da mesma consulta que já estivessem na cache.
+ * Se o ficheiro estiver truncado ou tiver uma entrada inválida, ficam os
+ * resultados lidos até aí.
+ */
+int cache_resultados_ler(CacheResultados* cache, const char* ficheiro) {
+    if (!cache || !ficheiro) return -1;
+    FILE* f = fopen(ficheiro, "rb");
+    if (!f) return -1;
+
+    char magia[8];
+    int32_t cabecalho[2];
+    if (fread(magia, 1, 8, f) != 8 || memcmp(magia, MAGIA_CACHE_RESULTADOS, 8) != 0 ||
+        fread(cabecalho, sizeof(int32_t), 2, f) != 2 || cabecalho[0] != VERSAO_CACHE_RESULTADOS || cabecalho[1] < 0) {
+        fclose(f);
+        return -1;
+    }
+
+    int lidos = 0;
+    int resultado = 0;
+    for (int i = 0; i < cabecalho[1] && resultado == 0; i++) {
+        int32_t campos[7];
+        uint64_t assinaturas[2];
+        if (fread(campos, sizeof(int32_t), 7, f) != 7 || fread(assinaturas, sizeof(uint64_t), 2, f) != 2) {
+            resultado = -1;
+            break;
+        }
+        ChaveResultado chave = { campos[0], campos[1], campos[2], campos[3], campos[4], campos[5],
+                                 assinaturas[0], assinaturas[1] };
+        int num = campos[6];
+        if (!chave_valida(&chave) || num < 0 ||
+            (size_t)num > SIZE_MAX / sizeof(int) / (size_t)valores_por_registo(chave.tipo)) {
+            resultado = -1;
+            break;
+        }
+        size_t inteiros = (size_t)num * (size_t)valores_por_registo(chave.tipo);
+        int* valores = inteiros ? (int*)malloc(inteiros * sizeof(int)) : NULL;
+        if (inteiros && !valores) {
+            resultado = -2;
+            break;
+        }
+        if (fread(valores, sizeof(int), inteiros, f) != inteiros) {
+            free(valores);
+            resultado = -1;
+            break;
+        }
+        pthread_mutex_lock(&cache->trinco);
+        resultado = inserir_entrada(cache, &chave, valores, num);
+        pthread_mutex_unlock(&cache->trinco);
+        if (resultado == 0) lidos++;
+    }
+    fclose(f);
+    return resultado == 0 ? lidos : resultado;
+}
+
+/**
+ * @brief Obtém o caminho do ficheiro de cache de um mapa
+ * @param mapa Caminho do mapa (por exemplo data/mapa.bin)
+ * @param[out] nome Caminho da cache (data/mapa.cache)
+ * @param tamanho Tamanho de nome
+ * @return 0 em caso de sucesso, -1 se o caminho não couber em nome
+ *
+ * @details A extensão do nome do mapa é substituída por EXTENSAO_CACHE_RESULTADOS;
+ * sem extensão, esta é acrescentada
+ */
+int nome_cache_mapa(const char* mapa, char* nome, size_t tamanho) {
+    if (!mapa || !nome || tamanho == 0) return -1;
+    const char* base = mapa;
+    for (const char* p = mapa; *p; p++) {
+        if (*p == '/' || *p == '\\') base = p + 1;
+    }
+    const char* ponto = strrchr(base, '.');
+    size_t prefixo = ponto && ponto != base ? (size_t)(ponto - mapa) : strlen(mapa);
+    size_t extensao = strlen(EXTENSAO_CACHE_RESULTADOS);
+    if (prefixo + extensao + 1 > tamanho) return -1;
+    memcpy(nome, mapa, prefixo);
+    memcpy(nome + prefixo, EXTENSAO_CACHE_RESULTADOS, extensao + 1);
+    return 0;
+}
+
+/**
+ * @brief Estado da recolha das intersecções calculadas, para as guardar na cache
+ */
+typedef struct {
+    FuncaoIntersecao visita;    ///< Função de visita de quem chamou (pode ser NULL)
+    void* dados;                ///< Dados de quem chamou
+    bool terminada;             ///< A função de visita pediu para terminar
+    bool guardar;               ///< Recolher os valores (há cache)
+    int* valores;               ///< Registos recolhidos
+    int num;                    ///< Número de registos
+    int cap;                    ///< Capacidade, em registos
+    bool erro;                  ///< Faltou memória para os registos
+} RecolhaIntersecoes;
+
+/**
+ * @brief Função de intersecção que guarda o registo e o passa à função de quem chamou
+ * @param intersecao Intersecção encontrada
+ * @param dados Apontador para o RecolhaIntersecoes
+ * @return 0 para continuar; sem cache, o valor devolvido pela função de visita
+ *
+ * @details Com cache, a enumeração continua até ao fim mesmo que a função de
+ * visita peça para terminar, para que o resultado guardado fique completo
+ */
+static int recolher_intersecao(Intersecao* intersecao, void* dados) {
+    RecolhaIntersecoes* r = (RecolhaIntersecoes*)dados;
+    int resultado = 0;
+    if (r->visita && !r->terminada) {
+        resultado = r->visita(intersecao, r->dados);
+        if (resultado != 0) r->terminada = true;
+    }
+    if (!r->guardar) return resultado;
+
+    if (!r->erro && r->num == r->cap) {
+        int nova_cap = r->cap ? 2 * r->cap : 64;
+        int* novo = nova_cap < INT_MAX / VALORES_INTERSECAO
+                  ? (int*)realloc(r->valores, (size_t)nova_cap * VALORES_INTERSECAO * sizeof(int)) : NULL;
+        if (novo) {
+            r->valores = novo;
+            r->cap = nova_cap;
+        } else {
+            r->erro = true;
+        }
+    }
+    if (r->erro) return 0;
+
+    int* v = &r->valores[(size_t)r->num * VALORES_INTERSECAO];
+    v[0] = intersecao->x;
+    v[1] = intersecao->y;
+    v[2] = intersecao->a1->x;
+    v[3] = intersecao->a1->y;
+    v[4] = intersecao->a2->x;
+    v[5] = intersecao->a2->y;
+    v[6] = intersecao->b1->x;
+    v[7] = intersecao->b1->y;
+    v[8] = intersecao->b2->x;
+    v[9] = intersecao->b2->y;
+    r->num++;
+    return 0;
+}
+
+/**
+ * @brief Obtém a antena de uma frequência numa posição
+ * @param grafo Apontador para o grafo
+ * @param freq Frequência esperada
+ * @param x Coluna
+ * @param y Linha
+ * @return Antena, ou NULL se a posição não tiver uma antena dessa frequência
+ */
+static Vertice* antena_da_frequencia(Grafo* grafo, char freq, int x, int y) {
+    Vertice* v = encontrar_vertice(grafo, x, y);
+    return v && v->frequencia == freq ? v : NULL;
+}
+
+/**
+ * @brief Passa à função de visita as intersecções guardadas na cache
+ * @param grafo Apontador para o grafo
+ * @param freqA Primeira frequência
+ * @param freqB Segunda frequência
+ * @param valores Registos guardados
+ * @param num Número de registos
+ * @param visita Função de visita (pode ser NULL)
+ * @param dados Dados da função de visita
+ * @return num, ou -1 se alguma das antenas não for encontrada no grafo
+ *
+ * @details As antenas são procuradas pelas coordenadas guardadas. Como as
+ * assinaturas coincidem, estão lá; só não estariam se houvesse várias antenas
+ * na mesma posição, e nesse caso o resultado é calculado outra vez. Todas as
+ * antenas são confirmadas antes da primeira visita.
+ */
+static int repetir_intersecoes(Grafo* grafo, char freqA, char freqB, const int* valores, int num,
+                               FuncaoIntersecao visita, void* dados) {
+    for (int i = 0; i < num; i++) {
+        const int* v = &valores[(size_t)i * VALORES_INTERSECAO];
+        if (!antena_da_frequencia(grafo, freqA, v[2], v[3]) || !antena_da_frequencia(grafo, freqA, v[4], v[5]) ||
+            !antena_da_frequencia(grafo, freqB, v[6], v[7]) || !antena_da_frequencia(grafo, freqB, v[8], v[9])) {
+            return -1;
+        }
+    }
+    if (!visita) return num;
+
+    for (int i = 0; i < num; i++) {
+        const int* v = &valores[(size_t)i * VALORES_INTERSECAO];
+        Intersecao intersecao;
+        intersecao.x = v[0];
+        intersecao.y = v[1];
+        intersecao.a1 = antena_da_frequencia(grafo, freqA, v[2], v[3]);
+        intersecao.a2 = antena_da_frequencia(grafo, freqA, v[4], v[5]);
+        intersecao.b1 = antena_da_frequencia(grafo, freqB, v[6], v[7]);
+        intersecao.b2 = antena_da_frequencia(grafo, freqB, v[8], v[9]);
+        intersecao.prox = NULL;
+        if (visita(&intersecao, dados) != 0) break;
+    }
+    return num;
+}
+
+/**
+ * @brief Encontra e imprime as intersecções entre duas frequências, servindo-as da cache quando possível
+ * @param grafo Apontador para o grafo
+ * @param cache Cache de resultados
+ * @param freqA Primeira frequência a considerar
+ * @param freqB Segunda frequência a considerar
+ * @return Número de intersecções, ou -1 em caso de erro
+ *
+ * @details Imprime os mesmos pontos que intersecoes_frequencias (ver
+ * intersecoes_frequencias_cache_ctx quanto à ordem e aos pares atribuídos)
+ */
+int intersecoes_frequencias_cache(Grafo* grafo, CacheResultados* cache, char freqA, char freqB) {
+    if (!grafo) return -1;
+    bool cabecalho = false;
+    return intersecoes_frequencias_cache_ctx(grafo, &grafo->contexto, cache, freqA, freqB, 1,
+                                             imprimir_intersecao, &cabecalho);
+}
+
+/**
+ * @brief Encontra as intersecções entre duas frequências, chamando uma função para cada uma, servindo-as da cache quando possível
+ * @param grafo Apontador para o grafo (não é alterado)
+ * @param ctx Contexto que recebe os contadores das intersecções calculadas
+ * @param cache Cache de resultados (NULL para calcular sempre)
+ * @param freqA Primeira frequência a considerar
+ * @param freqB Segunda frequência a considerar
+ * @param num_fios Número de fios de execução da deteção (0 para usar um por processador)
+ * @param visita Função chamada para cada intersecção (pode ser NULL)
+ * @param dados Apontador passado a cada chamada de visita
+ * @return Número de intersecções, ou -1 em caso de erro
+ *
+ * @details O resultado é procurado com as assinaturas atuais de freqA e freqB.
+ * Se não estiver na cache, é calculado com intersecoes_frequencias_visitar_ctx
+ * e guardado. Os pontos visitados e o seu número são sempre os mesmos. A ordem
+ * das visitas e o par de segmentos atribuído a cada ponto são os do grafo onde
+ * o resultado foi calculado: as assinaturas não dependem da ordem das listas de
+ * adjacência nem dos índices, que mudam com remover_vertice e com as arestas
+ * de volta de adicionar_vertice_ligado, pelo que um resultado calculado depois
+ * de alterações (ou lido de um ficheiro) pode ser repetido noutra ordem ou com
+ * outros pares do que um cálculo novo daria.
+ * Com vários fios a partilhar a cache, cada um deve usar o seu contexto.
+ */
+int intersecoes_frequencias_cache_ctx(Grafo* grafo, ContextoProcura* ctx, CacheResultados* cache, char freqA,
+                                      char freqB, int num_fios, FuncaoIntersecao visita, void* dados) {
+    if (!grafo || !ctx) return -1;
+
+    ChaveResultado chave;
+    chave_resultado(&chave, grafo, RESULTADO_INTERSECOES, freqA, freqB, 0, 0);
+    if (cache) {
+        int* valores;
+        int num;
+        int encontrado = cache_resultados_obter(cache, &chave, &valores, &num);
+        if (encontrado < 0) return -1;
+        if (encontrado == 1) {
+            int resultado = repetir_intersecoes(grafo, freqA, freqB, valores, num, visita, dados);
+            free(valores);
+            if (resultado >= 0) return resultado;
+        }
+    }
+
+    RecolhaIntersecoes recolha = { visita, dados, false, cache != NULL, NULL, 0, 0, false };
+    int count = intersecoes_frequencias_visitar_ctx(grafo, ctx, freqA, freqB, num_fios, recolher_intersecao, &recolha);
+    if (count >= 0 && cache && !recolha.erro) cache_resultados_guardar(cache, &chave, recolha.valores, recolha.num);
+    free(recolha.valores);
+    return count;
+}
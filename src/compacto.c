@@ -0,0 +1,292 @@
+/**
+ * @file compacto.c
+ * @brief Implementação da representação compacta de grafos de antenas
+ *
+ * @details Implementa as funções declaradas em compacto.h, incluindo:
+ * - Compactação de um Grafo (vértices de 6 bytes, adjacências de 32 bits)
+ * - Índice de posições ordenado por radix sort, para pesquisa binária
+ * - Procuras em profundidade e em largura, as mesmas do CSR (VistaCSR)
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "grafo.h"
+#include "mapa.h"
+#include "csr.h"
+#include "compacto.h"
+
+#define BALDES_COORDENADA (MAX_COORDENADA_COMPACTA + 1)  ///< Valores possíveis de uma coordenada
+
+/**
+ * @brief Ordena os índices dos vértices por (y, x)
+ * @param grafo Grafo compacto com os vértices já preenchidos
+ * @return 0 em caso de sucesso, -2 em caso de erro de memória
+ *
+ * @details Radix sort em duas passagens estáveis de contagem, primeiro por x e
+ * depois por y, em O(n + 65536). Vértices com as mesmas coordenadas ficam por
+ * ordem de índice.
+ */
+static int ordenar_posicoes(GrafoCompacto* grafo) {
+    uint32_t n = grafo->num_vertices;
+    uint32_t* auxiliar = (uint32_t*)malloc((n ? n : 1) * sizeof(uint32_t));
+    uint32_t* contagem = (uint32_t*)malloc((BALDES_COORDENADA + 1) * sizeof(uint32_t));
+    if (!auxiliar || !contagem) {
+        free(auxiliar);
+        free(contagem);
+        return -2;
+    }
+
+    for (int passagem = 0; passagem < 2; passagem++) {
+        const uint32_t* origem = passagem == 0 ? NULL : auxiliar;
+        uint32_t* destino = passagem == 0 ? auxiliar : grafo->por_posicao;
+
+        memset(contagem, 0, (BALDES_COORDENADA + 1) * sizeof(uint32_t));
+        for (uint32_t i = 0; i < n; i++) {
+            const VerticeCompacto* v = &grafo->vertices[i];
+            contagem[(passagem == 0 ? v->x : v->y) + 1]++;
+        }
+        for (uint32_t c = 0; c < BALDES_COORDENADA; c++) contagem[c + 1] += contagem[c];
+        for (uint32_t i = 0; i < n; i++) {
+            uint32_t indice = origem ? origem[i] : i;
+            const VerticeCompacto* v = &grafo->vertices[indice];
+            destino[contagem[passagem == 0 ? v->x : v->y]++] = indice;
+        }
+    }
+
+    free(auxiliar);
+    free(contagem);
+    return 0;
+}
+
+/**
+ * @brief Converte um grafo na sua representação compacta
+ * @param grafo Apontador para o grafo a compactar (só lido)
+ * @return Apontador para o grafo compacto, ou NULL em caso de erro, de falta de
+ * memória ou se o grafo não couber nos limites da representação
+ *
+ * @details Como grafo_congelar, faz duas passagens pelos vértices com o
+ * IteradorVizinhos, pelo que funciona com arestas explícitas e implícitas:
+ * 1. Copia as posições, confirma que cabem em 16 bits e conta os graus
+ * 2. Preenche os vizinhos pela ordem de iteração
+ *
+ * No modo implícito cada frequência com k antenas dá k * (k - 1) entradas.
+ */
+GrafoCompacto* grafo_compactar(const Grafo* grafo) {
+    if (!grafo || grafo->num_vertices < 0) return NULL;
+
+    GrafoCompacto* compacto = (GrafoCompacto*)calloc(1, sizeof(GrafoCompacto));
+    if (!compacto) return NULL;
+
+    uint32_t n = (uint32_t)grafo->num_vertices;
+    compacto->num_vertices = n;
+    compacto->vertices = (VerticeCompacto*)malloc((n ? n : 1) * sizeof(VerticeCompacto));
+    compacto->inicios = (uint32_t*)calloc((size_t)n + 1, sizeof(uint32_t));
+    compacto->por_posicao = (uint32_t*)malloc((n ? n : 1) * sizeof(uint32_t));
+    if (!compacto->vertices || !compacto->inicios || !compacto->por_posicao) {
+        destruir_grafo_compacto(compacto);
+        return NULL;
+    }
+
+    // 1. Posições e graus
+    unsigned long long total = 0;
+    for (Vertice* v = grafo->vertices; v != NULL; v = v->proximo) {
+        if (v->x < 0 || v->x > MAX_COORDENADA_COMPACTA || v->y < 0 || v->y > MAX_COORDENADA_COMPACTA) {
+            destruir_grafo_compacto(compacto);
+            return NULL;
+        }
+        VerticeCompacto* c = &compacto->vertices[v->id];
+        c->x = (uint16_t)v->x;
+        c->y = (uint16_t)v->y;
+        c->frequencia = (uint8_t)v->frequencia;
+
+        IteradorVizinhos it;
+        iniciar_vizinhos(grafo, v, &it);
+        uint32_t grau = 0;
+        while (proximo_vizinho(&it) != NULL) grau++;
+        compacto->inicios[v->id + 1] = grau;
+        total += grau;
+    }
+    if (total > UINT32_MAX) {
+        destruir_grafo_compacto(compacto);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < n; i++) compacto->inicios[i + 1] += compacto->inicios[i];
+    compacto->num_arestas = (uint32_t)total;
+
+    // 2. Vizinhos
+    compacto->vizinhos = (uint32_t*)malloc((total ? total : 1) * sizeof(uint32_t));
+    if (!compacto->vizinhos || ordenar_posicoes(compacto) != 0) {
+        destruir_grafo_compacto(compacto);
+        return NULL;
+    }
+    for (Vertice* v = grafo->vertices; v != NULL; v = v->proximo) {
+        IteradorVizinhos it;
+        iniciar_vizinhos(grafo, v, &it);
+        uint32_t pos = compacto->inicios[v->id];
+        Vertice* u;
+        while ((u = proximo_vizinho(&it)) != NULL) compacto->vizinhos[pos++] = (uint32_t)u->id;
+    }
+
+    return compacto;
+}
+
+/**
+ * @brief Carrega um mapa diretamente para a representação compacta
+ * @param ficheiro Caminho para o ficheiro do mapa
+ * @return Apontador para o grafo compacto ou NULL em caso de erro
+ *
+ * @details O mapa é carregado com arestas implícitas, que não alocam nenhuma
+ * Aresta, e o grafo intermédio é destruído logo a seguir à compactação
+ */
+GrafoCompacto* carregar_mapa_compacto(const char* ficheiro) {
+    Grafo* grafo = carregar_mapa_modo(ficheiro, ARESTAS_IMPLICITAS);
+    if (!grafo) return NULL;
+    GrafoCompacto* compacto = grafo_compactar(grafo);
+    destruir_grafo(grafo);
+    return compacto;
+}
+
+/**
+ * @brief Liberta toda a memória associada a um grafo compacto
+ * @param grafo Apontador para o grafo compacto a destruir
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int destruir_grafo_compacto(GrafoCompacto* grafo) {
+    if (!grafo) return -1;
+    free(grafo->vertices);
+    free(grafo->inicios);
+    free(grafo->vizinhos);
+    free(grafo->por_posicao);
+    free(grafo);
+    return 0;
+}
+
+/**
+ * @brief Calcula a memória ocupada por um grafo compacto
+ * @param grafo Apontador para o grafo compacto
+ * @return Número de bytes dos vetores do grafo e da própria estrutura
+ *
+ * @details São 14 bytes por vértice (posição e frequência, início das
+ * adjacências e entrada no índice de posições) mais 4 por entrada de adjacência
+ */
+size_t compacto_memoria(const GrafoCompacto* grafo) {
+    if (!grafo) return 0;
+    return sizeof(GrafoCompacto)
+         + (size_t)grafo->num_vertices * (sizeof(VerticeCompacto) + 2 * sizeof(uint32_t))
+         + sizeof(uint32_t)
+         + (size_t)grafo->num_arestas * sizeof(uint32_t);
+}
+
+/**
+ * @brief Encontra o índice de um vértice pelas suas coordenadas
+ * @param grafo Apontador para o grafo compacto
+ * @param x Coordenada x (coluna) do vértice
+ * @param y Coordenada y (linha) do vértice
+ * @return Índice do vértice ou -1 se não existir
+ *
+ * @details Pesquisa binária em por_posicao. Se houver vários vértices na mesma
+ * posição devolve o de maior índice, como csr_encontrar_vertice.
+ */
+long long compacto_encontrar_vertice(const GrafoCompacto* grafo, int x, int y) {
+    if (!grafo || x < 0 || x > MAX_COORDENADA_COMPACTA || y < 0 || y > MAX_COORDENADA_COMPACTA) return -1;
+
+    uint32_t chave = ((uint32_t)y << 16) | (uint32_t)x;
+    uint32_t baixo = 0, alto = grafo->num_vertices;   // primeira posição com chave > procurada
+    while (baixo < alto) {
+        uint32_t meio = baixo + (alto - baixo) / 2;
+        const VerticeCompacto* v = &grafo->vertices[grafo->por_posicao[meio]];
+        if ((((uint32_t)v->y << 16) | v->x) > chave) {
+            alto = meio;
+        } else {
+            baixo = meio + 1;
+        }
+    }
+    if (baixo == 0) return -1;
+    uint32_t indice = grafo->por_posicao[baixo - 1];
+    const VerticeCompacto* v = &grafo->vertices[indice];
+    return (v->x == x && v->y == y) ? (long long)indice : -1;
+}
+
+/**
+ * @brief Obtém a vista das adjacências de um grafo compacto
+ * @param grafo Apontador para o grafo compacto
+ * @param[out] vista Vista a preencher, com inícios de 32 bits
+ */
+static void compacto_vista(const GrafoCompacto* grafo, VistaCSR* vista) {
+    vista->num_vertices = (int)grafo->num_vertices;
+    vista->offsets = NULL;
+    vista->inicios32 = grafo->inicios;
+    vista->destinos = (const int*)grafo->vizinhos;
+}
+
+/**
+ * @brief Função de visita e dados de uma procura compacta, passados através da VistaCSR
+ */
+typedef struct {
+    const GrafoCompacto* grafo;     ///< Grafo percorrido
+    FuncaoVisitaCompacto visita;    ///< Função de visita do chamador
+    void* dados;                    ///< Dados do chamador
+} VisitaCompacta;
+
+/**
+ * @brief Encaminha a visita de um vértice para a função do chamador
+ * @param v Índice do vértice visitado
+ * @param dados Apontador para a VisitaCompacta
+ * @return Valor devolvido pela função do chamador
+ */
+static int visitar_compacto(int v, void* dados) {
+    VisitaCompacta* c = (VisitaCompacta*)dados;
+    return c->visita(c->grafo, (uint32_t)v, c->dados);
+}
+
+/**
+ * @brief Executa uma procura em profundidade sobre o grafo compacto
+ * @param grafo Apontador para o grafo compacto
+ * @param inicio Índice do vértice de início
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 se a procura terminou, 1 se foi interrompida pela função de visita,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ *
+ * @details É csr_vista_profundidade sobre os inícios de 32 bits, pelo que a
+ * ordem de visita é a do grafo original e as marcas de visita ocupam um bit por
+ * vértice. O grafo nunca é alterado.
+ */
+int compacto_procura_profundidade(const GrafoCompacto* grafo, uint32_t inicio,
+                                  FuncaoVisitaCompacto visita, void* dados) {
+    if (!grafo || !visita || inicio >= grafo->num_vertices) return -1;
+    VistaCSR vista;
+    compacto_vista(grafo, &vista);
+    VisitaCompacta c = { grafo, visita, dados };
+    return csr_vista_profundidade(&vista, (int)inicio, visitar_compacto, &c);
+}
+
+/**
+ * @brief Executa uma procura em largura sobre o grafo compacto
+ * @param grafo Apontador para o grafo compacto
+ * @param inicio Índice do vértice de início
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 se a procura terminou, 1 se foi interrompida pela função de visita,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ *
+ * @details É csr_vista_largura sobre os inícios de 32 bits
+ */
+int compacto_procura_largura(const GrafoCompacto* grafo, uint32_t inicio,
+                             FuncaoVisitaCompacto visita, void* dados) {
+    if (!grafo || !visita || inicio >= grafo->num_vertices) return -1;
+    VistaCSR vista;
+    compacto_vista(grafo, &vista);
+    VisitaCompacta c = { grafo, visita, dados };
+    return csr_vista_largura(&vista, (int)inicio, visitar_compacto, &c);
+}
@@ -0,0 +1,506 @@
+/**
+ * @file consultas.c
+ * @brief Implementação da execução em lote de consultas sobre um grafo de antenas
+ *
+ * @details Implementa as funções declaradas em consultas.h:
+ * - Leitura das consultas em lotes de tamanho fixo
+ * - Execução de cada lote repartida por vários fios, cada um com o seu contexto de procura
+ * - Escrita dos resultados de cada consulta num texto em memória, despejado
+ *   na saída de uma só vez e pela ordem das consultas
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "consultas.h"
+#include "intersecao.h"
+#include "mapa.h"
+
+/**
+ * @struct TextoConsulta
+ * @brief Texto em memória com o resultado de uma consulta
+ */
+typedef struct TextoConsulta {
+    char* dados;            ///< Carateres escritos (sem terminador)
+    size_t tamanho;         ///< Número de carateres escritos
+    size_t cap;             ///< Capacidade de dados
+    bool erro;              ///< Uma escrita falhou por falta de memória
+} TextoConsulta;
+
+/**
+ * @struct Consulta
+ * @brief Uma linha de consulta e o texto do seu resultado
+ */
+typedef struct Consulta {
+    char linha[MAX_LINHA_CONSULTA];  ///< Linha lida, sem o fim de linha
+    bool longa;             ///< A linha excedia MAX_LINHA_CONSULTA e foi cortada
+    TextoConsulta resultado;  ///< Resultado, reutilizado de lote para lote
+} Consulta;
+
+/**
+ * @struct TrabalhoConsultas
+ * @brief Lote partilhado pelos fios de execução
+ */
+typedef struct TrabalhoConsultas {
+    Grafo* grafo;           ///< Grafo consultado (só lido)
+    CacheResultados* cache; ///< Cache de resultados partilhada (pode ser NULL)
+    Consulta* consultas;    ///< Consultas do lote
+    int num;                ///< Número de consultas do lote
+    atomic_int proxima;     ///< Próxima consulta por executar
+} TrabalhoConsultas;
+
+/**
+ * @struct FioConsultas
+ * @brief Estado próprio de cada fio de execução
+ */
+typedef struct FioConsultas {
+    TrabalhoConsultas* trabalho;  ///< Lote partilhado
+    ContextoProcura ctx;    ///< Contexto de procura do fio, mantido entre lotes
+} FioConsultas;
+
+/**
+ * @brief Acrescenta texto formatado ao resultado de uma consulta
+ * @param t Texto de destino
+ * @param formato Formato, como em printf
+ *
+ * @details O texto cresce por duplicação; se faltar memória fica marcado com erro
+ * e as escritas seguintes são ignoradas
+ */
+static void texto_escrever(TextoConsulta* t, const char* formato, ...) {
+    while (!t->erro) {
+        size_t livre = t->cap - t->tamanho;
+        va_list args;
+        va_start(args, formato);
+        int n = vsnprintf(t->dados ? t->dados + t->tamanho : NULL, livre, formato, args);
+        va_end(args);
+        if (n < 0) {
+            t->erro = true;
+            return;
+        }
+        if ((size_t)n < livre) {
+            t->tamanho += (size_t)n;
+            return;
+        }
+        size_t nova_cap = t->cap ? 2 * t->cap : 256;
+        while (nova_cap - t->tamanho <= (size_t)n) nova_cap *= 2;
+        char* novo = (char*)realloc(t->dados, nova_cap);
+        if (!novo) {
+            t->erro = true;
+            return;
+        }
+        t->dados = novo;
+        t->cap = nova_cap;
+    }
+}
+
+/**
+ * @brief Acrescenta uma antena, no formato F(x,y), ao resultado de uma consulta
+ * @param t Texto de destino
+ * @param v Antena a escrever
+ * @param separador Texto escrito antes da antena
+ */
+static void texto_vertice(TextoConsulta* t, const Vertice* v, const char* separador) {
+    texto_escrever(t, "%s%c(%d,%d)", separador, v->frequencia, v->x, v->y);
+}
+
+/**
+ * @brief Estado das funções de visita das consultas
+ */
+typedef struct {
+    TextoConsulta* texto;   ///< Resultado da consulta
+    long long total;        ///< Vértices, caminhos ou intersecções escritos
+    long long limite;       ///< Número máximo a escrever (0 para não limitar)
+} EscritaConsulta;
+
+/**
+ * @brief Função de visita que escreve a antena visitada
+ * @param v Vértice visitado
+ * @param dados Apontador para o EscritaConsulta
+ * @return 0, para a procura continuar
+ */
+static int escrever_visita(Vertice* v, void* dados) {
+    EscritaConsulta* e = (EscritaConsulta*)dados;
+    texto_vertice(e->texto, v, e->total ? " " : "");
+    e->total++;
+    return 0;
+}
+
+/**
+ * @brief Escreve um caminho, do início para o fim
+ * @param t Texto de destino
+ * @param caminho Último nó do caminho
+ */
+static void escrever_caminho_inverso(TextoConsulta* t, const CaminhoNode* caminho) {
+    if (caminho == NULL) return;
+    escrever_caminho_inverso(t, caminho->prox);
+    texto_vertice(t, caminho->vertice, " ");
+}
+
+/**
+ * @brief Função de caminho que escreve o caminho numerado, até ao limite de caminhos
+ * @param caminho Último nó do caminho
+ * @param comprimento Número de vértices no caminho
+ * @param dados Apontador para o EscritaConsulta
+ * @return 0 para continuar, 1 quando o limite de caminhos é atingido
+ */
+static int escrever_caminho(CaminhoNode* caminho, int comprimento, void* dados) {
+    (void)comprimento;
+    EscritaConsulta* e = (EscritaConsulta*)dados;
+    e->total++;
+    texto_escrever(e->texto, "Caminho %lld:", e->total);
+    escrever_caminho_inverso(e->texto, caminho);
+    texto_escrever(e->texto, "\n");
+    return e->limite > 0 && e->total >= e->limite;
+}
+
+/**
+ * @brief Função de intersecção que escreve a linha da intersecção
+ * @param intersecao Intersecção encontrada
+ * @param dados Apontador para o EscritaConsulta
+ * @return 0, para a enumeração continuar
+ */
+static int escrever_intersecao(Intersecao* intersecao, void* dados) {
+    EscritaConsulta* e = (EscritaConsulta*)dados;
+    texto_escrever(e->texto, "Linha");
+    texto_vertice(e->texto, intersecao->a1, " ");
+    texto_vertice(e->texto, intersecao->a2, "-");
+    texto_escrever(e->texto, " com");
+    texto_vertice(e->texto, intersecao->b1, " ");
+    texto_vertice(e->texto, intersecao->b2, "-");
+    texto_escrever(e->texto, " em (%d,%d)\n", intersecao->x, intersecao->y);
+    e->total++;
+    return 0;
+}
+
+/**
+ * @brief Obtém a antena numa posição, escrevendo um erro se não existir
+ * @param grafo Grafo consultado
+ * @param x Coordenada x
+ * @param y Coordenada y
+ * @param t Resultado da consulta
+ * @return Vértice na posição, ou NULL
+ */
+static Vertice* obter_antena(Grafo* grafo, int x, int y, TextoConsulta* t) {
+    Vertice* v = encontrar_vertice(grafo, x, y);
+    if (!v) texto_escrever(t, "erro: nao existe antena em (%d,%d)\n", x, y);
+    return v;
+}
+
+/**
+ * @brief Escreve o erro correspondente a um código de retorno negativo
+ * @param t Resultado da consulta
+ * @param codigo Código devolvido pela operação
+ * @return true se o código era um erro
+ */
+static bool escrever_erro(TextoConsulta* t, int codigo) {
+    if (codigo >= 0) return false;
+    texto_escrever(t, codigo == -2 ? "erro: memoria insuficiente\n" : "erro: consulta invalida\n");
+    return true;
+}
+
+/**
+ * @brief Executa uma consulta e escreve o seu resultado
+ * @param grafo Grafo consultado (só lido)
+ * @param ctx Contexto de procura do fio que executa a consulta
+ * @param cache Cache de resultados das intersecções e dos efeitos (pode ser NULL)
+ * @param c Consulta a executar
+ *
+ * @details O resultado começa pela própria linha, precedida de "> ", seguida
+ * das linhas de resposta
+ */
+static void executar_consulta(Grafo* grafo, ContextoProcura* ctx, CacheResultados* cache, Consulta* c) {
+    TextoConsulta* t = &c->resultado;
+    t->tamanho = 0;
+    t->erro = false;
+    texto_escrever(t, "> %s\n", c->linha);
+    if (c->longa) {
+        texto_escrever(t, "erro: linha com mais de %d carateres\n", MAX_LINHA_CONSULTA - 2);
+        return;
+    }
+
+    char comando[16];
+    int a[6];
+    if (sscanf(c->linha, "%15s", comando) != 1) return;
+    int n = sscanf(c->linha, "%*s %d %d %d %d %d %d", &a[0], &a[1], &a[2], &a[3], &a[4], &a[5]);
+    if (n < 0) n = 0;
+    EscritaConsulta e = { t, 0, 0 };
+
+    if (strcmp(comando, "dfs") == 0 || strcmp(comando, "bfs") == 0) {
+        if (n != 2) {
+            texto_escrever(t, "erro: utilizacao: %s x y\n", comando);
+            return;
+        }
+        Vertice* inicio = obter_antena(grafo, a[0], a[1], t);
+        if (!inicio) return;
+        int r = comando[0] == 'd'
+              ? procura_profundidade_visitar_ctx(grafo, ctx, inicio, escrever_visita, &e)
+              : procura_largura_visitar_ctx(grafo, ctx, inicio, escrever_visita, &e);
+        texto_escrever(t, "\n");
+        if (!escrever_erro(t, r)) texto_escrever(t, "%lld antenas\n", e.total);
+    } else if (strcmp(comando, "caminhos") == 0 || strcmp(comando, "contar") == 0 ||
+               strcmp(comando, "curto") == 0 || strcmp(comando, "alcanca") == 0) {
+        bool enumerar = strcmp(comando, "caminhos") == 0;
+        bool alcanca = strcmp(comando, "alcanca") == 0;
+        if (n < (alcanca ? 5 : 4) || n > (enumerar ? 6 : 5) || (n > 4 && a[4] < 0) || (n > 5 && a[5] < 0)) {
+            texto_escrever(t, "erro: utilizacao: %s x1 y1 x2 y2 %s\n", comando,
+                           alcanca ? "saltos" : enumerar ? "[saltos [caminhos]]" : "[saltos]");
+            return;
+        }
+        Vertice* origem = obter_antena(grafo, a[0], a[1], t);
+        Vertice* destino = obter_antena(grafo, a[2], a[3], t);
+        if (!origem || !destino) return;
+        int saltos = n > 4 ? a[4] : 0;
+
+        if (enumerar) {
+            e.limite = n > 5 ? a[5] : MAX_CAMINHOS_CONSULTA;
+            int r = encontrar_caminhos_visitar_limitado_ctx(grafo, ctx, origem, destino, saltos,
+                                                            escrever_caminho, &e);
+            if (!escrever_erro(t, r)) {
+                texto_escrever(t, "%lld caminhos%s\n", e.total, r == 1 ? " (limite atingido)" : "");
+            }
+        } else if (alcanca) {
+            int r = alcancavel_ctx(grafo, ctx, origem, destino, saltos);
+            if (!escrever_erro(t, r)) texto_escrever(t, r ? "sim\n" : "nao\n");
+        } else if (strcmp(comando, "contar") == 0) {
+            unsigned long long total;
+            int r = contar_caminhos_ctx(grafo, ctx, origem, destino, saltos, &total);
+            if (!escrever_erro(t, r)) texto_escrever(t, "%s%llu caminhos\n", r == 1 ? "pelo menos " : "", total);
+        } else {
+            Vertice** caminho;
+            int r = caminho_mais_curto_bidirecional_ctx(grafo, ctx, origem, destino, saltos, &caminho);
+            if (r == 0) {
+                texto_escrever(t, "inalcancavel\n");
+            } else if (!escrever_erro(t, r)) {
+                texto_escrever(t, "%d saltos:", r - 1);
+                for (int i = 0; i < r; i++) texto_vertice(t, caminho[i], " ");
+                texto_escrever(t, "\n");
+                free(caminho);
+            }
+        }
+    } else if (strcmp(comando, "intersecoes") == 0) {
+        char freqA, freqB, resto;
+        if (sscanf(c->linha, "%*s %c %c %c", &freqA, &freqB, &resto) != 2) {
+            texto_escrever(t, "erro: utilizacao: intersecoes A B\n");
+            return;
+        }
+        int r = intersecoes_frequencias_cache_ctx(grafo, ctx, cache, freqA, freqB, 1, escrever_intersecao, &e);
+        if (!escrever_erro(t, r)) texto_escrever(t, "%d intersecoes\n", r);
+    } else if (strcmp(comando, "efeitos") == 0) {
+        if (n != 2 || a[0] <= 0 || a[1] <= 0) {
+            texto_escrever(t, "erro: utilizacao: efeitos linhas colunas\n");
+            return;
+        }
+        Posicao* posicoes;
+        int num;
+        int r = posicoes_efeito_cache(grafo, cache, a[0], a[1], &posicoes, &num);
+        if (escrever_erro(t, r)) return;
+        for (int i = 0; i < num; i++) texto_escrever(t, "%s(%d,%d)", i ? " " : "", posicoes[i].x, posicoes[i].y);
+        texto_escrever(t, "\n%d efeitos\n", num);
+        free(posicoes);
+    } else if (strcmp(comando, "retangulo") == 0 || strcmp(comando, "raio") == 0 ||
+               strcmp(comando, "proximas") == 0) {
+        bool retangulo = comando[0] == 'r' && comando[1] == 'e';
+        bool proximas = comando[0] == 'p';
+        int inteiros = n > (retangulo ? 4 : 3) ? (retangulo ? 4 : 3) : n;
+        
+        // A frequência opcional é o campo seguinte aos inteiros (e pode ser um algarismo)
+        const char* p = c->linha;
+        for (int i = 0; i <= inteiros; i++) {
+            p += strspn(p, " \t");
+            p += strcspn(p, " \t");
+        }
+        char freq, resto;
+        int extra = sscanf(p, " %c %c", &freq, &resto);
+        int f = extra == 1 ? (unsigned char)freq : TODAS_FREQUENCIAS;
+        if (inteiros < (retangulo ? 4 : proximas ? 2 : 3) || extra > 1 || (inteiros == 3 && a[2] < 0) ||
+            (proximas && extra == 1 && inteiros < 3)) {
+            texto_escrever(t, "erro: utilizacao: %s\n", retangulo ? "retangulo x0 y0 x1 y1 [F]" :
+                           proximas ? "proximas x y [k [F]]" : "raio x y r [F]");
+            return;
+        }
+        int r;
+        if (proximas) {
+            int k = inteiros == 3 ? a[2] : 1;
+            // Nunca há mais do que num_vertices antenas a devolver
+            if (k > grafo->num_vertices) k = grafo->num_vertices;
+            Vertice**resultado = (Vertice**)malloc((size_t)(k ? k : 1) * sizeof(Vertice*));
+            r = resultado ? antenas_mais_proximas(grafo, f, a[0], a[1], k, resultado) : -2;
+            for (int i = 0; i < r; i++) texto_vertice(t, resultado[i], i ? " " : "");
+            free(resultado);
+            e.total = r;
+        } else if (retangulo) {
+            r = antenas_no_retangulo(grafo, f, a[0], a[1], a[2], a[3], escrever_visita, &e);
+        } else {
+            r = antenas_no_raio(grafo, f, a[0], a[1], a[2], escrever_visita, &e);
+        }
+        texto_escrever(t, "\n");
+        if (!escrever_erro(t, r)) texto_escrever(t, "%lld antenas\n", e.total);
+    } else {
+        texto_escrever(t, "erro: consulta desconhecida '%s'\n", comando);
+    }
+}
+
+/**
+ * @brief Corpo de cada fio de execução: executa as consultas do lote que obtiver
+ * @param arg Apontador para o FioConsultas do fio
+ * @return NULL
+ */
+static void* trabalhar_consultas(void* arg) {
+    FioConsultas* fio = (FioConsultas*)arg;
+    TrabalhoConsultas* t = fio->trabalho;
+
+    while (1) {
+        int k = atomic_fetch_add(&t->proxima, 1);
+        if (k >= t->num) break;
+        executar_consulta(t->grafo, &fio->ctx, t->cache, &t->consultas[k]);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Lê o próximo lote de consultas
+ * @param entrada Ficheiro de consultas
+ * @param consultas Consultas a preencher
+ * @param max Número máximo de consultas a ler
+ * @return Número de consultas lidas (0 no fim da entrada)
+ *
+ * @details Ignora as linhas vazias e os comentários. Uma linha demasiado
+ * longa é cortada e marcada, e o seu resto é descartado.
+ */
+static int ler_lote(FILE* entrada, Consulta* consultas, int max) {
+    int num = 0;
+    while (num < max) {
+        Consulta* c = &consultas[num];
+        if (!fgets(c->linha, sizeof(c->linha), entrada)) break;
+
+        size_t len = strlen(c->linha);
+        c->longa = len > 0 && c->linha[len - 1] != '\n' && !feof(entrada);
+        if (c->longa) {
+            int ch;
+            while ((ch = fgetc(entrada)) != EOF && ch != '\n') {}
+        }
+        while (len > 0 && (c->linha[len - 1] == '\n' || c->linha[len - 1] == '\r')) c->linha[--len] = '\0';
+
+        const char* p = c->linha;
+        while (isspace((unsigned char)*p)) p++;
+        if (*p == '\0' || *p == '#') continue;
+        num++;
+    }
+    return num;
+}
+
+/**
+ * @brief Executa as consultas lidas de um ficheiro e escreve os resultados noutro
+ * @param grafo Grafo sobre o qual as consultas são feitas (não é alterado)
+ * @param entrada Ficheiro de consultas, uma por linha
+ * @param saida Ficheiro de resultados
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @param tamanho_lote Número de consultas executadas de cada vez (1 para responder linha a linha)
+ * @return Número de consultas executadas, -1 em caso de erro, -2 em caso de erro de memória
+ *
+ * @details Repete até ao fim da entrada:
+ * 1. Lê até tamanho_lote consultas
+ * 2. Executa-as em paralelo; os fios vão obtendo consultas de um contador
+ *    atómico e cada um usa o seu ContextoProcura, pelo que o grafo é só lido
+ * 3. Escreve os resultados pela ordem das consultas e despeja a saída, para
+ *    que quem está do outro lado de um canal receba as respostas do lote
+ *
+ * Os contextos e os textos dos resultados são reutilizados de lote para lote.
+ * O grafo não pode ser alterado durante a execução.
+ */
+long long executar_consultas(Grafo* grafo, FILE* entrada, FILE* saida, int num_fios, int tamanho_lote) {
+    return executar_consultas_cache(grafo, NULL, entrada, saida, num_fios, tamanho_lote);
+}
+
+/**
+ * @brief Executa as consultas lidas de um ficheiro, servindo as intersecções e os efeitos de uma cache
+ * @param grafo Grafo sobre o qual as consultas são feitas (não é alterado)
+ * @param cache Cache de resultados partilhada pelos fios (NULL para calcular sempre)
+ * @param entrada Ficheiro de consultas, uma por linha
+ * @param saida Ficheiro de resultados
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @param tamanho_lote Número de consultas executadas de cada vez (1 para responder linha a linha)
+ * @return Número de consultas executadas, -1 em caso de erro, -2 em caso de erro de memória
+ *
+ * @details O mesmo que executar_consultas; as consultas "intersecoes" e
+ * "efeitos" procuram primeiro o resultado na cache e guardam-no quando o calculam
+ */
+long long executar_consultas_cache(Grafo* grafo, CacheResultados* cache, FILE* entrada, FILE* saida,
+                                   int num_fios, int tamanho_lote) {
+    if (!grafo || !entrada || !saida || num_fios < 0 || tamanho_lote < 1) return -1;
+    if (num_fios == 0) num_fios = numero_processadores();
+    if (num_fios > tamanho_lote) num_fios = tamanho_lote;
+
+    Consulta* consultas = (Consulta*)calloc((size_t)tamanho_lote, sizeof(Consulta));
+    FioConsultas* fios = (FioConsultas*)malloc((size_t)num_fios * sizeof(FioConsultas));
+    pthread_t* ids = num_fios > 1 ? (pthread_t*)malloc((size_t)(num_fios - 1) * sizeof(pthread_t)) : NULL;
+    if (!consultas || !fios || (num_fios > 1 && !ids)) {
+        free(consultas);
+        free(fios);
+        free(ids);
+        return -2;
+    }
+
+    TrabalhoConsultas t;
+    t.grafo = grafo;
+    t.cache = cache;
+    t.consultas = consultas;
+    for (int f = 0; f < num_fios; f++) {
+        fios[f].trabalho = &t;
+        contexto_iniciar(&fios[f].ctx);
+    }
+
+    long long total = 0;
+    int num;
+    while (total >= 0 && (num = ler_lote(entrada, consultas, tamanho_lote)) > 0) {
+        t.num = num;
+        atomic_init(&t.proxima, 0);
+
+        int usar = num_fios < num ? num_fios : num;
+        int criados = 0;
+        for (int f = 1; f < usar; f++) {
+            if (pthread_create(&ids[criados], NULL, trabalhar_consultas, &fios[f]) != 0) break;
+            criados++;
+        }
+        trabalhar_consultas(&fios[0]);
+        for (int f = 0; f < criados; f++) pthread_join(ids[f], NULL);
+
+        for (int k = 0; k < num; k++) {
+            TextoConsulta* r = &consultas[k].resultado;
+            if (r->erro) {
+                total = -2;
+                break;
+            }
+            if (fwrite(r->dados, 1, r->tamanho, saida) != r->tamanho) {
+                total = -1;
+                break;
+            }
+        }
+        if (total < 0) break;
+        if (fflush(saida) != 0) {
+            total = -1;
+            break;
+        }
+        total += num;
+    }
+
+    for (int f = 0; f < num_fios; f++) contexto_libertar(&fios[f].ctx);
+    for (int k = 0; k < tamanho_lote; k++) free(consultas[k].resultado.dados);
+    free(consultas);
+    free(fios);
+    free(ids);
+    return total;
+}
@@ -0,0 +1,660 @@
+/**
+ * @file csr.c
+ * @brief Implementação da representação CSR de grafos de antenas
+ *
+ * @details Implementa as funções declaradas em csr.h, incluindo:
+ * - Conversão de um Grafo em vetores contíguos (congelamento)
+ * - Procura em profundidade e em largura sem listas ligadas, partilhadas com o
+ *   grafo compacto através de VistaCSR
+ * - Enumeração de caminhos com pilha explícita
+ * - Componentes ligadas com union-find concorrente em vários fios
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "grafo.h"
+#include "csr.h"
+#include "intersecao.h"
+
+/**
+ * @brief Posição de um vértice, para ordenar o índice de posições
+ */
+typedef struct {
+    int y;          ///< Coordenada y (linha)
+    int x;          ///< Coordenada x (coluna)
+    int indice;     ///< Índice do vértice
+} PosicaoVertice;
+
+/**
+ * @brief Compara duas posições por (y, x) e, na mesma posição, pelo índice
+ */
+static int comparar_posicoes(const void* a, const void* b) {
+    const PosicaoVertice* pa = (const PosicaoVertice*)a;
+    const PosicaoVertice* pb = (const PosicaoVertice*)b;
+    if (pa->y != pb->y) return pa->y < pb->y ? -1 : 1;
+    if (pa->x != pb->x) return pa->x < pb->x ? -1 : 1;
+    return (pa->indice > pb->indice) - (pa->indice < pb->indice);
+}
+
+/**
+ * @brief Preenche por_posicao com os índices dos vértices ordenados por (y, x)
+ * @param csr Grafo CSR com as coordenadas já preenchidas
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
+ *
+ * @details Vértices com as mesmas coordenadas ficam por ordem de índice
+ */
+static int ordenar_posicoes(GrafoCSR* csr) {
+    int n = csr->num_vertices;
+    PosicaoVertice* posicoes = (PosicaoVertice*)malloc((n ? n : 1) * sizeof(PosicaoVertice));
+    if (!posicoes) return -1;
+    for (int i = 0; i < n; i++) {
+        posicoes[i].y = csr->y[i];
+        posicoes[i].x = csr->x[i];
+        posicoes[i].indice = i;
+    }
+    qsort(posicoes, (size_t)n, sizeof(PosicaoVertice), comparar_posicoes);
+    for (int i = 0; i < n; i++) csr->por_posicao[i] = posicoes[i].indice;
+    free(posicoes);
+    return 0;
+}
+
+/**
+ * @brief Converte um grafo na sua representação CSR
+ * @param grafo Apontador para o grafo a congelar (só lido)
+ * @return Apontador para o grafo CSR ou NULL em caso de erro
+ *
+ * @details Faz duas passagens pelos vértices com o IteradorVizinhos, pelo que
+ * funciona tanto com arestas explícitas como implícitas:
+ * 1. Conta o grau de cada vértice e calcula offsets[] por soma acumulada
+ * 2. Preenche destinos[] pela ordem de iteração dos vizinhos
+ *
+ * O índice de cada vértice no CSR é o seu campo id. No fim, ordena o índice de
+ * posições (por_posicao) em O(n log n), uma só vez.
+ */
+GrafoCSR* grafo_congelar(const Grafo* grafo) {
+    if (!grafo) return NULL;
+
+    GrafoCSR* csr = (GrafoCSR*)calloc(1, sizeof(GrafoCSR));
+    if (!csr) return NULL;
+
+    int n = grafo->num_vertices;
+    csr->num_vertices = n;
+    csr->offsets = (size_t*)calloc((size_t)n + 1, sizeof(size_t));
+    csr->x = (int*)malloc((n ? n : 1) * sizeof(int));
+    csr->y = (int*)malloc((n ? n : 1) * sizeof(int));
+    csr->frequencia = (char*)malloc(n ? n : 1);
+    csr->por_posicao = (int*)malloc((n ? n : 1) * sizeof(int));
+    if (!csr->offsets || !csr->x || !csr->y || !csr->frequencia || !csr->por_posicao) {
+        destruir_grafo_csr(csr);
+        return NULL;
+    }
+
+    // 1. Graus e dados dos vértices
+    Vertice* v = grafo->vertices;
+    while (v != NULL) {
+        csr->x[v->id] = v->x;
+        csr->y[v->id] = v->y;
+        csr->frequencia[v->id] = v->frequencia;
+
+        IteradorVizinhos it;
+        iniciar_vizinhos(grafo, v, &it);
+        size_t grau = 0;
+        while (proximo_vizinho(&it) != NULL) grau++;
+        csr->offsets[v->id + 1] = grau;
+        v = v->proximo;
+    }
+
+    for (int i = 0; i < n; i++) {
+        csr->offsets[i + 1] += csr->offsets[i];
+    }
+    csr->num_arestas = csr->offsets[n];
+
+    // 2. Destinos
+    csr->destinos = (int*)malloc((csr->num_arestas ? csr->num_arestas : 1) * sizeof(int));
+    if (!csr->destinos) {
+        destruir_grafo_csr(csr);
+        return NULL;
+    }
+
+    v = grafo->vertices;
+    while (v != NULL) {
+        IteradorVizinhos it;
+        iniciar_vizinhos(grafo, v, &it);
+        size_t pos = csr->offsets[v->id];
+        Vertice* u;
+        while ((u = proximo_vizinho(&it)) != NULL) {
+            csr->destinos[pos++] = u->id;
+        }
+        v = v->proximo;
+    }
+
+    if (ordenar_posicoes(csr) != 0) {
+        destruir_grafo_csr(csr);
+        return NULL;
+    }
+    return csr;
+}
+
+/**
+ * @brief Liberta toda a memória associada a um grafo CSR
+ * @param csr Apontador para o grafo CSR a destruir
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int destruir_grafo_csr(GrafoCSR* csr) {
+    if (!csr) return -1;
+    free(csr->offsets);
+    free(csr->destinos);
+    free(csr->x);
+    free(csr->y);
+    free(csr->frequencia);
+    free(csr->por_posicao);
+    free(csr);
+    return 0;
+}
+
+/**
+ * @brief Encontra o índice de um vértice pelas suas coordenadas
+ * @param csr Apontador para o grafo CSR
+ * @param x Coordenada x (coluna) do vértice
+ * @param y Coordenada y (linha) do vértice
+ * @return Índice do vértice ou -1 se não existir
+ *
+ * @details Pesquisa binária em por_posicao, em O(log n). Se houver vários
+ * vértices na mesma posição devolve o de maior índice, o mesmo vértice que
+ * encontrar_vertice no grafo original.
+ */
+int csr_encontrar_vertice(const GrafoCSR* csr, int x, int y) {
+    if (!csr) return -1;
+
+    int baixo = 0, alto = csr->num_vertices;   // primeira posição depois de (y, x)
+    while (baixo < alto) {
+        int meio = baixo + (alto - baixo) / 2;
+        int v = csr->por_posicao[meio];
+        if (csr->y[v] > y || (csr->y[v] == y && csr->x[v] > x)) {
+            alto = meio;
+        } else {
+            baixo = meio + 1;
+        }
+    }
+    if (baixo == 0) return -1;
+    int v = csr->por_posicao[baixo - 1];
+    return (csr->x[v] == x && csr->y[v] == y) ? v : -1;
+}
+
+/**
+ * @brief Obtém o início das adjacências de um vértice numa vista CSR
+ * @param vista Adjacências
+ * @param v Índice do vértice (0 .. num_vertices)
+ */
+static size_t vista_inicio(const VistaCSR* vista, int v) {
+    return vista->offsets ? vista->offsets[v] : (size_t)vista->inicios32[v];
+}
+
+/**
+ * @brief Indica se um vértice já foi visitado
+ * @param visitados Vetor de bits, um por vértice
+ * @param v Índice do vértice
+ */
+static int bit_visitado(const uint64_t* visitados, int v) {
+    return (int)((visitados[(unsigned)v >> 6] >> (v & 63)) & 1u);
+}
+
+/**
+ * @brief Marca um vértice como visitado
+ * @param visitados Vetor de bits, um por vértice
+ * @param v Índice do vértice
+ */
+static void marcar_bit(uint64_t* visitados, int v) {
+    visitados[(unsigned)v >> 6] |= (uint64_t)1 << (v & 63);
+}
+
+/**
+ * @brief Obtém a vista das adjacências de um grafo CSR
+ * @param csr Apontador para o grafo CSR
+ * @param[out] vista Vista a preencher
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int csr_vista(const GrafoCSR* csr, VistaCSR* vista) {
+    if (!csr || !vista) return -1;
+    vista->num_vertices = csr->num_vertices;
+    vista->offsets = csr->offsets;
+    vista->inicios32 = NULL;
+    vista->destinos = csr->destinos;
+    return 0;
+}
+
+/**
+ * @brief Executa uma procura em profundidade sobre uma vista CSR
+ * @param vista Adjacências a percorrer
+ * @param inicio Índice do vértice de início
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 se a procura terminou, 1 se foi interrompida pela função de visita,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ *
+ * @details Usa uma pilha explícita com a posição seguinte nas adjacências de
+ * cada vértice, pelo que a ordem de visita é a da versão recursiva do grafo.
+ * As marcas de visita ocupam um bit por vértice e pertencem à procura, pelo que
+ * as adjacências nunca são alteradas.
+ */
+int csr_vista_profundidade(const VistaCSR* vista, int inicio, FuncaoVisitaCSR visita, void* dados) {
+    if (!vista || !visita || inicio < 0 || inicio >= vista->num_vertices) return -1;
+
+    int n = vista->num_vertices;
+    uint64_t* visitados = (uint64_t*)calloc(((size_t)n + 63) / 64, sizeof(uint64_t));
+    int* pilha = (int*)malloc(n * sizeof(int));
+    size_t* pos = (size_t*)malloc(n * sizeof(size_t));
+    if (!visitados || !pilha || !pos) {
+        free(visitados);
+        free(pilha);
+        free(pos);
+        return -2;
+    }
+
+    int resultado = 0;
+    int topo = -1;
+    marcar_bit(visitados, inicio);
+    if (visita(inicio, dados) != 0) {
+        resultado = 1;
+    } else {
+        topo = 0;
+        pilha[0] = inicio;
+        pos[0] = vista_inicio(vista, inicio);
+    }
+
+    while (resultado == 0 && topo >= 0) {
+        int v = pilha[topo];
+        if (pos[topo] == vista_inicio(vista, v + 1)) {
+            topo--;
+            continue;
+        }
+        int u = vista->destinos[pos[topo]++];
+        if (bit_visitado(visitados, u)) continue;
+
+        marcar_bit(visitados, u);
+        if (visita(u, dados) != 0) {
+            resultado = 1;
+        } else {
+            topo++;
+            pilha[topo] = u;
+            pos[topo] = vista_inicio(vista, u);
+        }
+    }
+
+    free(visitados);
+    free(pilha);
+    free(pos);
+    return resultado;
+}
+
+/**
+ * @brief Executa uma procura em largura sobre uma vista CSR
+ * @param vista Adjacências a percorrer
+ * @param inicio Índice do vértice de início
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 se a procura terminou, 1 se foi interrompida pela função de visita,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ *
+ * @details A fila é um vetor de num_vertices posições, já que cada vértice
+ * entra na fila no máximo uma vez; as marcas de visita ocupam um bit por vértice
+ */
+int csr_vista_largura(const VistaCSR* vista, int inicio, FuncaoVisitaCSR visita, void* dados) {
+    if (!vista || !visita || inicio < 0 || inicio >= vista->num_vertices) return -1;
+
+    int n = vista->num_vertices;
+    uint64_t* visitados = (uint64_t*)calloc(((size_t)n + 63) / 64, sizeof(uint64_t));
+    int* fila = (int*)malloc(n * sizeof(int));
+    if (!visitados || !fila) {
+        free(visitados);
+        free(fila);
+        return -2;
+    }
+
+    int resultado = 0;
+    int cabeca = 0, cauda = 0;
+    fila[cauda++] = inicio;
+    marcar_bit(visitados, inicio);
+
+    while (cabeca < cauda) {
+        int v = fila[cabeca++];
+        if (visita(v, dados) != 0) {
+            resultado = 1;
+            break;
+        }
+        size_t fim = vista_inicio(vista, v + 1);
+        for (size_t i = vista_inicio(vista, v); i < fim; i++) {
+            int u = vista->destinos[i];
+            if (!bit_visitado(visitados, u)) {
+                marcar_bit(visitados, u);
+                fila[cauda++] = u;
+            }
+        }
+    }
+
+    free(visitados);
+    free(fila);
+    return resultado;
+}
+
+/**
+ * @brief Imprime a visita de um vértice do grafo CSR
+ * @param v Índice do vértice visitado
+ * @param dados Apontador para o grafo CSR
+ * @return 0, para continuar a procura
+ */
+static int csr_imprimir_visita(int v, void* dados) {
+    const GrafoCSR* csr = (const GrafoCSR*)dados;
+    printf("Visitando: %c (%d,%d)\n", csr->frequencia[v], csr->x[v], csr->y[v]);
+    return 0;
+}
+
+/**
+ * @brief Executa uma procura em profundidade (DFS) sobre o grafo CSR
+ * @param csr Apontador para o grafo CSR
+ * @param inicio Índice do vértice de início
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ *
+ * @details csr_vista_profundidade com uma função que imprime cada visita
+ */
+int csr_procura_profundidade(const GrafoCSR* csr, int inicio) {
+    VistaCSR vista;
+    if (csr_vista(csr, &vista) != 0) return -1;
+    return csr_vista_profundidade(&vista, inicio, csr_imprimir_visita, (void*)csr);
+}
+
+/**
+ * @brief Executa uma procura em largura (BFS) sobre o grafo CSR
+ * @param csr Apontador para o grafo CSR
+ * @param inicio Índice do vértice de início
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ *
+ * @details csr_vista_largura com uma função que imprime cada visita
+ */
+int csr_procura_largura(const GrafoCSR* csr, int inicio) {
+    VistaCSR vista;
+    if (csr_vista(csr, &vista) != 0) return -1;
+    return csr_vista_largura(&vista, inicio, csr_imprimir_visita, (void*)csr);
+}
+
+/**
+ * @brief Imprime um caminho guardado como vetor de índices
+ * @param csr Apontador para o grafo CSR
+ * @param caminho Índices dos vértices do caminho, da origem para o fim
+ * @param comprimento Número de vértices no caminho
+ * @param ultimo Índice do último vértice, acrescentado no fim do caminho
+ */
+static void csr_imprimir_caminho(const GrafoCSR* csr, const int* caminho, int comprimento, int ultimo) {
+    for (int i = 0; i < comprimento; i++) {
+        int v = caminho[i];
+        printf("%c(%d,%d) ", csr->frequencia[v], csr->x[v], csr->y[v]);
+    }
+    printf("%c(%d,%d) ", csr->frequencia[ultimo], csr->x[ultimo], csr->y[ultimo]);
+}
+
+/**
+ * @brief Encontra e imprime todos os caminhos entre dois vértices do grafo CSR
+ * @param csr Apontador para o grafo CSR
+ * @param origem Índice do vértice de origem
+ * @param destino Índice do vértice de destino
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 se algum vértice não existir,
+ * -3 se as frequências forem diferentes, -4 em caso de erro de memória
+ *
+ * @details Backtracking com pilha explícita: caminho[] guarda os vértices do
+ * caminho atual e pos[] a próxima adjacência a experimentar em cada nível.
+ * Produz os mesmos caminhos, pela mesma ordem, que encontrar_caminhos.
+ */
+int csr_encontrar_caminhos(const GrafoCSR* csr, int origem, int destino) {
+    if (!csr) return -1;
+
+    int n = csr->num_vertices;
+    bool origem_existe = origem >= 0 && origem < n;
+    bool destino_existe = destino >= 0 && destino < n;
+    if (!origem_existe || !destino_existe) {
+        printf("\nNao foi possivel encontrar caminhos:\n");
+        if (!origem_existe && !destino_existe) {
+            printf("- Ambas as antenas nao existem no mapa\n");
+        } else if (!origem_existe) {
+            printf("- Antena de origem nao existe no mapa\n");
+        } else {
+            printf("- Antena de destino nao existe no mapa\n");
+        }
+        return -2;
+    }
+
+    if (csr->frequencia[origem] != csr->frequencia[destino]) {
+        printf("\nNao existem caminhos entre %c(%d,%d) e %c(%d,%d)\n",
+               csr->frequencia[origem], csr->x[origem], csr->y[origem],
+               csr->frequencia[destino], csr->x[destino], csr->y[destino]);
+        printf("- As antenas tem frequencias diferentes (%c e %c)\n",
+               csr->frequencia[origem], csr->frequencia[destino]);
+        return -3;
+    }
+
+    printf("\n=== Caminhos entre %c(%d,%d) e %c(%d,%d) ===\n",
+           csr->frequencia[origem], csr->x[origem], csr->y[origem],
+           csr->frequencia[destino], csr->x[destino], csr->y[destino]);
+
+    int contador = 0;
+    if (origem == destino) {
+        contador = 1;
+        printf("Caminho %d: ", contador);
+        csr_imprimir_caminho(csr, NULL, 0, origem);
+        printf("\n");
+    } else {
+        unsigned char* no_caminho = (unsigned char*)calloc(n, 1);
+        int* caminho = (int*)malloc(n * sizeof(int));
+        size_t* pos = (size_t*)malloc(n * sizeof(size_t));
+        if (!no_caminho || !caminho || !pos) {
+            free(no_caminho);
+            free(caminho);
+            free(pos);
+            return -4;
+        }
+
+        int prof = 0;
+        caminho[0] = origem;
+        pos[0] = csr->offsets[origem];
+        no_caminho[origem] = 1;
+
+        while (prof >= 0) {
+            int v = caminho[prof];
+            if (pos[prof] == csr->offsets[v + 1]) {
+                no_caminho[v] = 0;
+                prof--;
+                continue;
+            }
+            int u = csr->destinos[pos[prof]++];
+            if (no_caminho[u]) continue;
+
+            if (u == destino) {
+                contador++;
+                printf("Caminho %d: ", contador);
+                csr_imprimir_caminho(csr, caminho, prof + 1, u);
+                printf("\n");
+            } else {
+                prof++;
+                caminho[prof] = u;
+                pos[prof] = csr->offsets[u];
+                no_caminho[u] = 1;
+            }
+        }
+
+        free(no_caminho);
+        free(caminho);
+        free(pos);
+    }
+
+    if (contador == 0) {
+        printf("Nenhum caminho encontrado entre as antenas\n");
+    } else {
+        printf("Total de caminhos encontrados: %d\n", contador);
+    }
+    return 0;
+}
+
+/**
+ * @brief Estado partilhado pelos fios de execução de csr_componentes
+ */
+typedef struct {
+    const GrafoCSR* csr;        ///< Grafo a analisar
+    atomic_int* pai;            ///< Floresta do union-find (pai[v] == v nas raízes)
+    int por_fatia;              ///< Vértices por bloco
+    int num_fatias;             ///< Número de blocos
+    atomic_int proxima;         ///< Próximo bloco por tratar
+} TrabalhoComponentes;
+
+/**
+ * @brief Encontra a raiz do conjunto de um vértice, encurtando o caminho pelo meio
+ * @param pai Floresta do union-find
+ * @param v Vértice
+ * @return Raiz do conjunto de v
+ * 
+ * @details Cada vértice passa a apontar para o avô quando este é diferente do pai
+ * (path halving). A troca é feita com compare-and-swap e só encurta caminhos,
+ * pelo que é segura com outros fios a alterar a floresta ao mesmo tempo.
+ */
+static int uf_raiz(atomic_int* pai, int v) {
+    while (1) {
+        int p = atomic_load_explicit(&pai[v], memory_order_relaxed);
+        if (p == v) return v;
+        int avo = atomic_load_explicit(&pai[p], memory_order_relaxed);
+        if (avo != p) atomic_compare_exchange_weak_explicit(&pai[v], &p, avo, memory_order_relaxed, memory_order_relaxed);
+        v = avo;
+    }
+}
+
+/**
+ * @brief Junta os conjuntos de dois vértices
+ * @param pai Floresta do union-find
+ * @param a Primeiro vértice
+ * @param b Segundo vértice
+ * 
+ * @details A raiz de maior índice passa a apontar para a de menor índice, o que
+ * impede ciclos entre fios. A ligação só é feita se a raiz ainda o for
+ * (compare-and-swap); caso contrário, as raízes são procuradas outra vez.
+ */
+static void uf_unir(atomic_int* pai, int a, int b) {
+    while (1) {
+        a = uf_raiz(pai, a);
+        b = uf_raiz(pai, b);
+        if (a == b) return;
+        if (a < b) {
+            int t = a;
+            a = b;
+            b = t;
+        }
+        int esperado = a;
+        if (atomic_compare_exchange_strong_explicit(&pai[a], &esperado, b, memory_order_relaxed, memory_order_relaxed)) return;
+    }
+}
+
+/**
+ * @brief Corpo de cada fio de execução: une as arestas dos blocos de vértices que obtiver
+ * @param arg Apontador para o TrabalhoComponentes partilhado
+ * @return NULL
+ */
+static void* trabalhar_componentes(void* arg) {
+    TrabalhoComponentes* t = (TrabalhoComponentes*)arg;
+    const GrafoCSR* csr = t->csr;
+    
+    while (1) {
+        int k = atomic_fetch_add(&t->proxima, 1);
+        if (k >= t->num_fatias) break;
+        int fim = (k + 1) * t->por_fatia < csr->num_vertices ? (k + 1) * t->por_fatia : csr->num_vertices;
+        for (int v = k * t->por_fatia; v < fim; v++) {
+            for (size_t i = csr->offsets[v]; i < csr->offsets[v + 1]; i++) {
+                int u = csr->destinos[i];
+                if (u < v) uf_unir(t->pai, v, u);   // cada ligação aparece nos dois sentidos
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Identifica as componentes ligadas do grafo CSR
+ * @param csr Apontador para o grafo CSR
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @param[out] componente Vetor alocado com a componente de cada vértice (libertar com free)
+ * @param[out] tamanhos Vetor alocado com o número de vértices de cada componente (libertar com free)
+ * @param[out] num_componentes Número de componentes
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Union-find concorrente sobre as arestas do CSR, sem reiniciar marcas
+ * de visita nem fazer uma procura por componente:
+ * 1. Os vértices são divididos em blocos, que os fios vão obtendo de um contador
+ *    atómico; cada fio une as extremidades das arestas dos seus blocos
+ * 2. Percorrem-se os vértices por ordem e numeram-se as raízes, pelo que as
+ *    componentes ficam numeradas pela ordem do seu vértice de menor índice
+ * 
+ * O resultado não depende do número de fios.
+ */
+int csr_componentes(const GrafoCSR* csr, int num_fios, int** componente, int** tamanhos, int* num_componentes) {
+    if (!csr || !componente || !tamanhos || !num_componentes || num_fios < 0) return -1;
+    *componente = NULL;
+    *tamanhos = NULL;
+    *num_componentes = 0;
+    
+    int n = csr->num_vertices;
+    atomic_int* pai = (atomic_int*)malloc((n ? n : 1) * sizeof(atomic_int));
+    int* comp = (int*)malloc((n ? n : 1) * sizeof(int));
+    if (!pai || !comp) {
+        free(pai);
+        free(comp);
+        return -2;
+    }
+    for (int v = 0; v < n; v++) atomic_init(&pai[v], v);
+    
+    // 1. Uniões em paralelo
+    if (num_fios == 0) num_fios = numero_processadores();
+    if (num_fios > n) num_fios = n > 0 ? n : 1;
+    
+    TrabalhoComponentes t;
+    t.csr = csr;
+    t.pai = pai;
+    t.num_fatias = num_fios == 1 ? 1 : (n < 8 * num_fios ? n : 8 * num_fios);
+    t.por_fatia = n > 0 ? (n + t.num_fatias - 1) / t.num_fatias : 0;
+    atomic_init(&t.proxima, 0);
+    
+    pthread_t* fios = num_fios > 1 ? (pthread_t*)malloc((num_fios - 1) * sizeof(pthread_t)) : NULL;
+    int criados = 0;
+    for (int f = 0; fios && f < num_fios - 1; f++) {
+        if (pthread_create(&fios[criados], NULL, trabalhar_componentes, &t) != 0) break;
+        criados++;
+    }
+    trabalhar_componentes(&t);
+    for (int f = 0; f < criados; f++) pthread_join(fios[f], NULL);
+    free(fios);
+    
+    // 2. Numeração das componentes; a raiz é sempre o vértice de menor índice
+    int num = 0;
+    for (int v = 0; v < n; v++) {
+        int r = uf_raiz(pai, v);
+        comp[v] = r == v ? num++ : comp[r];
+    }
+    free(pai);
+    
+    int* tam = (int*)calloc(num ? num : 1, sizeof(int));
+    if (!tam) {
+        free(comp);
+        return -2;
+    }
+    for (int v = 0; v < n; v++) tam[comp[v]]++;
+    
+    *componente = comp;
+    *tamanhos = tam;
+    *num_componentes = num;
+    return 0;
+}
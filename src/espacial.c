@@ -0,0 +1,369 @@
+/**
+ * @file espacial.c
+ * @brief Implementação do índice espacial em grelha uniforme
+ *
+ * @details Implementa as funções declaradas em espacial.h. A grelha é
+ * construída por contagem, como o índice de segmentos de intersecao.c: uma
+ * passagem conta os pontos de cada célula e a seguinte coloca-os, pelo que a
+ * construção é O(n + células) e os pontos de cada célula ficam pela ordem
+ * original. O lado das células é escolhido para que cada uma tenha em média
+ * PONTOS_POR_CELULA pontos.
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "espacial.h"
+
+/**
+ * @brief Raiz quadrada inteira arredondada para cima
+ * @param n Valor
+ * @return Menor r tal que r * r >= n
+ */
+static long long raiz_acima(long long n) {
+    long long r = 1;
+    while (r * r < n) r *= 2;
+    long long lo = r / 2, hi = r;   // lo*lo < n <= hi*hi (para n > 1)
+    while (hi - lo > 1) {
+        long long meio = lo + (hi - lo) / 2;
+        if (meio * meio >= n) hi = meio; else lo = meio;
+    }
+    return n <= 1 ? 1 : hi;
+}
+
+/**
+ * @brief Quadrado de uma diferença de coordenadas, sem transbordo
+ * @param d Diferença (|d| < 2^31)
+ * @return d * d
+ */
+static unsigned long long quadrado(long long d) {
+    unsigned long long a = (unsigned long long)(d < 0 ? -d : d);
+    return a * a;
+}
+
+/**
+ * @brief Prepara uma grelha vazia e inválida
+ * @param grelha Grelha a inicializar
+ */
+void grelha_pontos_iniciar(GrelhaPontos* grelha) {
+    if (!grelha) return;
+    memset(grelha, 0, sizeof(GrelhaPontos));
+}
+
+/**
+ * @brief Liberta a memória de uma grelha, que fica vazia e inválida
+ * @param grelha Grelha a libertar
+ */
+void grelha_pontos_libertar(GrelhaPontos* grelha) {
+    if (!grelha) return;
+    free(grelha->inicio);
+    free(grelha->indices);
+    free(grelha->px);
+    free(grelha->py);
+    grelha_pontos_iniciar(grelha);
+}
+
+/**
+ * @brief Constrói a grelha de um conjunto de pontos, substituindo o conteúdo anterior
+ * @param grelha Grelha (já inicializada)
+ * @param x Coordenada x de cada ponto
+ * @param y Coordenada y de cada ponto
+ * @param num Número de pontos
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ *
+ * @details O lado é a raiz de (área da caixa / (num / PONTOS_POR_CELULA)),
+ * duplicado enquanto uma caixa muito alongada der mais de 4 células por
+ * célula pretendida, pelo que a memória é sempre O(num). Depois de sucesso a
+ * grelha fica válida.
+ */
+int grelha_pontos_construir(GrelhaPontos* grelha, const int* x, const int* y, int num) {
+    if (!grelha || num < 0 || (num > 0 && (!x || !y))) return -1;
+    grelha_pontos_libertar(grelha);
+    if (num == 0) {
+        grelha->valida = true;
+        return 0;
+    }
+
+    int min_x = x[0], max_x = x[0], min_y = y[0], max_y = y[0];
+    for (int i = 1; i < num; i++) {
+        if (x[i] < min_x) min_x = x[i];
+        if (x[i] > max_x) max_x = x[i];
+        if (y[i] < min_y) min_y = y[i];
+        if (y[i] > max_y) max_y = y[i];
+    }
+    long long largura = (long long)max_x - min_x + 1;
+    long long altura = (long long)max_y - min_y + 1;
+    long long pretendidas = num / PONTOS_POR_CELULA > 0 ? num / PONTOS_POR_CELULA : 1;
+    long long area = largura * altura;
+    long long lado = raiz_acima(area / pretendidas + (area % pretendidas != 0));
+    long long colunas = (largura + lado - 1) / lado;
+    long long linhas = (altura + lado - 1) / lado;
+    while (colunas * linhas > 4 * pretendidas + 16) {
+        lado *= 2;
+        colunas = (largura + lado - 1) / lado;
+        linhas = (altura + lado - 1) / lado;
+    }
+
+    size_t celulas = (size_t)(colunas * linhas);
+    grelha->inicio = (int*)calloc(celulas + 1, sizeof(int));
+    grelha->indices = (int*)malloc((size_t)num * sizeof(int));
+    grelha->px = (int*)malloc((size_t)num * sizeof(int));
+    grelha->py = (int*)malloc((size_t)num * sizeof(int));
+    if (!grelha->inicio || !grelha->indices || !grelha->px || !grelha->py) {
+        grelha_pontos_libertar(grelha);
+        return -2;
+    }
+    grelha->num = num;
+    grelha->min_x = min_x;
+    grelha->min_y = min_y;
+    grelha->max_x = max_x;
+    grelha->max_y = max_y;
+    grelha->lado = (int)lado;
+    grelha->colunas = (int)colunas;
+    grelha->linhas = (int)linhas;
+
+    // Contagem por célula; inicio[c] fica com o fim da célula c
+    for (int i = 0; i < num; i++) {
+        size_t c = (size_t)(((long long)y[i] - min_y) / lado * colunas + ((long long)x[i] - min_x) / lado);
+        grelha->inicio[c]++;
+    }
+    for (size_t c = 1; c < celulas; c++) grelha->inicio[c] += grelha->inicio[c - 1];
+
+    // Colocação do fim para o início, para manter a ordem original em cada célula
+    for (int i = num - 1; i >= 0; i--) {
+        size_t c = (size_t)(((long long)y[i] - min_y) / lado * colunas + ((long long)x[i] - min_x) / lado);
+        int p = --grelha->inicio[c];
+        grelha->indices[p] = i;
+        grelha->px[p] = x[i];
+        grelha->py[p] = y[i];
+    }
+    grelha->inicio[celulas] = num;
+    grelha->valida = true;
+    return 0;
+}
+
+/**
+ * @brief Converte uma coordenada na coluna ou linha da grelha, limitada às células existentes
+ * @param valor Coordenada
+ * @param minimo Início da grelha nesse eixo
+ * @param lado Lado das células
+ * @param num Número de células nesse eixo
+ * @return Coluna ou linha entre 0 e num - 1
+ */
+static int celula_limitada(long long valor, int minimo, int lado, int num) {
+    if (valor < minimo) return 0;
+    long long c = (valor - minimo) / lado;
+    return c >= num ? num - 1 : (int)c;
+}
+
+/**
+ * @brief Enumera os pontos dentro de um retângulo
+ * @param grelha Grelha construída
+ * @param x0 Coordenada x de um canto
+ * @param y0 Coordenada y de um canto
+ * @param x1 Coordenada x do canto oposto (inclusive)
+ * @param y1 Coordenada y do canto oposto (inclusive)
+ * @param visita Função chamada para cada ponto
+ * @param dados Apontador passado a cada chamada de visita
+ * @return Número de pontos passados a visita, ou -1 em caso de erro
+ *
+ * @details Só as células que tocam no retângulo são percorridas, linha a
+ * linha; os pontos são passados a visita por essa ordem
+ */
+int grelha_pontos_retangulo(const GrelhaPontos* grelha, int x0, int y0, int x1, int y1,
+                            FuncaoPonto visita, void* dados) {
+    if (!grelha || !visita) return -1;
+    if (x0 > x1) { int t = x0; x0 = x1; x1 = t; }
+    if (y0 > y1) { int t = y0; y0 = y1; y1 = t; }
+    if (grelha->num == 0 || x1 < grelha->min_x || x0 > grelha->max_x ||
+        y1 < grelha->min_y || y0 > grelha->max_y) {
+        return 0;
+    }
+
+    int c0 = celula_limitada(x0, grelha->min_x, grelha->lado, grelha->colunas);
+    int c1 = celula_limitada(x1, grelha->min_x, grelha->lado, grelha->colunas);
+    int l0 = celula_limitada(y0, grelha->min_y, grelha->lado, grelha->linhas);
+    int l1 = celula_limitada(y1, grelha->min_y, grelha->lado, grelha->linhas);
+
+    int total = 0;
+    for (int l = l0; l <= l1; l++) {
+        for (int c = c0; c <= c1; c++) {
+            size_t celula = (size_t)l * grelha->colunas + c;
+            for (int p = grelha->inicio[celula]; p < grelha->inicio[celula + 1]; p++) {
+                int px = grelha->px[p], py = grelha->py[p];
+                if (px < x0 || px > x1 || py < y0 || py > y1) continue;
+                total++;
+                if (visita(grelha->indices[p], px, py, dados) != 0) return total;
+            }
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Enumera os pontos a uma distância não superior a raio de uma posição
+ * @param grelha Grelha construída
+ * @param x Coordenada x do centro
+ * @param y Coordenada y do centro
+ * @param raio Raio do círculo (inclusive)
+ * @param visita Função chamada para cada ponto
+ * @param dados Apontador passado a cada chamada de visita
+ * @return Número de pontos passados a visita, ou -1 em caso de erro
+ *
+ * @details Percorre as células do quadrado que envolve o círculo e compara o
+ * quadrado da distância de cada ponto com raio * raio
+ */
+int grelha_pontos_raio(const GrelhaPontos* grelha, int x, int y, int raio, FuncaoPonto visita, void* dados) {
+    if (!grelha || !visita || raio < 0) return -1;
+    if (grelha->num == 0 ||
+        (long long)x + raio < grelha->min_x || (long long)x - raio > grelha->max_x ||
+        (long long)y + raio < grelha->min_y || (long long)y - raio > grelha->max_y) {
+        return 0;
+    }
+
+    int c0 = celula_limitada((long long)x - raio, grelha->min_x, grelha->lado, grelha->colunas);
+    int c1 = celula_limitada((long long)x + raio, grelha->min_x, grelha->lado, grelha->colunas);
+    int l0 = celula_limitada((long long)y - raio, grelha->min_y, grelha->lado, grelha->linhas);
+    int l1 = celula_limitada((long long)y + raio, grelha->min_y, grelha->lado, grelha->linhas);
+    unsigned long long limite = quadrado(raio);
+
+    int total = 0;
+    for (int l = l0; l <= l1; l++) {
+        for (int c = c0; c <= c1; c++) {
+            size_t celula = (size_t)l * grelha->colunas + c;
+            for (int p = grelha->inicio[celula]; p < grelha->inicio[celula + 1]; p++) {
+                int px = grelha->px[p], py = grelha->py[p];
+                if (quadrado((long long)px - x) + quadrado((long long)py - y) > limite) continue;
+                total++;
+                if (visita(grelha->indices[p], px, py, dados) != 0) return total;
+            }
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Indica se (d1, i1) vem antes de (d2, i2): menor distância e, em caso de empate, menor índice
+ */
+static bool antes(unsigned long long d1, int i1, unsigned long long d2, int i2) {
+    return d1 < d2 || (d1 == d2 && i1 < i2);
+}
+
+/**
+ * @brief Insere um ponto na lista ordenada dos melhores, se lá couber
+ * @param indices Índices dos melhores pontos, por ordem
+ * @param distancias Distâncias dos melhores pontos, por ordem
+ * @param[in,out] num Número de pontos na lista
+ * @param k Tamanho máximo da lista
+ * @param indice Índice do ponto
+ * @param distancia Quadrado da distância do ponto
+ */
+static void inserir_melhor(int* indices, unsigned long long* distancias, int* num, int k,
+                           int indice, unsigned long long distancia) {
+    if (*num == k && !antes(distancia, indice, distancias[k - 1], indices[k - 1])) return;
+    int i = *num < k ? (*num)++ : k - 1;
+    while (i > 0 && antes(distancia, indice, distancias[i - 1], indices[i - 1])) {
+        distancias[i] = distancias[i - 1];
+        indices[i] = indices[i - 1];
+        i--;
+    }
+    distancias[i] = distancia;
+    indices[i] = indice;
+}
+
+/**
+ * @brief Quadrado da distância de uma posição ao retângulo de uma célula
+ * @param grelha Grelha
+ * @param c Coluna da célula
+ * @param l Linha da célula
+ * @param x Coordenada x da posição
+ * @param y Coordenada y da posição
+ * @return Quadrado da menor distância a um ponto da célula (0 se a posição estiver dentro)
+ */
+static unsigned long long distancia_celula(const GrelhaPontos* grelha, int c, int l, int x, int y) {
+    long long xs = grelha->min_x + (long long)c * grelha->lado, xe = xs + grelha->lado - 1;
+    long long ys = grelha->min_y + (long long)l * grelha->lado, ye = ys + grelha->lado - 1;
+    long long dx = x < xs ? xs - x : x > xe ? x - xe : 0;
+    long long dy = y < ys ? ys - y : y > ye ? y - ye : 0;
+    return quadrado(dx) + quadrado(dy);
+}
+
+/**
+ * @brief Encontra os k pontos mais próximos de uma posição
+ * @param grelha Grelha construída
+ * @param x Coordenada x da posição
+ * @param y Coordenada y da posição
+ * @param k Número de pontos pretendido
+ * @param[out] indices Posição dos pontos no vetor original (k entradas), do mais próximo para o mais afastado
+ * @param[out] distancias Quadrado da distância de cada ponto (k entradas, pode ser NULL)
+ * @return Número de pontos encontrados (o menor entre k e num), ou -1 em caso de erro
+ *
+ * @details Percorre anéis de células cada vez mais largos à volta da célula
+ * da posição (ou da mais próxima, se a posição estiver fora da grelha),
+ * saltando as células mais afastadas do que o pior dos k já encontrados. Pára
+ * quando esse pior está mais perto do que qualquer célula fora dos anéis já
+ * percorridos. Os empates de distância são resolvidos pelo menor índice, pelo
+ * que o resultado é igual ao de percorrer todos os pontos.
+ */
+int grelha_pontos_proximos(const GrelhaPontos* grelha, int x, int y, int k,
+                           int* indices, unsigned long long* distancias) {
+    if (!grelha || !indices || k < 0) return -1;
+    if (k == 0 || grelha->num == 0) return 0;
+
+    unsigned long long* d = distancias;
+    if (!d) {
+        d = (unsigned long long*)malloc((size_t)k * sizeof(unsigned long long));
+        if (!d) return -1;
+    }
+
+    int c0 = celula_limitada(x, grelha->min_x, grelha->lado, grelha->colunas);
+    int l0 = celula_limitada(y, grelha->min_y, grelha->lado, grelha->linhas);
+    int num = 0;
+
+    for (int r = 0; ; r++) {
+        for (int l = l0 - r; l <= l0 + r; l++) {
+            if (l < 0 || l >= grelha->linhas) continue;
+            bool borda = l == l0 - r || l == l0 + r;
+            int passo = borda || r == 0 ? 1 : 2 * r;
+            for (int c = c0 - r; c <= c0 + r; c += passo) {
+                if (c < 0 || c >= grelha->colunas) continue;
+                if (num == k && distancia_celula(grelha, c, l, x, y) > d[k - 1]) continue;
+                size_t celula = (size_t)l * grelha->colunas + c;
+                for (int p = grelha->inicio[celula]; p < grelha->inicio[celula + 1]; p++) {
+                    unsigned long long dist = quadrado((long long)grelha->px[p] - x) +
+                                              quadrado((long long)grelha->py[p] - y);
+                    inserir_melhor(indices, d, &num, k, grelha->indices[p], dist);
+                }
+            }
+        }
+
+        // Menor distância possível a um ponto fora do quadrado de anéis já percorrido
+        bool esquerda = c0 - r > 0, direita = c0 + r < grelha->colunas - 1;
+        bool cima = l0 - r > 0, baixo = l0 + r < grelha->linhas - 1;
+        if (!esquerda && !direita && !cima && !baixo) break;
+        long long folga = -1;
+        long long lados[4] = {
+            esquerda ? (long long)x - (grelha->min_x + (long long)(c0 - r) * grelha->lado) + 1 : -1,
+            direita ? grelha->min_x + (long long)(c0 + r + 1) * grelha->lado - x : -1,
+            cima ? (long long)y - (grelha->min_y + (long long)(l0 - r) * grelha->lado) + 1 : -1,
+            baixo ? grelha->min_y + (long long)(l0 + r + 1) * grelha->lado - y : -1
+        };
+        for (int s = 0; s < 4; s++) {
+            if (lados[s] < 0) continue;
+            long long g = lados[s] > 0 ? lados[s] : 0;
+            if (folga < 0 || g < folga) folga = g;
+        }
+        if (num == k && d[k - 1] < quadrado(folga)) break;
+    }
+
+    if (!distancias) free(d);
+    return num;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file estatisticas.c
+ * @brief Implementação do relógio monótono e da escrita das estatísticas
+ *
+ * @details Implementa as funções declaradas em estatisticas.h. O relógio usa
+ * QueryPerformanceCounter no Windows e clock_gettime(CLOCK_MONOTONIC) nos
+ * restantes sistemas, pelo que não é afetado por acertos da hora do sistema.
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#include <stdio.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#include "estatisticas.h"
+
+/**
+ * @brief Nomes das fases no JSON, pela ordem de FaseEstatisticas
+ */
+static const char* const NOMES_FASES[NUM_FASES] = {
+    "carregamento",
+    "ligacao",
+    "procura_profundidade",
+    "procura_largura",
+    "caminhos",
+    "caminho_mais_curto",
+    "recolha_segmentos",
+    "detecao_intersecoes"
+};
+
+/**
+ * @brief Lê o relógio monótono do sistema
+ * @return Instante atual em nanossegundos, a partir de uma origem arbitrária
+ */
+unsigned long long relogio_monotono_ns(void) {
+#ifdef _WIN32
+    LARGE_INTEGER frequencia, contador;
+    QueryPerformanceFrequency(&frequencia);
+    QueryPerformanceCounter(&contador);
+    unsigned long long segundos = (unsigned long long)contador.QuadPart / (unsigned long long)frequencia.QuadPart;
+    unsigned long long resto = (unsigned long long)contador.QuadPart % (unsigned long long)frequencia.QuadPart;
+    return segundos * 1000000000ull + resto * 1000000000ull / (unsigned long long)frequencia.QuadPart;
+#else
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (unsigned long long)t.tv_sec * 1000000000ull + (unsigned long long)t.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Indica se a biblioteca foi compilada com as estatísticas ativas
+ * @return true se EDA_ESTATISTICAS estava definido
+ */
+bool estatisticas_ativas(void) {
+#ifdef EDA_ESTATISTICAS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Põe todos os contadores e tempos a 0
+ * @param estatisticas Estatísticas a limpar
+ */
+void estatisticas_limpar(EstatisticasGrafo* estatisticas) {
+    if (!estatisticas) return;
+    memset(estatisticas, 0, sizeof(EstatisticasGrafo));
+}
+
+/**
+ * @brief Acumula uma execução de uma fase
+ * @param estatisticas Estatísticas a atualizar
+ * @param fase Fase executada
+ * @param tempo_ns Duração da execução, em nanossegundos
+ */
+void estatisticas_registar_fase(EstatisticasGrafo* estatisticas, FaseEstatisticas fase, unsigned long long tempo_ns) {
+    if (!estatisticas || (int)fase < 0 || (int)fase >= NUM_FASES) return;
+    estatisticas->execucoes[fase]++;
+    estatisticas->tempo_ns[fase] += tempo_ns;
+}
+
+/**
+ * @brief Junta umas estatísticas a outras
+ * @param destino Estatísticas a que se soma
+ * @param origem Estatísticas a somar
+ *
+ * @details Os contadores e os tempos são somados; as profundidades ficam com o
+ * maior dos dois valores. Serve para juntar as estatísticas de vários contextos
+ * de procura, um por fio de execução.
+ */
+void estatisticas_juntar(EstatisticasGrafo* destino, const EstatisticasGrafo* origem) {
+    if (!destino || !origem) return;
+    destino->vertices_criados += origem->vertices_criados;
+    destino->arestas_criadas += origem->arestas_criadas;
+    destino->verificacoes_duplicados += origem->verificacoes_duplicados;
+    destino->enfileirados += origem->enfileirados;
+    if (origem->profundidade_procura > destino->profundidade_procura) {
+        destino->profundidade_procura = origem->profundidade_procura;
+    }
+    if (origem->profundidade_caminhos > destino->profundidade_caminhos) {
+        destino->profundidade_caminhos = origem->profundidade_caminhos;
+    }
+    destino->intersecoes.testes_segmentos += origem->intersecoes.testes_segmentos;
+    destino->intersecoes.sondagens_pontos += origem->intersecoes.sondagens_pontos;
+    for (int fase = 0; fase < NUM_FASES; fase++) {
+        destino->execucoes[fase] += origem->execucoes[fase];
+        destino->tempo_ns[fase] += origem->tempo_ns[fase];
+    }
+}
+
+/**
+ * @brief Obtém o nome de uma fase, tal como aparece no JSON
+ * @param fase Fase
+ * @return Nome da fase, ou "desconhecida"
+ */
+const char* nome_fase(FaseEstatisticas fase) {
+    if ((int)fase < 0 || (int)fase >= NUM_FASES) return "desconhecida";
+    return NOMES_FASES[fase];
+}
+
+/**
+ * @brief Escreve as estatísticas num objeto JSON
+ * @param estatisticas Estatísticas a escrever
+ * @param f Ficheiro de saída
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ *
+ * @details O campo "ativas" indica se os valores foram de facto recolhidos;
+ * sem EDA_ESTATISTICAS todos os contadores vêm a 0
+ */
+int escrever_estatisticas_json(const EstatisticasGrafo* estatisticas, FILE* f) {
+    if (!estatisticas || !f) return -1;
+
+    fprintf(f, "{\n");
+    fprintf(f, "  \"ativas\": %s,\n", estatisticas_ativas() ? "true" : "false");
+    fprintf(f, "  \"vertices_criados\": %llu,\n", estatisticas->vertices_criados);
+    fprintf(f, "  \"arestas_criadas\": %llu,\n", estatisticas->arestas_criadas);
+    fprintf(f, "  \"verificacoes_duplicados\": %llu,\n", estatisticas->verificacoes_duplicados);
+    fprintf(f, "  \"enfileirados\": %llu,\n", estatisticas->enfileirados);
+    fprintf(f, "  \"profundidade_procura\": %llu,\n", estatisticas->profundidade_procura);
+    fprintf(f, "  \"profundidade_caminhos\": %llu,\n", estatisticas->profundidade_caminhos);
+    fprintf(f, "  \"testes_segmentos\": %llu,\n", estatisticas->intersecoes.testes_segmentos);
+    fprintf(f, "  \"sondagens_pontos\": %llu,\n", estatisticas->intersecoes.sondagens_pontos);
+    fprintf(f, "  \"fases\": {\n");
+    for (int fase = 0; fase < NUM_FASES; fase++) {
+        fprintf(f, "    \"%s\": { \"execucoes\": %llu, \"tempo_ns\": %llu }%s\n",
+                NOMES_FASES[fase], estatisticas->execucoes[fase], estatisticas->tempo_ns[fase],
+                fase + 1 < NUM_FASES ? "," : "");
+    }
+    fprintf(f, "  }\n");
+    fprintf(f, "}\n");
+
+    return ferror(f) ? -1 : 0;
+}
@@ -8,6 +8,8 @@
  * - Algoritmos de procura (DFS e BFS)
  * - Cálculo de caminhos entre vértices
  * - Deteção de intersecções entre frequências
+ * - Alterações incrementais (adicionar, remover e mover antenas)
+ * - Inserção de antenas em lote e ligação das frequências repartidas por vários fios
  * 
  * @author Diogo Pereira
  * @date 18 Maio 2025
@@ -21,496 +23,2865 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
 #include "grafo.h"
+#include "intersecao.h"
 
-static int contador_caminhos; ///< Contador auxiliar para número de caminhos encontrados
+/**
+ * @brief Indica se um vértice já foi visitado na procura atual
+ * @param ctx Contexto da procura
+ * @param v Vértice a verificar
+ */
+static bool foi_visitado(const ContextoProcura* ctx, const Vertice* v) {
+    return ctx->marcas[v->id] == ctx->epoca;
+}
 
 /**
- * @brief Cria um novo grafo vazio
- * @return Apontador para o grafo criado ou NULL em caso de erro
+ * @brief Marca um vértice como visitado na procura atual
+ * @param ctx Contexto da procura
+ * @param v Vértice a marcar
+ */
+static void marcar_visitado(ContextoProcura* ctx, const Vertice* v) {
+    ctx->marcas[v->id] = ctx->epoca;
+}
+
+/**
+ * @brief Retira a marca de visita de um vértice (usado no backtracking)
+ * @param ctx Contexto da procura
+ * @param v Vértice a desmarcar
  * 
- * @details Aloca memória para a estrutura do grafo e inicializa:
- * - Lista de vértices como NULL
- * - Contador de vértices como 0
+ * @details A época 0 nunca é usada por uma procura, por isso nunca coincide
  */
-Grafo* criar_grafo() {
-    Grafo* grafo = (Grafo*)malloc(sizeof(Grafo));
-    grafo->vertices = NULL;
-    grafo->num_vertices = 0;
-    return grafo;
+static void desmarcar_visitado(ContextoProcura* ctx, const Vertice* v) {
+    ctx->marcas[v->id] = 0;
 }
 
 /**
- * @brief Liberta toda a memória associada ao grafo
- * @param grafo Apontador para o grafo a destruir
- * @return 0 em caso de sucesso, -1 em caso de erro
+ * @brief Avança a época de um contexto, limpando as marcas quando o contador dá a volta
+ * @param ctx Contexto da procura
+ */
+static void avancar_epoca(ContextoProcura* ctx) {
+    ctx->epoca++;
+    if (ctx->epoca == 0) {
+        if (ctx->marcas) memset(ctx->marcas, 0, ctx->cap_marcas * sizeof(unsigned int));
+        ctx->epoca = 1;
+    }
+}
+
+/**
+ * @brief Prepara um contexto para uma nova procura no grafo
+ * @param ctx Contexto da procura
+ * @param grafo Grafo a percorrer (só lido)
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
  * 
- * @details Percorre e liberta:
- * - Todos os vértices (antenas)
- * - Todas as arestas (conexões)
- * - A própria estrutura do grafo
+ * @details Garante uma marca e um anterior por vértice do grafo (as marcas novas
+ * começam a 0, que nenhuma época usa) e avança a época, o que apaga as marcas antigas em O(1)
  */
-int destruir_grafo(Grafo* grafo) {
-    if (!grafo) return -1;
-    
-    Vertice* v = grafo->vertices;
-    while (v != NULL) {
-        Vertice* temp_v = v;
-        v = v->proximo;
-        
-        Aresta* a = temp_v->arestas;
-        while (a != NULL) {
-            Aresta* temp_a = a;
-            a = a->proxima;
-            free(temp_a);
-        }
-        
-        free(temp_v);
+static int contexto_preparar(ContextoProcura* ctx, const Grafo* grafo) {
+    if (ctx->cap_marcas < grafo->num_vertices) {
+        int nova_cap = ctx->cap_marcas ? ctx->cap_marcas : 64;
+        while (nova_cap < grafo->num_vertices) nova_cap *= 2;
+        unsigned int* novas = (unsigned int*)realloc(ctx->marcas, nova_cap * sizeof(unsigned int));
+        if (!novas) return -1;
+        memset(novas + ctx->cap_marcas, 0, (nova_cap - ctx->cap_marcas) * sizeof(unsigned int));
+        ctx->marcas = novas;
+        Vertice** novos = (Vertice**)realloc(ctx->anteriores, nova_cap * sizeof(Vertice*));
+        if (!novos) return -1;
+        ctx->anteriores = novos;
+        ctx->cap_marcas = nova_cap;
     }
-    free(grafo);
+    avancar_epoca(ctx);
     return 0;
 }
 
+#define TAMANHO_BLOCO_POOL 65536  ///< Bytes de nós por bloco de um pool
+#define ALINHAMENTO_POOL 16       ///< Alinhamento dos nós e do início dos dados de cada bloco
+
 /**
- * @brief Adiciona um novo vértice (antena) ao grafo
- * @param grafo Apontador para o grafo
- * @param freq Frequência da antena (caracter)
- * @param x Coordenada x (coluna) da antena
- * @param y Coordenada y (linha) da antena
+ * @struct BlocoPool
+ * @brief Cabeçalho de um bloco de um pool; os nós seguem-se ao cabeçalho
+ */
+struct BlocoPool {
+    BlocoPool* prox;        ///< Próximo bloco do pool
+};
+
+#define CABECALHO_BLOCO ((sizeof(BlocoPool) + ALINHAMENTO_POOL - 1) & ~(size_t)(ALINHAMENTO_POOL - 1))
+
+/**
+ * @brief Prepara um pool vazio para nós de um dado tamanho
+ * @param pool Pool a inicializar
+ * @param tamanho Tamanho de cada nó em bytes
+ * @return 0 em caso de sucesso, -1 em caso de erro
  * 
- * @details A nova antena é inserida no início da lista de vértices
+ * @details Não aloca memória; o primeiro bloco só é pedido na primeira reserva
  */
-Vertice* adicionar_vertice(Grafo* grafo, char freq, int x, int y) {
-    if (!grafo) return NULL;
-    
-    Vertice* novo = (Vertice*)malloc(sizeof(Vertice));
-    if (!novo) return NULL;  
-    novo->frequencia = freq;
-    novo->x = x;
-    novo->y = y;
-    novo->visitado = false;
-    novo->arestas = NULL;
-    novo->proximo = grafo->vertices;
-    grafo->vertices = novo;
-    grafo->num_vertices++;
-    return novo;
+int pool_iniciar(Pool* pool, size_t tamanho) {
+    if (!pool || tamanho == 0) return -1;
+    if (tamanho < sizeof(void*)) tamanho = sizeof(void*);
+    pool->tamanho = (tamanho + ALINHAMENTO_POOL - 1) & ~(size_t)(ALINHAMENTO_POOL - 1);
+    pool->por_bloco = TAMANHO_BLOCO_POOL / pool->tamanho;
+    if (pool->por_bloco == 0) pool->por_bloco = 1;
+    pool->blocos = NULL;
+    pool->atual = NULL;
+    pool->usados = 0;
+    pool->livres = NULL;
+    return 0;
 }
 
 /**
- * @brief Adiciona uma aresta entre dois vértices (antenas da mesma frequência)
- * @param origem Vértice de origem
- * @param destino Vértice de destino
- * @return 0 em caso de sucesso, -1 em caso de erro, -2 se frequências diferentes
+ * @brief Reserva um nó do pool
+ * @param pool Pool de onde reservar
+ * @return Apontador para o nó ou NULL em caso de erro de memória
  * 
- * @details A aresta é bidirecional (grafo não direcionado) e não são permitidas:
- * - Arestas entre vértices com frequências diferentes
- * - Arestas duplicadas entre o mesmo par de vértices
+ * @details Usa primeiro a lista de nós devolvidos; depois avança no bloco atual,
+ * passando para o bloco seguinte (já existente após um reinício) ou alocando um novo
  */
-int adicionar_aresta(Vertice* origem, Vertice* destino) {
-    if (!origem || !destino) return -1;
-    if (origem->frequencia != destino->frequencia) return -2;
-    
-    // Verificar se aresta já existe
-    Aresta* a = origem->arestas;
-    while (a != NULL) {
-        if (a->destino == destino) return 0;
-        a = a->proxima;
+void* pool_reservar(Pool* pool) {
+    if (pool->livres != NULL) {
+        void* no = pool->livres;
+        pool->livres = *(void**)no;
+        return no;
     }
     
-    // Adicionar aresta origem->destino
-    Aresta* nova = (Aresta*)malloc(sizeof(Aresta));
-    if (!nova) return -3;
-    nova->destino = destino;
-    nova->proxima = origem->arestas;
-    origem->arestas = nova;
-    
-    // Adicionar aresta destino->origem (grafo não direcionado)
-    nova = (Aresta*)malloc(sizeof(Aresta));
-    if (!nova) return -4;
-    nova->destino = origem;
-    nova->proxima = destino->arestas;
-    destino->arestas = nova;
+    if (pool->atual == NULL || pool->usados == pool->por_bloco) {
+        BlocoPool* seguinte = pool->atual ? pool->atual->prox : pool->blocos;
+        if (seguinte == NULL) {
+            seguinte = (BlocoPool*)malloc(CABECALHO_BLOCO + pool->por_bloco * pool->tamanho);
+            if (!seguinte) return NULL;
+            seguinte->prox = NULL;
+            if (pool->atual) {
+                pool->atual->prox = seguinte;
+            } else {
+                pool->blocos = seguinte;
+            }
+        }
+        pool->atual = seguinte;
+        pool->usados = 0;
+    }
     
-    return 0;
+    return (char*)pool->atual + CABECALHO_BLOCO + pool->tamanho * pool->usados++;
 }
 
 /**
- * @brief Função recursiva auxiliar para procura em profundidade (DFS)
- * @param v Vértice atual a visitar
- * @return 0 em caso de sucesso, -1 em caso de erro
+ * @brief Devolve um nó ao pool para ser reutilizado
+ * @param pool Pool de onde o nó foi reservado
+ * @param no Nó a devolver
+ */
+void pool_devolver(Pool* pool, void* no) {
+    if (!pool || !no) return;
+    *(void**)no = pool->livres;
+    pool->livres = no;
+}
+
+/**
+ * @brief Reserva vários nós contíguos do pool, num bloco próprio
+ * @param pool Pool de onde reservar
+ * @param num Número de nós
+ * @return Apontador para o primeiro nó (os seguintes estão a pool->tamanho bytes
+ * uns dos outros) ou NULL se num for 0 ou em caso de erro de memória
  * 
- * @details Implementa DFS recursivo, marcando vértices como visitados
- * e imprimindo as coordenadas à medida que visita
+ * @details O bloco tem pelo menos por_bloco nós e entra na lista de blocos antes
+ * do bloco atual, como se já estivesse cheio: as reservas seguintes continuam
+ * onde estavam e, depois de um reinício, o bloco é reaproveitado como os outros.
+ * Os nós podem ser devolvidos um a um com pool_devolver.
  */
-int procura_profundidade_rec(Vertice* v) {
-    if (v == NULL) return -1;
-    if (v->visitado) return 0;
-    
-    printf("Visitando: %c (%d,%d)\n", v->frequencia, v->x, v->y);
-    v->visitado = true;
+void* pool_reservar_vetor(Pool* pool, size_t num) {
+    if (!pool || num == 0) return NULL;
+    size_t nos = num > pool->por_bloco ? num : pool->por_bloco;
+    if (nos > (SIZE_MAX - CABECALHO_BLOCO) / pool->tamanho) return NULL;
     
-    Aresta* a = v->arestas;
-    while (a != NULL) {
-        procura_profundidade_rec(a->destino);
-        a = a->proxima;
+    BlocoPool* bloco = (BlocoPool*)malloc(CABECALHO_BLOCO + nos * pool->tamanho);
+    if (!bloco) return NULL;
+    bloco->prox = pool->blocos;
+    pool->blocos = bloco;
+    if (pool->atual == NULL) {
+        // Ainda não há bloco atual: este passa a sê-lo, já cheio
+        pool->atual = bloco;
+        pool->usados = pool->por_bloco;
     }
-    return 0;
+    return (char*)bloco + CABECALHO_BLOCO;
 }
 
 /**
- * @brief Executa uma procura em profundidade (DFS) a partir de um vértice
- * @param grafo Apontador para o grafo
- * @param inicio Vértice de início da procura
- * @return 0 em caso de sucesso, -1 em caso de erro
+ * @brief Marca todos os nós do pool como livres, mantendo os blocos alocados
+ * @param pool Pool a reiniciar
  * 
- * @details Prepara a DFS reiniciando os marcadores de visita
- * antes de iniciar a procura recursiva
+ * @details Usado pelos pools de rascunho das procuras: depois da primeira
+ * execução, as seguintes reaproveitam os mesmos blocos sem chamar malloc
  */
-int procura_profundidade(Grafo* grafo, Vertice* inicio) {
-    if (!grafo || !inicio) return -1;
-    reiniciar_visitados(grafo);
-    return procura_profundidade_rec(inicio);
+void pool_reiniciar(Pool* pool) {
+    if (!pool) return;
+    pool->atual = NULL;
+    pool->usados = 0;
+    pool->livres = NULL;
 }
 
 /**
- * @brief Executa uma procura em largura (BFS) a partir de um vértice
- * @param grafo Apontador para o grafo
- * @param inicio Vértice de início da procura
- * @return 0 em caso de sucesso, -1 em caso de erro
- * 
- * @details Implementa BFS usando uma fila para visitar os vértices
- * por níveis de proximidade ao vértice inicial
+ * @brief Liberta todos os blocos do pool
+ * @param pool Pool a libertar
  */
-int procura_largura(Grafo* grafo, Vertice* inicio) {
-    if (!grafo || !inicio) return -1;
-    reiniciar_visitados(grafo);
-    
-    NodeFila* inicio_fila = NULL;
-    NodeFila* fim_fila = NULL;
-    
-    // Adicionar início na fila
-    NodeFila* novo = (NodeFila*)malloc(sizeof(NodeFila));
-    if (!novo) return -2;
-    novo->vertice = inicio;
-    novo->prox = NULL;
-    inicio_fila = fim_fila = novo;
-    inicio->visitado = true;
-    
-    while (inicio_fila != NULL) {
-        Vertice* atual = inicio_fila->vertice;
-        printf("Visitando: %c (%d,%d)\n", atual->frequencia, atual->x, atual->y);
-        
-        // Remover da fila
-        NodeFila* temp = inicio_fila;
-        inicio_fila = inicio_fila->prox;
-        if (inicio_fila == NULL) fim_fila = NULL;
-        
-        // Adicionar vizinhos
-        Aresta* a = atual->arestas;
-        while (a != NULL) {
-            if (!a->destino->visitado) {
-                a->destino->visitado = true;
-                NodeFila* novo_vizinho = (NodeFila*)malloc(sizeof(NodeFila));
-                if (!novo_vizinho) return -3;
-                novo_vizinho->vertice = a->destino;
-                novo_vizinho->prox = NULL;
-                
-                if (fim_fila == NULL) {
-                    inicio_fila = fim_fila = novo_vizinho;
-                } else {
-                    fim_fila->prox = novo_vizinho;
-                    fim_fila = novo_vizinho;
-                }
-            }
-            a = a->proxima;
-        }
+void pool_libertar(Pool* pool) {
+    if (!pool) return;
+    BlocoPool* b = pool->blocos;
+    while (b != NULL) {
+        BlocoPool* temp = b;
+        b = b->prox;
         free(temp);
     }
-    return 0;
+    pool->blocos = NULL;
+    pool_reiniciar(pool);
 }
 
 /**
- * @brief Imprime um caminho na ordem inversa (auxiliar para encontrar_caminhos_rec)
- * @param caminho Apontador para o nó do caminho a imprimir
+ * @brief Cria um novo grafo vazio
+ * @return Apontador para o grafo criado ou NULL em caso de erro
  * 
- * @details Usa recursão para imprimir o caminho desde o fim até ao início
+ * @details Aloca memória para a estrutura do grafo e inicializa:
+ * - Lista de vértices como NULL
+ * - Contador de vértices como 0
+ * - Arestas guardadas explicitamente em listas
+ * - Pools de vértices, arestas e nós auxiliares das procuras
  */
-void imprimir_caminho_inverso(CaminhoNode* caminho) {
-    if (caminho == NULL) return;
-    imprimir_caminho_inverso(caminho->prox);
-    printf("%c(%d,%d) ", caminho->vertice->frequencia, caminho->vertice->x, caminho->vertice->y);
+Grafo* criar_grafo() {
+    return criar_grafo_modo(ARESTAS_EXPLICITAS);
 }
 
 /**
- * @brief Função recursiva auxiliar para encontrar todos os caminhos entre dois vértices
- * @param atual Vértice atual na procura
- * @param destino Vértice de destino
- * @param caminho_atual Caminho percorrido até ao momento
- * @return 0 em caso de sucesso, -1 em caso de erro
+ * @brief Cria um novo grafo vazio com a representação de arestas indicada
+ * @param modo ARESTAS_EXPLICITAS ou ARESTAS_IMPLICITAS
+ * @return Apontador para o grafo criado ou NULL em caso de erro
  * 
- * @details Implementa DFS modificado para encontrar todos os caminhos possíveis,
- * usando backtracking e marcadores de visita
+ * @details Para além da lista de vértices, o grafo mantém um vetor de vértices
+ * por frequência. No modo implícito é esse vetor que define os vizinhos.
  */
-int encontrar_caminhos_rec(Vertice* atual, Vertice* destino, CaminhoNode* caminho_atual) {
-    if (!atual || !destino) return -1;
-    
-    // Adicionar vértice atual ao caminho
-    CaminhoNode* novo_no = (CaminhoNode*)malloc(sizeof(CaminhoNode));
-    if (!novo_no) return -2;
-    novo_no->vertice = atual;
-    novo_no->prox = caminho_atual;
-    
-    if (atual == destino) {
-        contador_caminhos++;
-        printf("Caminho %d: ", contador_caminhos);
-        imprimir_caminho_inverso(novo_no);
-        printf("\n");
-    } else {
-        atual->visitado = true;
-        Aresta* a = atual->arestas;
-        while (a != NULL) {
-            if (!a->destino->visitado) {
-                encontrar_caminhos_rec(a->destino, destino, novo_no);
-            }
-            a = a->proxima;
-        }
-        atual->visitado = false;
+Grafo* criar_grafo_modo(ModoArestas modo) {
+    Grafo* grafo = (Grafo*)malloc(sizeof(Grafo));
+    if (!grafo) return NULL;
+    grafo->vertices = NULL;
+    grafo->num_vertices = 0;
+    grafo->modo = modo;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        grafo->por_frequencia[f] = NULL;
+        grafo->num_por_frequencia[f] = 0;
+        grafo->cap_por_frequencia[f] = 0;
     }
-    
-    free(novo_no);
-    return 0;
+    grafo->por_id = NULL;
+    grafo->cap_por_id = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) grafo->assinatura[f] = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) grelha_pontos_iniciar(&grafo->espacial[f]);
+    grafo->indice = NULL;
+    grafo->cap_indice = 0;
+    pool_iniciar(&grafo->pool_vertices, sizeof(Vertice));
+    pool_iniciar(&grafo->pool_arestas, sizeof(Aresta));
+    contexto_iniciar(&grafo->contexto);
+    estatisticas_limpar(&grafo->estatisticas);
+    return grafo;
 }
 
 /**
- * @brief Encontra e imprime todos os caminhos entre duas antenas
- * @param grafo Apontador para o grafo
- * @param origem Vértice de origem
- * @param destino Vértice de destino
+ * @brief Liberta toda a memória associada ao grafo
+ * @param grafo Apontador para o grafo a destruir
  * @return 0 em caso de sucesso, -1 em caso de erro
  * 
- * @details Verifica previamente:
- * - Existência dos vértices
- * - Se têm a mesma frequência
- * - Prepara o contador de caminhos e marcadores de visita
+ * @details Liberta:
+ * - Os pools de vértices (antenas), arestas (conexões) e de rascunho,
+ *   bloco a bloco, sem percorrer vértices nem arestas
+ * - Os vetores de vértices por frequência e por índice e o índice de coordenadas
+ * - As grelhas do índice espacial
+ * - O contexto de procura do grafo (marcas, fila e pilha)
+ * - A própria estrutura do grafo
  */
-int encontrar_caminhos(Grafo* grafo, Vertice* origem, Vertice* destino) {
+int destruir_grafo(Grafo* grafo) {
     if (!grafo) return -1;
     
-    if (origem == NULL || destino == NULL) {
-        printf("\nNao foi possivel encontrar caminhos:\n");
-        if (origem == NULL && destino == NULL) {
-            printf("- Ambas as antenas nao existem no mapa\n");
-        } else if (origem == NULL) {
-            printf("- Antena de origem nao existe no mapa\n");
-        } else {
-            printf("- Antena de destino nao existe no mapa\n");
-        }
-        return -2;
-    }
-    
-    if (origem->frequencia != destino->frequencia) {
-        printf("\nNao existem caminhos entre %c(%d,%d) e %c(%d,%d)\n", 
-               origem->frequencia, origem->x, origem->y,
-               destino->frequencia, destino->x, destino->y);
-        printf("- As antenas tem frequencias diferentes (%c e %c)\n", 
-               origem->frequencia, destino->frequencia);
-        return -3;
-    }
-    
-    contador_caminhos = 0;
-    reiniciar_visitados(grafo);
-    
-    printf("\n=== Caminhos entre %c(%d,%d) e %c(%d,%d) ===\n",
-           origem->frequencia, origem->x, origem->y,
-           destino->frequencia, destino->x, destino->y);
-           
-    int resultado = encontrar_caminhos_rec(origem, destino, NULL);
-    
-    if (contador_caminhos == 0) {
-        printf("Nenhum caminho encontrado entre as antenas\n");
-    } else {
-        printf("Total de caminhos encontrados: %d\n", contador_caminhos);
+    pool_libertar(&grafo->pool_vertices);
+    pool_libertar(&grafo->pool_arestas);
+    contexto_libertar(&grafo->contexto);
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        free(grafo->por_frequencia[f]);
+        grelha_pontos_libertar(&grafo->espacial[f]);
     }
-    
-    return resultado;
+    free(grafo->por_id);
+    free(grafo->indice);
+    free(grafo);
+    return 0;
 }
 
 /**
- * @brief Calcula o ponto de intersecção entre duas linhas definidas por pares de pontos
- * @param p1, p2 Pontos da primeira linha (freqA)
- * @param p3, p4 Pontos da segunda linha (freqB)
- * @param[out] x, y Coordenadas da interseção (se existir)
- * @return true se as linhas se intersectam, false caso contrário
+ * @brief Garante espaço no vetor de uma frequência para mais alguns vértices
+ * @param grafo Apontador para o grafo
+ * @param f Frequência
+ * @param mais Número de vértices a acrescentar
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
  * 
- * @details Implementa o algoritmo de interseção de segmentos de linha
- * usando álgebra linear para determinar o ponto de interseção
+ * @details A capacidade duplica até chegar, tal como faria vértice a vértice
  */
-bool calcular_intersecao(Vertice* p1, Vertice* p2, Vertice* p3, Vertice* p4, int* x, int* y) {
-    // Calcula os denominadores
-    int denom = (p4->y - p3->y) * (p2->x - p1->x) - (p4->x - p3->x) * (p2->y - p1->y);
-    
-    // Linhas paralelas
-    if (denom == 0) return false;
-    
-    // Calcula os parâmetros
-    float ua = ((p4->x - p3->x) * (p1->y - p3->y) - (p4->y - p3->y) * (p1->x - p3->x)) / (float)denom;
-    float ub = ((p2->x - p1->x) * (p1->y - p3->y) - (p2->y - p1->y) * (p1->x - p3->x)) / (float)denom;
-    
-    // Verifica se a interseção está dentro dos segmentos
-    if (ua < 0 || ua > 1 || ub < 0 || ub > 1) return false;
-    
-    // Calcula o ponto de interseção
-    *x = p1->x + ua * (p2->x - p1->x);
-    *y = p1->y + ua * (p2->y - p1->y);
-    
-    return true;
+static int reservar_frequencia(Grafo* grafo, unsigned char f, int mais) {
+    if (grafo->num_por_frequencia[f] + mais <= grafo->cap_por_frequencia[f]) return 0;
+    int nova_cap = grafo->cap_por_frequencia[f] ? grafo->cap_por_frequencia[f] : 4;
+    while (nova_cap < grafo->num_por_frequencia[f] + mais) nova_cap *= 2;
+    Vertice** novo = (Vertice**)realloc(grafo->por_frequencia[f], (size_t)nova_cap * sizeof(Vertice*));
+    if (!novo) return -1;
+    grafo->por_frequencia[f] = novo;
+    grafo->cap_por_frequencia[f] = nova_cap;
+    return 0;
 }
 
 /**
- * @brief Encontra e imprime todas as intersecções entre pares de antenas de duas frequências
+ * @brief Acrescenta um vértice ao vetor da sua frequência
  * @param grafo Apontador para o grafo
- * @param freqA Primeira frequência a considerar
- * @param freqB Segunda frequência a considerar
- * @return Número de intersecções encontradas
+ * @param v Vértice a acrescentar
+ * @param freq Frequência do vértice
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
  * 
- * @details Compara todos os pares de arestas das duas frequências
- * e verifica se as linhas que os representam se intersectam
+ * @details A capacidade do vetor duplica quando fica cheio
  */
-int intersecoes_frequencias(Grafo* grafo, char freqA, char freqB) {
-    Intersecao* intersecoes = NULL;
-    int count = 0;
-    
-    Vertice* a1 = grafo->vertices;
-    while (a1 != NULL) {
-        if (a1->frequencia == freqA) {
-            Aresta* arestaA = a1->arestas;
-            while (arestaA != NULL) {
-                Vertice* a2 = arestaA->destino;
-                if (a1 < a2) {
-                    Vertice* b1 = grafo->vertices;
-                    while (b1 != NULL) {
-                        if (b1->frequencia == freqB) {
-                            Aresta* arestaB = b1->arestas;
-                            while (arestaB != NULL) {
-                                Vertice* b2 = arestaB->destino;
-                                if (b1 < b2) {
-                                    int x, y;
-                                    if (calcular_intersecao(a1, a2, b1, b2, &x, &y)) {
-                                        bool existe = false;
-                                        Intersecao* atual = intersecoes;
-                                        while (atual != NULL) {
-                                            if (atual->x == x && atual->y == y) {
-                                                existe = true;
-                                                break;
-                                            }
-                                            atual = atual->prox;
-                                        }
-                                        
-                                        if (!existe) {
-                                            Intersecao* nova = malloc(sizeof(Intersecao));
-                                            nova->x = x;
-                                            nova->y = y;
-                                            nova->prox = intersecoes;
-                                            intersecoes = nova;
-                                            count++;
-                                            
-                                            if (count == 1) {
-                                                printf("\n=== Intersecoes entre frequencias de %c e %c ===\n", freqA, freqB);
-                                            }
-                                            
-                                            printf("Linha %c(%d,%d)-%c(%d,%d) com ", 
-                                                   freqA, a1->x, a1->y, freqA, a2->x, a2->y);
-                                            printf("%c(%d,%d)-%c(%d,%d) em (%d,%d)\n",
-                                                   freqB, b1->x, b1->y, freqB, b2->x, b2->y, x, y);
-                                        }
-                                    }
-                                }
-                                arestaB = arestaB->proxima;
-                            }
-                        }
-                        b1 = b1->proximo;
-                    }
-                }
-                arestaA = arestaA->proxima;
-            }
-        }
-        a1 = a1->proximo;
-    }
-    
-    while (intersecoes != NULL) {
-        Intersecao* temp = intersecoes;
-        intersecoes = intersecoes->prox;
-        free(temp);
-    }
-    
-    return count;
+static int anexar_a_frequencia(Grafo* grafo, Vertice* v, char freq) {
+    unsigned char f = (unsigned char)freq;
+    if (reservar_frequencia(grafo, f, 1) != 0) return -1;
+    grafo->por_frequencia[f][grafo->num_por_frequencia[f]++] = v;
+    return 0;
 }
 
 /**
- * @brief Encontra um vértice no grafo pelas suas coordenadas
- * @param grafo Apontador para o grafo
- * @param x Coordenada x (coluna) do vértice
- * @param y Coordenada y (linha) do vértice
+ * @brief Calcula a posição inicial de um par de coordenadas no índice
+ * @param x Coordenada x (coluna)
+ * @param y Coordenada y (linha)
+ * @param mascara Capacidade da tabela menos 1
+ * @return Posição na tabela
+ */
+static int posicao_indice(int x, int y, int mascara) {
+    unsigned int h = (unsigned int)x * 0x9E3779B1u ^ (unsigned int)y * 0x85EBCA77u;
+    h ^= h >> 15;
+    return (int)(h & (unsigned int)mascara);
+}
+
+/**
+ * @brief Insere um vértice no índice de coordenadas, sem verificar a capacidade
+ * @param tabela Tabela de dispersão
+ * @param cap Capacidade da tabela (potência de 2)
+ * @param v Vértice a inserir
  * 
- * @details Percorre a lista de vértices até encontrar um com as coordenadas especificadas
+ * @details Se já existir um vértice com as mesmas coordenadas é substituído,
+ * tal como o vértice mais recente fica à frente na lista de vértices
  */
-Vertice* encontrar_vertice(Grafo* grafo, int x, int y) {
-    Vertice* v = grafo->vertices;
-    while (v != NULL) {
-        if (v->x == x && v->y == y) return v;
-        v = v->proximo;
+static void inserir_no_indice(Vertice** tabela, int cap, Vertice* v) {
+    int i = posicao_indice(v->x, v->y, cap - 1);
+    while (tabela[i] != NULL) {
+        if (tabela[i]->x == v->x && tabela[i]->y == v->y) break;
+        i = (i + 1) & (cap - 1);
     }
-    return NULL;
+    tabela[i] = v;
 }
 
 /**
- * @brief Reinicia o estado 'visitado' de todos os vértices do grafo
+ * @brief Garante espaço no índice de coordenadas para mais alguns vértices
  * @param grafo Apontador para o grafo
- * @return 0 em caso de sucesso, -1 em caso de erro
+ * @param mais Número de vértices a acrescentar
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
  * 
- * @details Pré-requisito para algoritmos de procura do grafo
+ * @details Mantém a ocupação abaixo de 50%, duplicando a tabela e reinserindo
+ * todos os vértices quando necessário
  */
-int reiniciar_visitados(Grafo* grafo) {
-    if (!grafo) return -1;
+static int reservar_indice(Grafo* grafo, int mais) {
+    long long pretendida = 2 * ((long long)grafo->num_vertices + mais);
+    if (pretendida <= grafo->cap_indice) return 0;
+    
+    long long nova_cap = grafo->cap_indice ? 2 * (long long)grafo->cap_indice : 16;
+    while (nova_cap < pretendida) nova_cap *= 2;
+    if (nova_cap > INT_MAX) return -1;
+    Vertice** nova = (Vertice**)calloc((size_t)nova_cap, sizeof(Vertice*));
+    if (!nova) return -1;
     
-    Vertice* v = grafo->vertices;
-    while (v != NULL) {
-        v->visitado = false;
-        v = v->proximo;
+    for (int i = 0; i < grafo->cap_indice; i++) {
+        if (grafo->indice[i] != NULL) inserir_no_indice(nova, (int)nova_cap, grafo->indice[i]);
     }
+    free(grafo->indice);
+    grafo->indice = nova;
+    grafo->cap_indice = (int)nova_cap;
     return 0;
 }
 
 /**
- * @brief Imprime a representação do grafo na consola
- * @param grafo Apontador para o grafo a imprimir
+ * @brief Retira um vértice do índice de coordenadas
+ * @param grafo Apontador para o grafo
+ * @param v Vértice a retirar
  * 
- * @details Mostra cada vértice e as suas conexões num formato legível
+ * @details Apaga por deslocamento para trás: as entradas seguintes da mesma
+ * sequência de sondagem que já não seriam encontradas sobem para a posição
+ * libertada, pelo que não é preciso marcar posições apagadas
  */
-void imprimir_grafo(Grafo* grafo) {
-    if (grafo == NULL) {
-        printf("Grafo inválido (NULL)\n");
-        return;
-    }
+static void retirar_do_indice(Grafo* grafo, Vertice* v) {
+    if (grafo->cap_indice == 0) return;
     
-    printf("\nGrafo (%d antenas):\n", grafo->num_vertices);
+    Vertice** tabela = grafo->indice;
+    int mascara = grafo->cap_indice - 1;
+    int i = posicao_indice(v->x, v->y, mascara);
+    while (tabela[i] != NULL && tabela[i] != v) i = (i + 1) & mascara;
+    if (tabela[i] == NULL) return;
     
-    Vertice* v = grafo->vertices;
-    while (v != NULL) {
-        printf("Antena %c (%d,%d) -> ", v->frequencia, v->x, v->y);
-        Aresta* a = v->arestas;
-        
-        if (a == NULL) {
-            printf("Sem conexões");
-        } else {
-            while (a != NULL) {
-                printf("%c(%d,%d)", a->destino->frequencia, a->destino->x, a->destino->y);
-                a = a->proxima;
-                if (a != NULL) printf("  ");
-            }
-        }
-        printf("\n");
-        v = v->proximo;
+    int j = i;
+    for (;;) {
+        j = (j + 1) & mascara;
+        if (tabela[j] == NULL) break;
+        int k = posicao_indice(tabela[j]->x, tabela[j]->y, mascara);
+        // A entrada j fica se a sua posição inicial estiver em (i, j], circularmente
+        bool fica = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+        if (fica) continue;
+        tabela[i] = tabela[j];
+        i = j;
     }
-}
\ No newline at end of file
+    tabela[i] = NULL;
+}
+
+/**
+ * @brief Garante espaço no vetor de vértices por índice para mais alguns vértices
+ * @param grafo Apontador para o grafo
+ * @param mais Número de vértices a acrescentar
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
+ */
+static int reservar_por_id(Grafo* grafo, int mais) {
+    if (grafo->num_vertices + mais <= grafo->cap_por_id) return 0;
+    
+    long long nova_cap = grafo->cap_por_id ? grafo->cap_por_id : 16;
+    while (nova_cap < (long long)grafo->num_vertices + mais) nova_cap *= 2;
+    if (nova_cap > INT_MAX) return -1;
+    Vertice** novo = (Vertice**)realloc(grafo->por_id, (size_t)nova_cap * sizeof(Vertice*));
+    if (!novo) return -1;
+    grafo->por_id = novo;
+    grafo->cap_por_id = (int)nova_cap;
+    return 0;
+}
+
+/**
+ * @brief Mistura os bits de um valor de 64 bits (finalizador do splitmix64)
+ * @param z Valor a misturar
+ * @return Valor misturado
+ */
+static unsigned long long misturar(unsigned long long z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Contribuição de um vértice para a assinatura da sua frequência
+ * @param v Vértice
+ * @return Valor a somar à assinatura
+ */
+static unsigned long long assinatura_vertice(const Vertice* v) {
+    unsigned long long posicao = (unsigned long long)(unsigned int)v->x << 32 | (unsigned int)v->y;
+    return misturar(posicao + 0x9E3779B97F4A7C15ull);
+}
+
+/**
+ * @brief Contribuição de uma ligação explícita para a assinatura da frequência
+ * @param u Um dos extremos
+ * @param v O outro extremo
+ * @return Valor a somar à assinatura (igual para (u, v) e (v, u))
+ */
+static unsigned long long assinatura_ligacao(const Vertice* u, const Vertice* v) {
+    return misturar(assinatura_vertice(u) + assinatura_vertice(v));
+}
+
+/**
+ * @brief Liga duas arestas de sentidos opostos, inserindo cada uma no início da lista do seu vértice
+ * @param origem Vértice de onde parte ida
+ * @param ida Aresta de origem para destino
+ * @param destino Vértice de onde parte volta
+ * @param volta Aresta de destino para origem
+ * 
+ * @details Cada aresta guarda a do sentido oposto e a anterior na sua lista,
+ * para que remover_vertice retire a aresta de volta em O(1)
+ */
+static void ligar_arestas(Vertice* origem, Aresta* ida, Vertice* destino, Aresta* volta) {
+    ida->destino = destino;
+    ida->par = volta;
+    ida->anterior = NULL;
+    ida->proxima = origem->arestas;
+    if (origem->arestas) origem->arestas->anterior = ida;
+    origem->arestas = ida;
+    
+    volta->destino = origem;
+    volta->par = ida;
+    volta->anterior = NULL;
+    volta->proxima = destino->arestas;
+    if (destino->arestas) destino->arestas->anterior = volta;
+    destino->arestas = volta;
+}
+
+/**
+ * @brief Adiciona um novo vértice (antena) ao grafo
+ * @param grafo Apontador para o grafo
+ * @param freq Frequência da antena (caracter)
+ * @param x Coordenada x (coluna) da antena
+ * @param y Coordenada y (linha) da antena
+ * 
+ * @details A nova antena é inserida no início da lista de vértices e no fim
+ * do vetor da sua frequência, recebendo o próximo índice denso livre.
+ * O índice de coordenadas é atualizado para que encontrar_vertice a encontre.
+ */
+Vertice* adicionar_vertice(Grafo* grafo, char freq, int x, int y) {
+    if (!grafo) return NULL;
+    
+    if (reservar_indice(grafo, 1) != 0 || reservar_por_id(grafo, 1) != 0) return NULL;
+    
+    Vertice* novo = (Vertice*)pool_reservar(&grafo->pool_vertices);
+    if (!novo) return NULL;  
+    if (anexar_a_frequencia(grafo, novo, freq) != 0) {
+        pool_devolver(&grafo->pool_vertices, novo);
+        return NULL;
+    }
+    novo->id = grafo->num_vertices;
+    novo->frequencia = freq;
+    novo->x = x;
+    novo->y = y;
+    novo->arestas = NULL;
+    novo->proximo = grafo->vertices;
+    novo->anterior = NULL;
+    if (grafo->vertices) grafo->vertices->anterior = novo;
+    grafo->vertices = novo;
+    grafo->por_id[grafo->num_vertices] = novo;
+    grafo->num_vertices++;
+    grafo->assinatura[(unsigned char)freq] += assinatura_vertice(novo);
+    grafo->espacial[(unsigned char)freq].valida = false;
+    inserir_no_indice(grafo->indice, grafo->cap_indice, novo);
+    ESTAT_SOMAR(grafo->estatisticas.vertices_criados, 1);
+    return novo;
+}
+
+/**
+ * @brief Adiciona uma antena e liga-a às restantes antenas da sua frequência
+ * @param grafo Apontador para o grafo
+ * @param freq Frequência da antena (caracter)
+ * @param x Coordenada x (coluna) da antena
+ * @param y Coordenada y (linha) da antena
+ * @return Apontador para o novo vértice, ou NULL se a posição estiver ocupada ou em caso de erro
+ * 
+ * @details Só toca no vetor da frequência da antena, em vez de voltar a ligar o
+ * grafo: O(1) no modo implícito e O(k) no explícito, sendo k o número de antenas
+ * dessa frequência. A nova antena recebe as restantes por ordem do vetor e é
+ * inserida no início da lista de cada uma delas, pelo que essas listas podem
+ * ficar por outra ordem que não a de um novo carregamento do mapa (a assinatura
+ * da frequência é uma soma e não depende dessa ordem).
+ */
+Vertice* adicionar_vertice_ligado(Grafo* grafo, char freq, int x, int y) {
+    if (!grafo || encontrar_vertice(grafo, x, y) != NULL) return NULL;
+    
+    unsigned char f = (unsigned char)freq;
+    int k = grafo->num_por_frequencia[f];
+    Vertice* novo = adicionar_vertice(grafo, freq, x, y);
+    if (!novo || grafo->modo == ARESTAS_IMPLICITAS) return novo;
+    
+    Vertice** balde = grafo->por_frequencia[f];
+    for (int j = k - 1; j >= 0; j--) {
+        Aresta* ida = (Aresta*)pool_reservar(&grafo->pool_arestas);
+        Aresta* volta = ida ? (Aresta*)pool_reservar(&grafo->pool_arestas) : NULL;
+        if (!volta) {
+            pool_devolver(&grafo->pool_arestas, ida);
+            remover_vertice(grafo, novo);
+            return NULL;
+        }
+        
+        ligar_arestas(novo, ida, balde[j], volta);
+        
+        grafo->assinatura[f] += assinatura_ligacao(novo, balde[j]);
+        ESTAT_SOMAR(grafo->estatisticas.arestas_criadas, 1);
+    }
+    return novo;
+}
+
+/**
+ * @brief Função executada para cada tarefa de um trabalho repartido por vários fios
+ * @param dados Estado partilhado do trabalho
+ * @param tarefa Número da tarefa (0 .. num_tarefas-1)
+ */
+typedef void (*FuncaoTarefa)(void* dados, int tarefa);
+
+/**
+ * @brief Estado partilhado pelos fios de execução de executar_tarefas
+ */
+typedef struct {
+    FuncaoTarefa funcao;        ///< Função a executar para cada tarefa
+    void* dados;                ///< Estado passado à função
+    int num_tarefas;            ///< Número de tarefas
+    atomic_int proxima;         ///< Próxima tarefa por executar
+} TrabalhoTarefas;
+
+/**
+ * @brief Corpo de cada fio de execução: executa as tarefas que obtiver do contador
+ * @param arg Apontador para o TrabalhoTarefas partilhado
+ * @return NULL
+ */
+static void* trabalhar_tarefas(void* arg) {
+    TrabalhoTarefas* t = (TrabalhoTarefas*)arg;
+    while (1) {
+        int k = atomic_fetch_add(&t->proxima, 1);
+        if (k >= t->num_tarefas) break;
+        t->funcao(t->dados, k);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Executa num_tarefas tarefas independentes, repartidas por vários fios
+ * @param funcao Função a executar para cada tarefa
+ * @param dados Estado passado à função
+ * @param num_tarefas Número de tarefas
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * 
+ * @details O fio que chama também trabalha. Se não for possível criar fios,
+ * as tarefas são todas executadas por quem chama, pela mesma ordem.
+ */
+static void executar_tarefas(FuncaoTarefa funcao, void* dados, int num_tarefas, int num_fios) {
+    TrabalhoTarefas t;
+    t.funcao = funcao;
+    t.dados = dados;
+    t.num_tarefas = num_tarefas;
+    atomic_init(&t.proxima, 0);
+    
+    if (num_fios == 0) num_fios = numero_processadores();
+    if (num_fios > num_tarefas) num_fios = num_tarefas > 0 ? num_tarefas : 1;
+    
+    pthread_t* fios = num_fios > 1 ? (pthread_t*)malloc((size_t)(num_fios - 1) * sizeof(pthread_t)) : NULL;
+    int criados = 0;
+    for (int f = 0; fios && f < num_fios - 1; f++) {
+        if (pthread_create(&fios[criados], NULL, trabalhar_tarefas, &t) != 0) break;
+        criados++;
+    }
+    trabalhar_tarefas(&t);
+    for (int f = 0; f < criados; f++) pthread_join(fios[f], NULL);
+    free(fios);
+}
+
+/**
+ * @brief Insere um vértice no índice de coordenadas com outros fios a inserir ao mesmo tempo
+ * @param tabela Tabela de dispersão (com espaço para todos os vértices)
+ * @param cap Capacidade da tabela (potência de 2)
+ * @param v Vértice a inserir
+ * 
+ * @details Cada posição é ocupada com compare-and-swap. Entre vértices com as
+ * mesmas coordenadas fica o de maior índice, que é o que inserir_no_indice
+ * deixaria se os vértices fossem inseridos um a um por ordem de índice. A
+ * tabela é um Vertice** normal, lido sem atomicidade fora do carregamento, pelo
+ * que os acessos usam as funções __atomic do GCC sobre os próprios apontadores
+ * em vez de a converter para _Atomic(Vertice*)*.
+ */
+static void inserir_no_indice_concorrente(Vertice** tabela, int cap, Vertice* v) {
+    int i = posicao_indice(v->x, v->y, cap - 1);
+    while (1) {
+        Vertice* atual = __atomic_load_n(&tabela[i], __ATOMIC_ACQUIRE);
+        bool mesma = atual != NULL && atual->x == v->x && atual->y == v->y;
+        if (atual == NULL || (mesma && atual->id < v->id)) {
+            if (__atomic_compare_exchange_n(&tabela[i], &atual, v, true,
+                                            __ATOMIC_RELEASE, __ATOMIC_RELAXED)) return;
+            continue;
+        }
+        if (mesma) return;
+        i = (i + 1) & (cap - 1);
+    }
+}
+
+/**
+ * @brief Estado partilhado de adicionar_vertices_lotes
+ */
+typedef struct {
+    Grafo* grafo;                                   ///< Grafo a que se juntam os vértices
+    const LoteAntenas* lotes;                        ///< Lotes de antenas, pela ordem de inserção
+    int (*contagens)[NUM_FREQUENCIAS];              ///< Antenas de cada frequência em cada lote; depois, posição inicial no vetor da frequência
+    unsigned long long (*assinaturas)[NUM_FREQUENCIAS];  ///< Soma das assinaturas dos vértices de cada lote, por frequência
+    int* primeiro;                                  ///< Índice do primeiro vértice de cada lote
+    char* nos;                                      ///< Primeiro dos vértices novos, contíguos
+    size_t tamanho;                                 ///< Distância em bytes entre vértices novos consecutivos
+    int base;                                       ///< Índice do primeiro vértice novo
+    int total;                                      ///< Número de vértices novos
+    Vertice* cabeca;                                ///< Início da lista de vértices antes da inserção
+} TrabalhoLotes;
+
+/**
+ * @brief Conta as antenas de cada frequência de um lote
+ * @param dados Apontador para o TrabalhoLotes
+ * @param k Lote
+ */
+static void contar_lote(void* dados, int k) {
+    TrabalhoLotes* t = (TrabalhoLotes*)dados;
+    const LoteAntenas* lote = &t->lotes[k];
+    int* contagem = t->contagens[k];
+    memset(contagem, 0, NUM_FREQUENCIAS * sizeof(int));
+    for (int i = 0; i < lote->num; i++) contagem[(unsigned char)lote->frequencia[i]]++;
+}
+
+/**
+ * @brief Preenche os vértices de um lote e coloca-os nos vetores e no índice do grafo
+ * @param dados Apontador para o TrabalhoLotes
+ * @param k Lote
+ * 
+ * @details As posições de cada vértice na lista, em por_id e no vetor da sua
+ * frequência são conhecidas antes de começar, pelo que os lotes não partilham
+ * nada para além da tabela do índice de coordenadas
+ */
+static void preencher_lote(void* dados, int k) {
+    TrabalhoLotes* t = (TrabalhoLotes*)dados;
+    Grafo* grafo = t->grafo;
+    const LoteAntenas* lote = &t->lotes[k];
+    int posicao[NUM_FREQUENCIAS];
+    memcpy(posicao, t->contagens[k], sizeof(posicao));
+    unsigned long long* assinatura = t->assinaturas[k];
+    memset(assinatura, 0, NUM_FREQUENCIAS * sizeof(unsigned long long));
+    
+    for (int i = 0; i < lote->num; i++) {
+        int r = t->primeiro[k] + i;
+        Vertice* v = (Vertice*)(t->nos + (size_t)r * t->tamanho);
+        unsigned char f = (unsigned char)lote->frequencia[i];
+        v->id = t->base + r;
+        v->frequencia = lote->frequencia[i];
+        v->x = lote->x[i];
+        v->y = lote->y[i];
+        v->arestas = NULL;
+        // A lista começa no vértice mais recente, como com adicionar_vertice
+        v->proximo = r > 0 ? (Vertice*)(t->nos + (size_t)(r - 1) * t->tamanho) : t->cabeca;
+        v->anterior = r + 1 < t->total ? (Vertice*)(t->nos + (size_t)(r + 1) * t->tamanho) : NULL;
+        grafo->por_id[v->id] = v;
+        grafo->por_frequencia[f][posicao[f]++] = v;
+        assinatura[f] += assinatura_vertice(v);
+        inserir_no_indice_concorrente(grafo->indice, grafo->cap_indice, v);
+    }
+}
+
+/**
+ * @brief Junta ao grafo os vértices dos lotes, com o estado de trabalho já alocado
+ * @param t Estado partilhado (grafo, lotes e vetores por lote)
+ * @param num_lotes Número de lotes
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @return 0 em caso de sucesso, -2 em caso de erro de memória
+ */
+static int juntar_lotes(TrabalhoLotes* t, int num_lotes, int num_fios) {
+    Grafo* grafo = t->grafo;
+    
+    // 1. Antenas de cada frequência em cada lote
+    executar_tarefas(contar_lote, t, num_lotes, num_fios);
+    
+    // 2. Somas prefixas e reservas
+    int por_frequencia[NUM_FREQUENCIAS];
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) por_frequencia[f] = grafo->num_por_frequencia[f];
+    int seguinte = 0;
+    for (int k = 0; k < num_lotes; k++) {
+        t->primeiro[k] = seguinte;
+        seguinte += t->lotes[k].num;
+        for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+            int c = t->contagens[k][f];
+            t->contagens[k][f] = por_frequencia[f];
+            por_frequencia[f] += c;
+        }
+    }
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        int mais = por_frequencia[f] - grafo->num_por_frequencia[f];
+        if (mais > 0 && reservar_frequencia(grafo, (unsigned char)f, mais) != 0) return -2;
+    }
+    if (reservar_indice(grafo, t->total) != 0 || reservar_por_id(grafo, t->total) != 0) return -2;
+    t->nos = (char*)pool_reservar_vetor(&grafo->pool_vertices, (size_t)t->total);
+    if (!t->nos) return -2;
+    
+    // 3. Vértices, em paralelo
+    executar_tarefas(preencher_lote, t, num_lotes, num_fios);
+    
+    if (t->cabeca) t->cabeca->anterior = (Vertice*)t->nos;
+    grafo->vertices = (Vertice*)(t->nos + (size_t)(t->total - 1) * t->tamanho);
+    grafo->num_vertices += t->total;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        if (por_frequencia[f] == grafo->num_por_frequencia[f]) continue;
+        grafo->num_por_frequencia[f] = por_frequencia[f];
+        for (int k = 0; k < num_lotes; k++) grafo->assinatura[f] += t->assinaturas[k][f];
+        grafo->espacial[f].valida = false;
+    }
+    ESTAT_SOMAR(grafo->estatisticas.vertices_criados, t->total);
+    return 0;
+}
+
+/**
+ * @brief Adiciona ao grafo as antenas de vários lotes, repartindo o trabalho por vários fios
+ * @param grafo Apontador para o grafo
+ * @param lotes Lotes de antenas
+ * @param num_lotes Número de lotes
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details O grafo fica igual ao que se obteria chamando adicionar_vertice para
+ * cada antena do primeiro lote, depois do segundo, e assim por diante: mesmos
+ * índices, mesma ordem na lista e nos vetores por frequência, mesma assinatura.
+ * 1. Cada fio conta as antenas de cada frequência nos lotes que obtiver
+ * 2. Somas prefixas dão o índice do primeiro vértice de cada lote e a sua
+ *    posição inicial no vetor de cada frequência; os vetores, o índice de
+ *    coordenadas e os vértices (um só bloco do pool) são reservados de uma vez
+ * 3. Cada fio preenche os vértices dos seus lotes nas posições já calculadas
+ * 
+ * Em caso de erro o grafo não é alterado (apenas algumas capacidades crescem).
+ */
+int adicionar_vertices_lotes(Grafo* grafo, const LoteAntenas* lotes, int num_lotes, int num_fios) {
+    if (!grafo || (!lotes && num_lotes > 0) || num_lotes < 0 || num_fios < 0) return -1;
+    
+    long long total = 0;
+    for (int k = 0; k < num_lotes; k++) {
+        if (lotes[k].num < 0 || (lotes[k].num > 0 && (!lotes[k].frequencia || !lotes[k].x || !lotes[k].y))) return -1;
+        total += lotes[k].num;
+    }
+    if (total == 0) return 0;
+    if (total > INT_MAX - grafo->num_vertices) return -1;
+    
+    TrabalhoLotes t;
+    t.grafo = grafo;
+    t.lotes = lotes;
+    t.contagens = (int (*)[NUM_FREQUENCIAS])malloc((size_t)num_lotes * sizeof(*t.contagens));
+    t.assinaturas = (unsigned long long (*)[NUM_FREQUENCIAS])malloc((size_t)num_lotes * sizeof(*t.assinaturas));
+    t.primeiro = (int*)malloc((size_t)num_lotes * sizeof(int));
+    t.nos = NULL;
+    t.tamanho = grafo->pool_vertices.tamanho;
+    t.base = grafo->num_vertices;
+    t.total = (int)total;
+    t.cabeca = grafo->vertices;
+    
+    int resultado = (t.contagens && t.assinaturas && t.primeiro) ? juntar_lotes(&t, num_lotes, num_fios) : -2;
+    free(t.contagens);
+    free(t.assinaturas);
+    free(t.primeiro);
+    return resultado;
+}
+
+/**
+ * @brief Indica se um vértice pertence ao grafo (não foi removido)
+ * @param grafo Apontador para o grafo
+ * @param v Vértice a confirmar
+ * @return true se v for um vértice atual do grafo
+ * 
+ * @details O(1): o vértice tem de estar em por_id na posição do seu índice.
+ * Um vértice removido volta ao pool, cuja memória continua reservada, pelo
+ * que ler o seu índice não sai da memória do grafo.
+ */
+bool vertice_pertence(const Grafo* grafo, const Vertice* v) {
+    return grafo && v && v->id >= 0 && v->id < grafo->num_vertices && grafo->por_id[v->id] == v;
+}
+
+/**
+ * @brief Remove uma antena do grafo, com todas as suas arestas
+ * @param grafo Apontador para o grafo
+ * @param v Vértice a remover
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ * 
+ * @details O vetor da frequência mantém a ordem dos restantes vértices e o
+ * índice de coordenadas é atualizado no lugar. Para os índices continuarem
+ * densos, o vértice com o último índice passa a ter o índice do removido.
+ * Custa O(k), com k o número de antenas da frequência: cada aresta guarda a do
+ * sentido oposto e a sua anterior, pelo que a aresta de volta sai da lista do
+ * vizinho em O(1).
+ */
+int remover_vertice(Grafo* grafo, Vertice* v) {
+    if (!vertice_pertence(grafo, v)) return -1;
+    
+    unsigned char f = (unsigned char)v->frequencia;
+    
+    // Arestas, nos dois sentidos
+    Aresta* a = v->arestas;
+    while (a != NULL) {
+        Aresta* seguinte = a->proxima;
+        Vertice* u = a->destino;
+        if (u != v) {
+            Aresta* volta = a->par;
+            if (volta->anterior) {
+                volta->anterior->proxima = volta->proxima;
+            } else {
+                u->arestas = volta->proxima;
+            }
+            if (volta->proxima) volta->proxima->anterior = volta->anterior;
+            pool_devolver(&grafo->pool_arestas, volta);
+            grafo->assinatura[f] -= assinatura_ligacao(v, u);
+        }
+        pool_devolver(&grafo->pool_arestas, a);
+        a = seguinte;
+    }
+    v->arestas = NULL;
+    
+    // Vetor da frequência
+    Vertice** balde = grafo->por_frequencia[f];
+    int n = grafo->num_por_frequencia[f];
+    int i = 0;
+    while (i < n && balde[i] != v) i++;
+    if (i < n) {
+        memmove(&balde[i], &balde[i + 1], (size_t)(n - i - 1) * sizeof(Vertice*));
+        grafo->num_por_frequencia[f]--;
+    }
+    grafo->assinatura[f] -= assinatura_vertice(v);
+    grafo->espacial[f].valida = false;
+    
+    retirar_do_indice(grafo, v);
+    
+    // Lista de vértices
+    if (v->anterior) {
+        v->anterior->proximo = v->proximo;
+    } else {
+        grafo->vertices = v->proximo;
+    }
+    if (v->proximo) v->proximo->anterior = v->anterior;
+    
+    // Índices densos
+    Vertice* ultimo = grafo->por_id[grafo->num_vertices - 1];
+    ultimo->id = v->id;
+    grafo->por_id[v->id] = ultimo;
+    grafo->num_vertices--;
+    
+    pool_devolver(&grafo->pool_vertices, v);
+    return 0;
+}
+
+/**
+ * @brief Muda uma antena de posição
+ * @param grafo Apontador para o grafo
+ * @param v Vértice a mover
+ * @param x Nova coordenada x (coluna)
+ * @param y Nova coordenada y (linha)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 se a nova posição estiver ocupada
+ * 
+ * @details A antena mantém o índice, a frequência e as arestas; só o índice de
+ * coordenadas e a assinatura da frequência mudam, e a grelha espacial da
+ * frequência deixa de ser válida até à próxima indexar_grafo
+ */
+int mover_vertice(Grafo* grafo, Vertice* v, int x, int y) {
+    if (!grafo || !v) return -1;
+    if (v->x == x && v->y == y) return 0;
+    if (encontrar_vertice(grafo, x, y) != NULL) return -2;
+    
+    unsigned char f = (unsigned char)v->frequencia;
+    for (Aresta* a = v->arestas; a != NULL; a = a->proxima) {
+        if (a->destino != v) grafo->assinatura[f] -= assinatura_ligacao(v, a->destino);
+    }
+    grafo->assinatura[f] -= assinatura_vertice(v);
+    retirar_do_indice(grafo, v);
+    
+    v->x = x;
+    v->y = y;
+    
+    inserir_no_indice(grafo->indice, grafo->cap_indice, v);
+    grafo->espacial[f].valida = false;
+    grafo->assinatura[f] += assinatura_vertice(v);
+    for (Aresta* a = v->arestas; a != NULL; a = a->proxima) {
+        if (a->destino != v) grafo->assinatura[f] += assinatura_ligacao(v, a->destino);
+    }
+    return 0;
+}
+
+/**
+ * @brief Obtém a assinatura do conjunto de antenas de uma frequência
+ * @param grafo Apontador para o grafo
+ * @param freq Frequência
+ * @return Assinatura (0 se a frequência não tiver antenas)
+ * 
+ * @details A assinatura é a soma de uma dispersão da posição de cada antena e,
+ * no modo explícito, de cada aresta. Não depende da ordem das alterações: dois
+ * grafos com as mesmas antenas e ligações numa frequência têm a mesma assinatura.
+ * É mantida por cada operação sobre vértices e arestas, sem percorrer o grafo.
+ * As chaves da cache de resultados (cache.h) incluem-na, pelo que alterar uma
+ * frequência deixa de fora os resultados guardados antes da alteração.
+ */
+unsigned long long assinatura_frequencia(Grafo* grafo, char freq) {
+    if (!grafo) return 0;
+    return grafo->assinatura[(unsigned char)freq];
+}
+
+/**
+ * @brief Adiciona uma aresta entre dois vértices (antenas da mesma frequência)
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 se frequências diferentes
+ * 
+ * @details A aresta é bidirecional (grafo não direcionado) e não são permitidas:
+ * - Arestas entre vértices com frequências diferentes
+ * - Arestas duplicadas entre o mesmo par de vértices
+ */
+int adicionar_aresta(Grafo* grafo, Vertice* origem, Vertice* destino) {
+    if (!grafo || !origem || !destino) return -1;
+    if (origem->frequencia != destino->frequencia) return -2;
+    
+    // Verificar se aresta já existe
+    Aresta* a = origem->arestas;
+    while (a != NULL) {
+        ESTAT_SOMAR(grafo->estatisticas.verificacoes_duplicados, 1);
+        if (a->destino == destino) return 0;
+        a = a->proxima;
+    }
+    
+    return adicionar_aresta_nova(grafo, origem, destino);
+}
+
+/**
+ * @brief Adiciona uma aresta nova entre dois vértices sem verificar duplicados
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 se frequências diferentes
+ * 
+ * @details Variante de adicionar_aresta para quem já sabe que o par ainda não
+ * está ligado (por exemplo, o carregamento do mapa, que gera cada par uma única vez).
+ * Evita percorrer a lista de arestas da origem, pelo que a inserção é O(1).
+ */
+int adicionar_aresta_nova(Grafo* grafo, Vertice* origem, Vertice* destino) {
+    if (!grafo || !origem || !destino) return -1;
+    if (origem->frequencia != destino->frequencia) return -2;
+    
+    Aresta* ida = (Aresta*)pool_reservar(&grafo->pool_arestas);
+    if (!ida) return -3;
+    Aresta* volta = (Aresta*)pool_reservar(&grafo->pool_arestas);
+    if (!volta) {
+        pool_devolver(&grafo->pool_arestas, ida);
+        return -4;
+    }
+    
+    ligar_arestas(origem, ida, destino, volta);
+    
+    if (origem != destino) {
+        grafo->assinatura[(unsigned char)origem->frequencia] += assinatura_ligacao(origem, destino);
+    }
+    ESTAT_SOMAR(grafo->estatisticas.arestas_criadas, 1);
+    return 0;
+}
+
+/**
+ * @brief Estado partilhado de ligar_frequencias
+ */
+typedef struct {
+    Grafo* grafo;                       ///< Grafo a ligar
+    int frequencias[NUM_FREQUENCIAS];   ///< Frequências com pares, da maior para a menor
+    size_t inicio[NUM_FREQUENCIAS];     ///< Primeira aresta de cada frequência no bloco
+    char* nos;                          ///< Bloco com as arestas de todas as frequências
+    size_t tamanho;                     ///< Distância em bytes entre arestas consecutivas
+} TrabalhoLigacao;
+
+/**
+ * @brief Liga todos os pares de antenas de uma frequência
+ * @param dados Apontador para o TrabalhoLigacao
+ * @param k Posição da frequência em TrabalhoLigacao.frequencias
+ * 
+ * @details Mesma ordem que uma sequência de adicionar_aresta_nova, do último
+ * vértice do vetor para o primeiro; cada frequência só toca nas listas dos
+ * seus vértices e na sua parte do bloco de arestas
+ */
+static void ligar_frequencia(void* dados, int k) {
+    TrabalhoLigacao* t = (TrabalhoLigacao*)dados;
+    int f = t->frequencias[k];
+    Vertice** balde = t->grafo->por_frequencia[f];
+    char* proxima = t->nos + t->inicio[f] * t->tamanho;
+    unsigned long long assinatura = 0;
+    
+    for (int i = t->grafo->num_por_frequencia[f] - 1; i > 0; i--) {
+        for (int j = i - 1; j >= 0; j--) {
+            Aresta* ida = (Aresta*)proxima;
+            Aresta* volta = (Aresta*)(proxima + t->tamanho);
+            proxima += 2 * t->tamanho;
+            
+            ligar_arestas(balde[i], ida, balde[j], volta);
+            
+            assinatura += assinatura_ligacao(balde[i], balde[j]);
+        }
+    }
+    t->grafo->assinatura[f] += assinatura;
+}
+
+/**
+ * @brief Liga entre si todas as antenas de cada frequência, repartindo as frequências por vários fios
+ * @param grafo Apontador para o grafo (modo explícito)
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Produz as mesmas listas que chamar adicionar_aresta_nova para cada
+ * par (balde[i], balde[j]), com i do fim do vetor para o início e j < i também
+ * por ordem decrescente, que é a ligação feita pelo carregamento do mapa. Não
+ * procura duplicados. As arestas de todas as frequências são reservadas num só
+ * bloco do pool, já divididas por frequência, e as frequências são distribuídas
+ * pelos fios da maior para a menor.
+ */
+int ligar_frequencias(Grafo* grafo, int num_fios) {
+    if (!grafo || num_fios < 0 || grafo->modo != ARESTAS_EXPLICITAS) return -1;
+    
+    TrabalhoLigacao t;
+    t.grafo = grafo;
+    t.tamanho = grafo->pool_arestas.tamanho;
+    int num = 0;
+    size_t total = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        size_t k = (size_t)grafo->num_por_frequencia[f];
+        t.inicio[f] = total;
+        if (k < 2) continue;
+        if (k * (k - 1) > SIZE_MAX / t.tamanho - total) return -2;
+        total += k * (k - 1);
+        // Inserção ordenada: da frequência com mais antenas para a com menos
+        int i = num++;
+        while (i > 0 && grafo->num_por_frequencia[t.frequencias[i - 1]] < (int)k) {
+            t.frequencias[i] = t.frequencias[i - 1];
+            i--;
+        }
+        t.frequencias[i] = f;
+    }
+    if (total == 0) return 0;
+    
+    t.nos = (char*)pool_reservar_vetor(&grafo->pool_arestas, total);
+    if (!t.nos) return -2;
+    executar_tarefas(ligar_frequencia, &t, num, num_fios);
+    ESTAT_SOMAR(grafo->estatisticas.arestas_criadas, total / 2);
+    return 0;
+}
+
+/**
+ * @brief Prepara um iterador sobre os vizinhos de um vértice
+ * @param grafo Apontador para o grafo
+ * @param v Vértice cujos vizinhos se pretende percorrer
+ * @param[out] it Iterador a inicializar
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ * 
+ * @details No modo implícito os vizinhos são os restantes vértices da mesma
+ * frequência, percorridos por ordem de inserção. É a mesma ordem que o
+ * carregamento do mapa produz nas listas de arestas do modo explícito.
+ */
+int iniciar_vizinhos(const Grafo* grafo, Vertice* v, IteradorVizinhos* it) {
+    if (!grafo || !v || !it) return -1;
+    
+    it->origem = v;
+    if (grafo->modo == ARESTAS_IMPLICITAS) {
+        unsigned char f = (unsigned char)v->frequencia;
+        it->aresta = NULL;
+        it->balde = grafo->por_frequencia[f];
+        it->indice = 0;
+        it->total = grafo->num_por_frequencia[f];
+    } else {
+        it->aresta = v->arestas;
+        it->balde = NULL;
+        it->indice = 0;
+        it->total = 0;
+    }
+    return 0;
+}
+
+/**
+ * @brief Devolve o próximo vizinho de um iterador
+ * @param it Iterador inicializado com iniciar_vizinhos
+ * @return Próximo vizinho ou NULL quando não existem mais
+ */
+Vertice* proximo_vizinho(IteradorVizinhos* it) {
+    if (it->balde) {
+        while (it->indice < it->total) {
+            Vertice* u = it->balde[it->indice++];
+            if (u != it->origem) return u;
+        }
+        return NULL;
+    }
+    
+    if (it->aresta == NULL) return NULL;
+    Vertice* u = it->aresta->destino;
+    it->aresta = it->aresta->proxima;
+    return u;
+}
+
+/**
+ * @brief Função de visita que imprime o vértice visitado
+ * @param v Vértice visitado
+ * @param dados Não usado
+ * @return 0, para a procura continuar
+ * 
+ * @details É a função usada por procura_profundidade e procura_largura
+ */
+int imprimir_visita(Vertice* v, void* dados) {
+    (void)dados;
+    printf("Visitando: %c (%d,%d)\n", v->frequencia, v->x, v->y);
+    return 0;
+}
+
+/**
+ * @brief Prepara um contexto de procura vazio
+ * @param ctx Contexto a inicializar
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ * 
+ * @details Não reserva memória: as marcas, a fila e a pilha crescem na
+ * primeira procura que as usa
+ */
+int contexto_iniciar(ContextoProcura* ctx) {
+    if (!ctx) return -1;
+    ctx->marcas = NULL;
+    ctx->cap_marcas = 0;
+    ctx->anteriores = NULL;
+    ctx->epoca = 1;
+    ctx->fila = NULL;
+    ctx->cap_fila = 0;
+    ctx->pilha = NULL;
+    ctx->cap_pilha = 0;
+    pool_iniciar(&ctx->pool_caminho, sizeof(CaminhoNode));
+    estatisticas_limpar(&ctx->estatisticas);
+    return 0;
+}
+
+/**
+ * @brief Liberta a memória de um contexto de procura
+ * @param ctx Contexto a libertar
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ * 
+ * @details O contexto fica vazio e pode voltar a ser usado
+ */
+int contexto_libertar(ContextoProcura* ctx) {
+    if (!ctx) return -1;
+    free(ctx->marcas);
+    free(ctx->anteriores);
+    free(ctx->fila);
+    free(ctx->pilha);
+    pool_libertar(&ctx->pool_caminho);
+    return contexto_iniciar(ctx);
+}
+
+/**
+ * @brief Garante espaço na pilha da procura em profundidade para mais um nível
+ * @param ctx Contexto da procura
+ * @param tamanho Número de níveis já ocupados
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
+ */
+static int reservar_pilha(ContextoProcura* ctx, int tamanho) {
+    if (tamanho < ctx->cap_pilha) return 0;
+    int nova_cap = ctx->cap_pilha ? 2 * ctx->cap_pilha : 64;
+    IteradorVizinhos* nova = (IteradorVizinhos*)realloc(ctx->pilha, nova_cap * sizeof(IteradorVizinhos));
+    if (!nova) return -1;
+    ctx->pilha = nova;
+    ctx->cap_pilha = nova_cap;
+    return 0;
+}
+
+/**
+ * @brief Executa uma procura em profundidade (DFS) a partir de um vértice
+ * @param grafo Apontador para o grafo
+ * @param inicio Vértice de início da procura
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Imprime as coordenadas de cada vértice à medida que o visita
+ */
+int procura_profundidade(Grafo* grafo, Vertice* inicio) {
+    return procura_profundidade_visitar(grafo, inicio, imprimir_visita, NULL);
+}
+
+/**
+ * @brief Executa uma procura em profundidade chamando uma função para cada vértice
+ * @param grafo Apontador para o grafo
+ * @param inicio Vértice de início da procura
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 se a procura terminou, 1 se foi interrompida pela função de visita,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details DFS iterativo com uma pilha explícita de iteradores de vizinhos:
+ * o topo da pilha é o vértice cujos vizinhos estão a ser explorados. A ordem
+ * de visita é a mesma da versão recursiva, mas a profundidade deixa de estar
+ * limitada pela pilha de chamadas. Usa o contexto de procura do grafo.
+ */
+int procura_profundidade_visitar(Grafo* grafo, Vertice* inicio, FuncaoVisita visita, void* dados) {
+    if (!grafo) return -1;
+    return procura_profundidade_visitar_ctx(grafo, &grafo->contexto, inicio, visita, dados);
+}
+
+/**
+ * @brief Igual a procura_profundidade_visitar, mas com o estado da procura num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto da procura (marcas, pilha e contadores)
+ * @param inicio Vértice de início da procura
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 se a procura terminou, 1 se foi interrompida pela função de visita,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ */
+int procura_profundidade_visitar_ctx(const Grafo* grafo, ContextoProcura* ctx, Vertice* inicio,
+                                     FuncaoVisita visita, void* dados) {
+    if (!grafo || !ctx || !inicio || !visita) return -1;
+    if (reservar_pilha(ctx, 0) != 0 || contexto_preparar(ctx, grafo) != 0) return -2;
+    ESTAT_INICIAR_TEMPO(inicio_fase);
+    
+    int resultado = 0;
+    int tamanho = 0;
+    marcar_visitado(ctx, inicio);
+    if (visita(inicio, dados) != 0) {
+        resultado = 1;
+    } else {
+        iniciar_vizinhos(grafo, inicio, &ctx->pilha[0]);
+        tamanho = 1;
+    }
+    
+    while (resultado == 0 && tamanho > 0) {
+        Vertice* u = proximo_vizinho(&ctx->pilha[tamanho - 1]);
+        if (u == NULL) {
+            tamanho--;
+            continue;
+        }
+        if (foi_visitado(ctx, u)) continue;
+        
+        marcar_visitado(ctx, u);
+        if (visita(u, dados) != 0) {
+            resultado = 1;
+        } else if (reservar_pilha(ctx, tamanho) != 0) {
+            resultado = -2;
+        } else {
+            iniciar_vizinhos(grafo, u, &ctx->pilha[tamanho]);
+            tamanho++;
+            ESTAT_MAXIMO(ctx->estatisticas.profundidade_procura, tamanho);
+        }
+    }
+    ESTAT_TERMINAR_TEMPO(&ctx->estatisticas, FASE_PROCURA_PROFUNDIDADE, inicio_fase);
+    return resultado;
+}
+
+/**
+ * @brief Garante que a fila da procura em largura comporta todos os vértices
+ * @param ctx Contexto da procura
+ * @param grafo Grafo a percorrer
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
+ */
+static int reservar_fila(ContextoProcura* ctx, const Grafo* grafo) {
+    if (ctx->cap_fila >= grafo->num_vertices) return 0;
+    Vertice** nova = (Vertice**)realloc(ctx->fila, grafo->num_vertices * sizeof(Vertice*));
+    if (!nova) return -1;
+    ctx->fila = nova;
+    ctx->cap_fila = grafo->num_vertices;
+    return 0;
+}
+
+/**
+ * @brief Executa uma procura em largura (BFS) a partir de um vértice
+ * @param grafo Apontador para o grafo
+ * @param inicio Vértice de início da procura
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Imprime as coordenadas de cada vértice à medida que o visita
+ */
+int procura_largura(Grafo* grafo, Vertice* inicio) {
+    return procura_largura_visitar(grafo, inicio, imprimir_visita, NULL);
+}
+
+/**
+ * @brief Executa uma procura em largura chamando uma função para cada vértice
+ * @param grafo Apontador para o grafo
+ * @param inicio Vértice de início da procura
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 se a procura terminou, 1 se foi interrompida pela função de visita,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Implementa BFS usando uma fila para visitar os vértices
+ * por níveis de proximidade ao vértice inicial. A fila é um vetor circular
+ * do contexto com num_vertices posições (cada vértice entra no máximo uma vez),
+ * alocado uma única vez e reutilizado nas procuras seguintes. Usa o
+ * contexto de procura do grafo.
+ */
+int procura_largura_visitar(Grafo* grafo, Vertice* inicio, FuncaoVisita visita, void* dados) {
+    if (!grafo) return -1;
+    return procura_largura_visitar_ctx(grafo, &grafo->contexto, inicio, visita, dados);
+}
+
+/**
+ * @brief Igual a procura_largura_visitar, mas com o estado da procura num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto da procura (marcas, fila e contadores)
+ * @param inicio Vértice de início da procura
+ * @param visita Função chamada para cada vértice visitado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 se a procura terminou, 1 se foi interrompida pela função de visita,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ */
+int procura_largura_visitar_ctx(const Grafo* grafo, ContextoProcura* ctx, Vertice* inicio,
+                                FuncaoVisita visita, void* dados) {
+    if (!grafo || !ctx || !inicio || !visita) return -1;
+    if (reservar_fila(ctx, grafo) != 0 || contexto_preparar(ctx, grafo) != 0) return -2;
+    
+    ESTAT_INICIAR_TEMPO(inicio_fase);
+    Vertice** fila = ctx->fila;
+    int cap = ctx->cap_fila;
+    int cabeca = 0, tamanho = 0;
+    int resultado = 0;
+    
+    // Adicionar início na fila
+    fila[0] = inicio;
+    tamanho = 1;
+    marcar_visitado(ctx, inicio);
+    ESTAT_SOMAR(ctx->estatisticas.enfileirados, 1);
+    
+    while (tamanho > 0) {
+        // Remover da fila
+        Vertice* atual = fila[cabeca];
+        if (++cabeca == cap) cabeca = 0;
+        tamanho--;
+        if (visita(atual, dados) != 0) {
+            resultado = 1;
+            break;
+        }
+        
+        // Adicionar vizinhos
+        IteradorVizinhos it;
+        iniciar_vizinhos(grafo, atual, &it);
+        Vertice* u;
+        while ((u = proximo_vizinho(&it)) != NULL) {
+            if (!foi_visitado(ctx, u)) {
+                marcar_visitado(ctx, u);
+                int cauda = cabeca + tamanho;
+                if (cauda >= cap) cauda -= cap;
+                fila[cauda] = u;
+                tamanho++;
+                ESTAT_SOMAR(ctx->estatisticas.enfileirados, 1);
+            }
+        }
+    }
+    ESTAT_TERMINAR_TEMPO(&ctx->estatisticas, FASE_PROCURA_LARGURA, inicio_fase);
+    return resultado;
+}
+
+/**
+ * @brief Imprime um caminho na ordem inversa (auxiliar para encontrar_caminhos_rec)
+ * @param caminho Apontador para o nó do caminho a imprimir
+ * 
+ * @details Usa recursão para imprimir o caminho desde o fim até ao início
+ */
+void imprimir_caminho_inverso(CaminhoNode* caminho) {
+    if (caminho == NULL) return;
+    imprimir_caminho_inverso(caminho->prox);
+    printf("%c(%d,%d) ", caminho->vertice->frequencia, caminho->vertice->x, caminho->vertice->y);
+}
+
+/**
+ * @brief Função de caminho que imprime o caminho numerado
+ * @param caminho Último nó do caminho
+ * @param comprimento Número de vértices no caminho
+ * @param dados Apontador para o contador de caminhos (int), incrementado a cada caminho
+ * @return 0, para a procura continuar
+ * 
+ * @details É a função usada por encontrar_caminhos
+ */
+int imprimir_caminho(CaminhoNode* caminho, int comprimento, void* dados) {
+    (void)comprimento;
+    int* contador = (int*)dados;
+    (*contador)++;
+    printf("Caminho %d: ", *contador);
+    imprimir_caminho_inverso(caminho);
+    printf("\n");
+    return 0;
+}
+
+/**
+ * @brief Passo recursivo da procura de caminhos, com o estado num contexto
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto da procura (marcas, nós de caminho e contadores)
+ * @param atual Vértice atual na procura
+ * @param destino Vértice de destino
+ * @param caminho_atual Caminho percorrido até ao momento
+ * @param comprimento Número de vértices em caminho_atual
+ * @param max_saltos Número máximo de arestas por caminho (0 para não limitar)
+ * @param visita Função chamada para cada caminho encontrado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 em caso de sucesso, 1 se a função de visita pediu para terminar,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details As marcas do contexto já cobrem todos os vértices do grafo
+ */
+static int caminhos_rec_ctx(const Grafo* grafo, ContextoProcura* ctx, Vertice* atual, Vertice* destino,
+                            CaminhoNode* caminho_atual, int comprimento, int max_saltos,
+                            FuncaoCaminho visita, void* dados) {
+    // Adicionar vértice atual ao caminho
+    CaminhoNode* novo_no = (CaminhoNode*)pool_reservar(&ctx->pool_caminho);
+    if (!novo_no) return -2;
+    novo_no->vertice = atual;
+    novo_no->prox = caminho_atual;
+    
+    ESTAT_MAXIMO(ctx->estatisticas.profundidade_caminhos, comprimento + 1);
+    int resultado = 0;
+    if (atual == destino) {
+        if (visita(novo_no, comprimento + 1, dados) != 0) resultado = 1;
+    } else if (max_saltos == 0 || comprimento < max_saltos) {
+        marcar_visitado(ctx, atual);
+        IteradorVizinhos it;
+        iniciar_vizinhos(grafo, atual, &it);
+        Vertice* u;
+        while (resultado == 0 && (u = proximo_vizinho(&it)) != NULL) {
+            if (!foi_visitado(ctx, u)) {
+                resultado = caminhos_rec_ctx(grafo, ctx, u, destino, novo_no, comprimento + 1,
+                                             max_saltos, visita, dados);
+            }
+        }
+        desmarcar_visitado(ctx, atual);
+    }
+    
+    pool_devolver(&ctx->pool_caminho, novo_no);
+    return resultado;
+}
+
+/**
+ * @brief Função recursiva auxiliar para encontrar todos os caminhos entre dois vértices
+ * @param grafo Apontador para o grafo
+ * @param atual Vértice atual na procura
+ * @param destino Vértice de destino
+ * @param caminho_atual Caminho percorrido até ao momento
+ * @param comprimento Número de vértices em caminho_atual
+ * @param max_saltos Número máximo de arestas por caminho (0 para não limitar)
+ * @param visita Função chamada para cada caminho encontrado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 em caso de sucesso, 1 se a função de visita pediu para terminar,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Implementa DFS modificado para encontrar todos os caminhos possíveis,
+ * usando backtracking e marcadores de visita. Os nós do caminho vêm do pool
+ * de rascunho do contexto do grafo e são devolvidos ao retroceder. Com
+ * max_saltos, não desce abaixo da profundidade máxima. Continua a procura
+ * atual: as marcas de visita não são reiniciadas.
+ */
+int encontrar_caminhos_rec(Grafo* grafo, Vertice* atual, Vertice* destino, CaminhoNode* caminho_atual,
+                           int comprimento, int max_saltos, FuncaoCaminho visita, void* dados) {
+    if (!grafo || !atual || !destino || !visita) return -1;
+    ContextoProcura* ctx = &grafo->contexto;
+    if (ctx->cap_marcas < grafo->num_vertices) {
+        // Marcas por criar: é o início de uma procura
+        if (contexto_preparar(ctx, grafo) != 0) return -2;
+    }
+    return caminhos_rec_ctx(grafo, ctx, atual, destino, caminho_atual, comprimento, max_saltos, visita, dados);
+}
+
+/**
+ * @brief Encontra e imprime todos os caminhos entre duas antenas
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ * 
+ * @details Equivale a encontrar_caminhos_limitado sem limites
+ */
+int encontrar_caminhos(Grafo* grafo, Vertice* origem, Vertice* destino) {
+    return encontrar_caminhos_limitado(grafo, origem, destino, 0, 0);
+}
+
+/**
+ * @brief Estado da função de caminho que imprime até um número máximo de caminhos
+ */
+typedef struct {
+    int contador;           ///< Caminhos impressos até ao momento
+    int max_caminhos;       ///< Número máximo de caminhos a imprimir (0 para não limitar)
+} LimiteCaminhos;
+
+/**
+ * @brief Imprime o caminho e pede para terminar quando o limite é atingido
+ * @param caminho Último nó do caminho
+ * @param comprimento Número de vértices no caminho
+ * @param dados Apontador para LimiteCaminhos
+ * @return 0 para continuar, 1 quando já foram impressos max_caminhos caminhos
+ */
+static int imprimir_caminho_limitado(CaminhoNode* caminho, int comprimento, void* dados) {
+    LimiteCaminhos* limite = (LimiteCaminhos*)dados;
+    imprimir_caminho(caminho, comprimento, &limite->contador);
+    return limite->max_caminhos > 0 && limite->contador >= limite->max_caminhos;
+}
+
+/**
+ * @brief Imprime no máximo max_caminhos caminhos com no máximo max_saltos arestas
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_caminhos Número máximo de caminhos a imprimir (0 para não limitar)
+ * @param max_saltos Número máximo de arestas por caminho (0 para não limitar)
+ * @return 0 em caso de sucesso, 1 se o limite de caminhos foi atingido,
+ * -1 em caso de erro, -2 se alguma antena não existir, -3 se as frequências forem diferentes
+ * 
+ * @details Verifica previamente:
+ * - Existência dos vértices
+ * - Se têm a mesma frequência
+ * 
+ * Cada caminho é impresso pela função imprimir_caminho. Quando o limite de
+ * caminhos é atingido, o total existente é obtido com contar_caminhos.
+ */
+int encontrar_caminhos_limitado(Grafo* grafo, Vertice* origem, Vertice* destino, int max_caminhos, int max_saltos) {
+    if (!grafo) return -1;
+    
+    if (origem == NULL || destino == NULL) {
+        printf("\nNao foi possivel encontrar caminhos:\n");
+        if (origem == NULL && destino == NULL) {
+            printf("- Ambas as antenas nao existem no mapa\n");
+        } else if (origem == NULL) {
+            printf("- Antena de origem nao existe no mapa\n");
+        } else {
+            printf("- Antena de destino nao existe no mapa\n");
+        }
+        return -2;
+    }
+    
+    if (origem->frequencia != destino->frequencia) {
+        printf("\nNao existem caminhos entre %c(%d,%d) e %c(%d,%d)\n", 
+               origem->frequencia, origem->x, origem->y,
+               destino->frequencia, destino->x, destino->y);
+        printf("- As antenas tem frequencias diferentes (%c e %c)\n", 
+               origem->frequencia, destino->frequencia);
+        return -3;
+    }
+    
+    printf("\n=== Caminhos entre %c(%d,%d) e %c(%d,%d) ===\n",
+           origem->frequencia, origem->x, origem->y,
+           destino->frequencia, destino->x, destino->y);
+    
+    LimiteCaminhos limite = { 0, max_caminhos };
+    int resultado = encontrar_caminhos_visitar_limitado(grafo, origem, destino, max_saltos,
+                                                        imprimir_caminho_limitado, &limite);
+    
+    if (limite.contador == 0) {
+        printf("Nenhum caminho encontrado entre as antenas\n");
+    } else if (resultado == 1) {
+        unsigned long long total;
+        if (contar_caminhos(grafo, origem, destino, max_saltos, &total) == 1) {
+            printf("Limite de %d caminhos atingido (existem mais de %llu)\n", max_caminhos, total);
+        } else {
+            printf("Limite de %d caminhos atingido (existem %llu)\n", max_caminhos, total);
+        }
+    } else {
+        printf("Total de caminhos encontrados: %d\n", limite.contador);
+    }
+    
+    return resultado;
+}
+
+/**
+ * @brief Encontra todos os caminhos entre duas antenas, chamando uma função para cada um
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param visita Função chamada para cada caminho encontrado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 em caso de sucesso, 1 se a função de visita pediu para terminar,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Não imprime nada: cabe à função de visita recolher, contar ou
+ * mostrar os caminhos. Antenas de frequências diferentes não têm caminhos.
+ */
+int encontrar_caminhos_visitar(Grafo* grafo, Vertice* origem, Vertice* destino, FuncaoCaminho visita, void* dados) {
+    return encontrar_caminhos_visitar_limitado(grafo, origem, destino, 0, visita, dados);
+}
+
+/**
+ * @brief Igual a encontrar_caminhos_visitar, mas ignora caminhos com mais de max_saltos arestas
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas por caminho (0 para não limitar)
+ * @param visita Função chamada para cada caminho encontrado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 em caso de sucesso, 1 se a função de visita pediu para terminar,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Usa o contexto de procura do grafo
+ */
+int encontrar_caminhos_visitar_limitado(Grafo* grafo, Vertice* origem, Vertice* destino, int max_saltos,
+                                        FuncaoCaminho visita, void* dados) {
+    if (!grafo) return -1;
+    return encontrar_caminhos_visitar_limitado_ctx(grafo, &grafo->contexto, origem, destino, max_saltos,
+                                                   visita, dados);
+}
+
+/**
+ * @brief Igual a encontrar_caminhos_visitar_limitado, mas com o estado da procura num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto da procura (marcas, nós de caminho e contadores)
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas por caminho (0 para não limitar)
+ * @param visita Função chamada para cada caminho encontrado
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 em caso de sucesso, 1 se a função de visita pediu para terminar,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ */
+int encontrar_caminhos_visitar_limitado_ctx(const Grafo* grafo, ContextoProcura* ctx, Vertice* origem,
+                                            Vertice* destino, int max_saltos, FuncaoCaminho visita, void* dados) {
+    if (!grafo || !ctx || !origem || !destino || !visita || max_saltos < 0) return -1;
+    if (origem->frequencia != destino->frequencia) return 0;
+    
+    ESTAT_INICIAR_TEMPO(inicio_fase);
+    if (contexto_preparar(ctx, grafo) != 0) return -2;
+    pool_reiniciar(&ctx->pool_caminho);
+    int resultado = caminhos_rec_ctx(grafo, ctx, origem, destino, NULL, 0, max_saltos, visita, dados);
+    ESTAT_TERMINAR_TEMPO(&ctx->estatisticas, FASE_CAMINHOS, inicio_fase);
+    return resultado;
+}
+
+/**
+ * @brief Função de caminho que apenas conta, saturando em ULLONG_MAX
+ * @param caminho Não usado
+ * @param comprimento Não usado
+ * @param dados Apontador para o contador (unsigned long long)
+ * @return 0 para continuar, 1 quando o contador satura
+ */
+static int contar_caminho(CaminhoNode* caminho, int comprimento, void* dados) {
+    (void)caminho;
+    (void)comprimento;
+    unsigned long long* total = (unsigned long long*)dados;
+    if (*total == ULLONG_MAX) return 1;
+    (*total)++;
+    return 0;
+}
+
+/**
+ * @brief Verifica se as antenas de uma frequência formam um grafo completo
+ * @param grafo Apontador para o grafo
+ * @param freq Frequência a verificar
+ * @return true se cada antena da frequência está ligada a todas as outras
+ * 
+ * @details No modo implícito é sempre verdade. No modo explícito compara o grau
+ * de cada antena com k-1, assumindo (como garante adicionar_aresta) que não há
+ * arestas duplicadas nem entre frequências diferentes.
+ */
+static bool frequencia_completa(const Grafo* grafo, char freq) {
+    if (grafo->modo == ARESTAS_IMPLICITAS) return true;
+    
+    unsigned char f = (unsigned char)freq;
+    int k = grafo->num_por_frequencia[f];
+    for (int i = 0; i < k; i++) {
+        Vertice* v = grafo->por_frequencia[f][i];
+        int grau = 0;
+        Aresta* a = v->arestas;
+        while (a != NULL) {
+            if (a->destino == v) return false;
+            grau++;
+            a = a->proxima;
+        }
+        if (grau != k - 1) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Conta os caminhos simples entre duas antenas sem os enumerar
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas por caminho (0 para não limitar)
+ * @param[out] total Número de caminhos (saturado em ULLONG_MAX)
+ * @return 0 se o valor é exato, 1 se saturou, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Quando a frequência das antenas forma um grafo completo de k antenas
+ * (o caso do mapa carregado), um caminho com m antenas intermédias escolhe-as
+ * ordenadamente de entre as k-2 restantes, logo o total é a soma, para m de 0
+ * a k-2 (ou max_saltos-1), de (k-2)!/(k-2-m)!. Calcula-se em O(k) com
+ * aritmética saturada. Noutros grafos recorre à enumeração, apenas a contar,
+ * com o contexto de procura do grafo.
+ */
+int contar_caminhos(Grafo* grafo, Vertice* origem, Vertice* destino, int max_saltos, unsigned long long* total) {
+    if (!grafo) return -1;
+    return contar_caminhos_ctx(grafo, &grafo->contexto, origem, destino, max_saltos, total);
+}
+
+/**
+ * @brief Igual a contar_caminhos, mas enumera (quando precisa) com um contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto da procura
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas por caminho (0 para não limitar)
+ * @param[out] total Número de caminhos (saturado em ULLONG_MAX)
+ * @return 0 se o valor é exato, 1 se saturou, -1 em caso de erro, -2 em caso de erro de memória
+ */
+int contar_caminhos_ctx(const Grafo* grafo, ContextoProcura* ctx, Vertice* origem, Vertice* destino,
+                        int max_saltos, unsigned long long* total) {
+    if (!grafo || !ctx || !origem || !destino || !total || max_saltos < 0) return -1;
+    
+    *total = 0;
+    if (origem->frequencia != destino->frequencia) return 0;
+    if (origem == destino) {
+        *total = 1;
+        return 0;
+    }
+    
+    if (!frequencia_completa(grafo, origem->frequencia)) {
+        int resultado = encontrar_caminhos_visitar_limitado_ctx(grafo, ctx, origem, destino, max_saltos,
+                                                                contar_caminho, total);
+        if (resultado < 0) return resultado;
+        return *total == ULLONG_MAX;
+    }
+    
+    unsigned long long n = (unsigned long long)grafo->num_por_frequencia[(unsigned char)origem->frequencia] - 2;
+    unsigned long long max_m = n;
+    if (max_saltos > 0 && (unsigned long long)(max_saltos - 1) < max_m) max_m = max_saltos - 1;
+    
+    unsigned long long termo = 1;   // n!/(n-m)! para o m atual
+    unsigned long long soma = 1;    // m = 0: ligação direta
+    for (unsigned long long m = 1; m <= max_m; m++) {
+        unsigned long long fator = n - m + 1;
+        if (termo > ULLONG_MAX / fator || soma > ULLONG_MAX - termo * fator) {
+            *total = ULLONG_MAX;
+            return 1;
+        }
+        termo *= fator;
+        soma += termo;
+    }
+    *total = soma;
+    return 0;
+}
+
+/**
+ * @brief Monta o vetor de um caminho a partir dos anteriores guardados no contexto
+ * @param ctx Contexto da procura
+ * @param fim_origem Último vértice do lado da origem (os anteriores levam até à origem)
+ * @param inicio_destino Primeiro vértice do lado do destino (os anteriores levam até ao destino), ou NULL
+ * @param[out] caminho Vetor alocado com os vértices, de origem a destino (pode ser NULL)
+ * @return Número de vértices do caminho, ou -2 em caso de erro de memória
+ * 
+ * @details Os anteriores da origem e do destino são NULL
+ */
+static int montar_caminho(const ContextoProcura* ctx, Vertice* fim_origem, Vertice* inicio_destino,
+                          Vertice*** caminho) {
+    int n_origem = 0, n_destino = 0;
+    for (Vertice* v = fim_origem; v != NULL; v = ctx->anteriores[v->id]) n_origem++;
+    for (Vertice* v = inicio_destino; v != NULL; v = ctx->anteriores[v->id]) n_destino++;
+    if (!caminho) return n_origem + n_destino;
+    
+    Vertice** vetor = (Vertice**)malloc((n_origem + n_destino) * sizeof(Vertice*));
+    if (!vetor) return -2;
+    int i = n_origem;
+    for (Vertice* v = fim_origem; v != NULL; v = ctx->anteriores[v->id]) vetor[--i] = v;
+    i = n_origem;
+    for (Vertice* v = inicio_destino; v != NULL; v = ctx->anteriores[v->id]) vetor[i++] = v;
+    *caminho = vetor;
+    return n_origem + n_destino;
+}
+
+/**
+ * @brief Encontra um caminho com o menor número de saltos entre duas antenas
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas do caminho (0 para não limitar)
+ * @param[out] caminho Vetor alocado com os vértices do caminho, de origem a destino
+ * (a libertar com free; pode ser NULL se só interessar o comprimento)
+ * @return Número de vértices do caminho, 0 se destino não é alcançável,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Usa o contexto de procura do grafo
+ */
+int caminho_mais_curto(Grafo* grafo, Vertice* origem, Vertice* destino, int max_saltos, Vertice*** caminho) {
+    if (!grafo) return -1;
+    return caminho_mais_curto_ctx(grafo, &grafo->contexto, origem, destino, max_saltos, caminho);
+}
+
+/**
+ * @brief Igual a caminho_mais_curto, mas com o estado da procura num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto da procura
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas do caminho (0 para não limitar)
+ * @param[out] caminho Vetor alocado com os vértices do caminho (pode ser NULL)
+ * @return Número de vértices do caminho, 0 se destino não é alcançável,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Procura em largura por níveis a partir da origem, guardando para
+ * cada vértice o vértice de onde foi alcançado. Termina assim que o destino
+ * é descoberto, ou ao fim de max_saltos níveis. Cada vértice entra na fila no
+ * máximo uma vez, pelo que a fila do contexto não precisa de ser circular.
+ */
+int caminho_mais_curto_ctx(const Grafo* grafo, ContextoProcura* ctx, Vertice* origem, Vertice* destino,
+                           int max_saltos, Vertice*** caminho) {
+    if (!grafo || !ctx || !origem || !destino || max_saltos < 0) return -1;
+    if (caminho) *caminho = NULL;
+    if (origem->frequencia != destino->frequencia) return 0;
+    if (reservar_fila(ctx, grafo) != 0 || contexto_preparar(ctx, grafo) != 0) return -2;
+    
+    ESTAT_INICIAR_TEMPO(inicio_fase);
+    Vertice** fila = ctx->fila;
+    int cabeca = 0, cauda = 0;
+    fila[cauda++] = origem;
+    marcar_visitado(ctx, origem);
+    ctx->anteriores[origem->id] = NULL;
+    ESTAT_SOMAR(ctx->estatisticas.enfileirados, 1);
+    
+    bool encontrado = (origem == destino);
+    int saltos = 0;
+    while (!encontrado && cabeca < cauda && (max_saltos == 0 || saltos < max_saltos)) {
+        int fim_nivel = cauda;
+        saltos++;
+        while (!encontrado && cabeca < fim_nivel) {
+            Vertice* atual = fila[cabeca++];
+            IteradorVizinhos it;
+            iniciar_vizinhos(grafo, atual, &it);
+            Vertice* u;
+            while ((u = proximo_vizinho(&it)) != NULL) {
+                if (foi_visitado(ctx, u)) continue;
+                marcar_visitado(ctx, u);
+                ctx->anteriores[u->id] = atual;
+                if (u == destino) {
+                    encontrado = true;
+                    break;
+                }
+                fila[cauda++] = u;
+                ESTAT_SOMAR(ctx->estatisticas.enfileirados, 1);
+            }
+        }
+    }
+    
+    int resultado = encontrado ? montar_caminho(ctx, destino, NULL, caminho) : 0;
+    ESTAT_TERMINAR_TEMPO(&ctx->estatisticas, FASE_CAMINHO_MAIS_CURTO, inicio_fase);
+    return resultado;
+}
+
+/**
+ * @brief Uma das duas frentes da procura em largura bidirecional
+ * 
+ * @details As duas frentes partilham a fila do contexto: a da origem ocupa-a
+ * a partir do início e a do destino a partir do fim, em sentido contrário.
+ * Como cada vértice é marcado por uma só frente, nunca se sobrepõem.
+ */
+typedef struct {
+    Vertice** base;         ///< Primeira posição da frente na fila do contexto
+    int passo;              ///< 1 para a frente da origem, -1 para a do destino
+    int cabeca;             ///< Próximo vértice a expandir
+    int cauda;              ///< Número de vértices já postos na frente
+    int profundidade;       ///< Número de níveis já expandidos
+    unsigned int lado;      ///< Marca dos vértices alcançados por esta frente
+} FrenteProcura;
+
+/**
+ * @brief Expande um nível completo de uma frente da procura bidirecional
+ * @param grafo Apontador para o grafo
+ * @param ctx Contexto da procura
+ * @param frente Frente a expandir
+ * @param outro Marca da outra frente
+ * @param[out] ponte_frente Vértice da frente onde as duas procuras se encontraram
+ * @param[out] ponte_outra Vértice da outra frente, vizinho de ponte_frente
+ * @return true se as duas frentes se encontraram
+ */
+static bool expandir_frente(const Grafo* grafo, ContextoProcura* ctx, FrenteProcura* frente, unsigned int outro,
+                            Vertice** ponte_frente, Vertice** ponte_outra) {
+    int fim_nivel = frente->cauda;
+    frente->profundidade++;
+    while (frente->cabeca < fim_nivel) {
+        Vertice* atual = frente->base[frente->passo * frente->cabeca++];
+        IteradorVizinhos it;
+        iniciar_vizinhos(grafo, atual, &it);
+        Vertice* u;
+        while ((u = proximo_vizinho(&it)) != NULL) {
+            unsigned int marca = ctx->marcas[u->id];
+            if (marca == outro) {
+                *ponte_frente = atual;
+                *ponte_outra = u;
+                return true;
+            }
+            if (marca == frente->lado) continue;
+            ctx->marcas[u->id] = frente->lado;
+            ctx->anteriores[u->id] = atual;
+            frente->base[frente->passo * frente->cauda++] = u;
+            ESTAT_SOMAR(ctx->estatisticas.enfileirados, 1);
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Encontra um caminho mais curto com uma procura em largura a partir das duas pontas
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas do caminho (0 para não limitar)
+ * @param[out] caminho Vetor alocado com os vértices do caminho (pode ser NULL)
+ * @return Número de vértices do caminho, 0 se destino não é alcançável,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Usa o contexto de procura do grafo
+ */
+int caminho_mais_curto_bidirecional(Grafo* grafo, Vertice* origem, Vertice* destino, int max_saltos,
+                                    Vertice*** caminho) {
+    if (!grafo) return -1;
+    return caminho_mais_curto_bidirecional_ctx(grafo, &grafo->contexto, origem, destino, max_saltos, caminho);
+}
+
+/**
+ * @brief Igual a caminho_mais_curto_bidirecional, mas com o estado da procura num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto da procura
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas do caminho (0 para não limitar)
+ * @param[out] caminho Vetor alocado com os vértices do caminho (pode ser NULL)
+ * @return Número de vértices do caminho, 0 se destino não é alcançável,
+ * -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Avança, um nível de cada vez, a frente com menos vértices por
+ * expandir, até um vértice de uma frente ter um vizinho já alcançado pela
+ * outra. Como os níveis são expandidos por inteiro, o primeiro encontro dá um
+ * caminho mais curto. Numa componente grande visita da ordem de duas bolas de
+ * metade do raio em vez de uma bola do raio inteiro. As frentes usam duas
+ * épocas seguidas do contexto como marcas; as arestas são percorridas nos
+ * dois sentidos, o que pressupõe (como garante adicionar_aresta) um grafo não
+ * orientado.
+ */
+int caminho_mais_curto_bidirecional_ctx(const Grafo* grafo, ContextoProcura* ctx, Vertice* origem,
+                                        Vertice* destino, int max_saltos, Vertice*** caminho) {
+    if (!grafo || !ctx || !origem || !destino || max_saltos < 0) return -1;
+    if (caminho) *caminho = NULL;
+    if (origem->frequencia != destino->frequencia) return 0;
+    if (origem == destino) return caminho_mais_curto_ctx(grafo, ctx, origem, destino, max_saltos, caminho);
+    if (reservar_fila(ctx, grafo) != 0 || contexto_preparar(ctx, grafo) != 0) return -2;
+    
+    ESTAT_INICIAR_TEMPO(inicio_fase);
+    unsigned int lado_origem = ctx->epoca;
+    avancar_epoca(ctx);
+    if (ctx->epoca < lado_origem) {
+        // A época deu a volta e as marcas foram limpas: usar as duas primeiras
+        lado_origem = ctx->epoca;
+        avancar_epoca(ctx);
+    }
+    
+    FrenteProcura frentes[2] = {
+        { ctx->fila, 1, 0, 1, 0, lado_origem },
+        { ctx->fila + grafo->num_vertices - 1, -1, 0, 1, 0, ctx->epoca }
+    };
+    frentes[0].base[0] = origem;
+    frentes[1].base[0] = destino;
+    ctx->marcas[origem->id] = frentes[0].lado;
+    ctx->marcas[destino->id] = frentes[1].lado;
+    ctx->anteriores[origem->id] = NULL;
+    ctx->anteriores[destino->id] = NULL;
+    ESTAT_SOMAR(ctx->estatisticas.enfileirados, 2);
+    
+    Vertice* fim_origem = NULL;
+    Vertice* inicio_destino = NULL;
+    while (frentes[0].cabeca < frentes[0].cauda && frentes[1].cabeca < frentes[1].cauda &&
+           (max_saltos == 0 || frentes[0].profundidade + frentes[1].profundidade < max_saltos)) {
+        int f = (frentes[0].cauda - frentes[0].cabeca <= frentes[1].cauda - frentes[1].cabeca) ? 0 : 1;
+        Vertice* ponte_frente;
+        Vertice* ponte_outra;
+        if (expandir_frente(grafo, ctx, &frentes[f], frentes[1 - f].lado, &ponte_frente, &ponte_outra)) {
+            fim_origem = f == 0 ? ponte_frente : ponte_outra;
+            inicio_destino = f == 0 ? ponte_outra : ponte_frente;
+            break;
+        }
+    }
+    
+    int resultado = fim_origem ? montar_caminho(ctx, fim_origem, inicio_destino, caminho) : 0;
+    ESTAT_TERMINAR_TEMPO(&ctx->estatisticas, FASE_CAMINHO_MAIS_CURTO, inicio_fase);
+    return resultado;
+}
+
+/**
+ * @brief Indica se uma antena é alcançável a partir de outra em até max_saltos saltos
+ * @param grafo Apontador para o grafo
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas (0 para não limitar)
+ * @return 1 se é alcançável, 0 se não é, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Usa o contexto de procura do grafo
+ */
+int alcancavel(Grafo* grafo, Vertice* origem, Vertice* destino, int max_saltos) {
+    if (!grafo) return -1;
+    return alcancavel_ctx(grafo, &grafo->contexto, origem, destino, max_saltos);
+}
+
+/**
+ * @brief Igual a alcancavel, mas com o estado da procura num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto da procura
+ * @param origem Vértice de origem
+ * @param destino Vértice de destino
+ * @param max_saltos Número máximo de arestas (0 para não limitar)
+ * @return 1 se é alcançável, 0 se não é, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details É a procura bidirecional sem montar o caminho
+ */
+int alcancavel_ctx(const Grafo* grafo, ContextoProcura* ctx, Vertice* origem, Vertice* destino, int max_saltos) {
+    int resultado = caminho_mais_curto_bidirecional_ctx(grafo, ctx, origem, destino, max_saltos, NULL);
+    return resultado > 0 ? 1 : resultado;
+}
+
+/**
+ * @brief Calcula o ponto de intersecção entre duas linhas definidas por pares de pontos
+ * @param p1, p2 Pontos da primeira linha (freqA)
+ * @param p3, p4 Pontos da segunda linha (freqB)
+ * @param[out] x, y Coordenadas da interseção (se existir)
+ * @return true se as linhas se intersectam, false caso contrário
+ * 
+ * @details Usa o núcleo inteiro exato de intersecao.h: o teste de pertença aos
+ * segmentos não tem erros de arredondamento e as coordenadas são a truncagem
+ * do ponto racional exato
+ */
+bool calcular_intersecao(Vertice* p1, Vertice* p2, Vertice* p3, Vertice* p4, int* x, int* y) {
+    Segmento a = { p1->x, p1->y, p2->x, p2->y };
+    Segmento b = { p3->x, p3->y, p4->x, p4->y };
+    return intersetar_segmentos(&a, &b, x, y);
+}
+
+/**
+ * @brief Obtém a caixa envolvente das antenas de uma frequência
+ * @param grafo Apontador para o grafo
+ * @param f Frequência
+ * @param[out] caixa {min_x, min_y, max_x, max_y}
+ * @return false se a frequência não tiver antenas
+ * 
+ * @details Usa a caixa da grelha espacial se esta for válida (O(1)); caso
+ * contrário percorre as antenas da frequência
+ */
+static bool caixa_frequencia(const Grafo* grafo, unsigned char f, int* caixa) {
+    int n = grafo->num_por_frequencia[f];
+    if (n == 0) return false;
+    
+    const GrelhaPontos* g = &grafo->espacial[f];
+    if (g->valida && g->num == n) {
+        caixa[0] = g->min_x;
+        caixa[1] = g->min_y;
+        caixa[2] = g->max_x;
+        caixa[3] = g->max_y;
+        return true;
+    }
+    
+    Vertice** antenas = grafo->por_frequencia[f];
+    caixa[0] = caixa[2] = antenas[0]->x;
+    caixa[1] = caixa[3] = antenas[0]->y;
+    for (int i = 1; i < n; i++) {
+        if (antenas[i]->x < caixa[0]) caixa[0] = antenas[i]->x;
+        if (antenas[i]->y < caixa[1]) caixa[1] = antenas[i]->y;
+        if (antenas[i]->x > caixa[2]) caixa[2] = antenas[i]->x;
+        if (antenas[i]->y > caixa[3]) caixa[3] = antenas[i]->y;
+    }
+    return true;
+}
+
+/**
+ * @brief Obtém as caixas envolventes de duas frequências e indica se se tocam
+ * @param grafo Apontador para o grafo
+ * @param freqA Primeira frequência
+ * @param freqB Segunda frequência
+ * @param[out] caixaA Caixa das antenas de freqA
+ * @param[out] caixaB Caixa das antenas de freqB
+ * @return true se as duas caixas existirem e se intersectarem
+ * 
+ * @details Um segmento de freqA só pode cruzar um de freqB se tocar na caixa de
+ * freqB, e vice-versa; se as caixas forem disjuntas não há intersecções
+ */
+static bool caixas_sobrepostas(const Grafo* grafo, char freqA, char freqB, int* caixaA, int* caixaB) {
+    if (!caixa_frequencia(grafo, (unsigned char)freqA, caixaA) ||
+        !caixa_frequencia(grafo, (unsigned char)freqB, caixaB)) {
+        return false;
+    }
+    return caixaA[0] <= caixaB[2] && caixaB[0] <= caixaA[2] && caixaA[1] <= caixaB[3] && caixaB[1] <= caixaA[3];
+}
+
+/**
+ * @brief Recolhe, por ordem de iteração, os segmentos (pares de antenas ligadas) de uma frequência
+ * @param grafo Apontador para o grafo
+ * @param freq Frequência a considerar
+ * @param[out] lote Lote onde acrescentar os segmentos (já inicializado)
+ * @param[in,out] extremos Vetor com 2 vértices por segmento, realocado à medida (libertar com free)
+ * @param[in,out] cap_extremos Capacidade de extremos, em segmentos
+ * @param caixa Caixa {min_x, min_y, max_x, max_y}; só são recolhidos os segmentos
+ * cuja caixa envolvente lhe toca (NULL para recolher todos)
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
+ * 
+ * @details Cada ligação é recolhida uma única vez, do vértice de menor id para o
+ * de maior. Os segmentos são acrescentados a lote e a extremos, pelo que se podem
+ * juntar várias frequências no mesmo lote.
+ */
+static int recolher_segmentos(const Grafo* grafo, char freq, LoteSegmentos* lote, Vertice*** extremos, int* cap_extremos,
+                              const int* caixa) {
+    unsigned char f = (unsigned char)freq;
+    for (int i = grafo->num_por_frequencia[f] - 1; i >= 0; i--) {
+        Vertice* v1 = grafo->por_frequencia[f][i];
+        IteradorVizinhos it;
+        iniciar_vizinhos(grafo, v1, &it);
+        Vertice* v2;
+        while ((v2 = proximo_vizinho(&it)) != NULL) {
+            if (v1->id >= v2->id) continue;
+            if (caixa && ((v1->x < caixa[0] && v2->x < caixa[0]) || (v1->x > caixa[2] && v2->x > caixa[2]) ||
+                          (v1->y < caixa[1] && v2->y < caixa[1]) || (v1->y > caixa[3] && v2->y > caixa[3]))) {
+                continue;
+            }
+            
+            Segmento seg = { v1->x, v1->y, v2->x, v2->y };
+            if (lote->num == *cap_extremos) {
+                int nova_cap = *cap_extremos ? 2 * *cap_extremos : 64;
+                Vertice** novo = (Vertice**)realloc(*extremos, 2 * nova_cap * sizeof(Vertice*));
+                if (!novo) return -1;
+                *extremos = novo;
+                *cap_extremos = nova_cap;
+            }
+            (*extremos)[2 * lote->num] = v1;
+            (*extremos)[2 * lote->num + 1] = v2;
+            if (lote_acrescentar(lote, &seg) != 0) return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Função de intersecção que imprime a linha de cada intersecção
+ * @param intersecao Intersecção encontrada
+ * @param dados Apontador para um bool que indica se o cabeçalho já foi impresso
+ * @return 0, para a enumeração continuar
+ * 
+ * @details Antes da primeira intersecção imprime o cabeçalho com as duas frequências
+ */
+int imprimir_intersecao(Intersecao* intersecao, void* dados) {
+    bool* cabecalho = (bool*)dados;
+    Vertice* a1 = intersecao->a1;
+    Vertice* a2 = intersecao->a2;
+    Vertice* b1 = intersecao->b1;
+    Vertice* b2 = intersecao->b2;
+    
+    if (!*cabecalho) {
+        printf("\n=== Intersecoes entre frequencias de %c e %c ===\n", a1->frequencia, b1->frequencia);
+        *cabecalho = true;
+    }
+    printf("Linha %c(%d,%d)-%c(%d,%d) com ", 
+           a1->frequencia, a1->x, a1->y, a2->frequencia, a2->x, a2->y);
+    printf("%c(%d,%d)-%c(%d,%d) em (%d,%d)\n",
+           b1->frequencia, b1->x, b1->y, b2->frequencia, b2->x, b2->y, intersecao->x, intersecao->y);
+    return 0;
+}
+
+/**
+ * @brief Encontra e imprime todas as intersecções entre pares de antenas de duas frequências
+ * @param grafo Apontador para o grafo
+ * @param freqA Primeira frequência a considerar
+ * @param freqB Segunda frequência a considerar
+ * @return Número de intersecções encontradas, ou -1 em caso de erro
+ * 
+ * @details Recolhe os segmentos de cada frequência e entrega-os a
+ * detetar_intersecoes, que indexa os de freqB numa grelha uniforme e só testa
+ * os pares que partilham uma célula. Só são recolhidos os segmentos que tocam
+ * na caixa envolvente das antenas da outra frequência, e nenhum se as duas
+ * caixas forem disjuntas. Os cruzamentos chegam por ordem de
+ * (segmento de freqA, segmento de freqB), pelo que cada ponto é atribuído ao
+ * primeiro par de segmentos que o produz, como anteriormente.
+ * É intersecoes_frequencias_paralelo com um só fio de execução.
+ */
+int intersecoes_frequencias(Grafo* grafo, char freqA, char freqB) {
+    return intersecoes_frequencias_paralelo(grafo, freqA, freqB, 1);
+}
+
+/**
+ * @brief Encontra e imprime as intersecções entre duas frequências, repartindo a deteção por vários fios
+ * @param grafo Apontador para o grafo
+ * @param freqA Primeira frequência a considerar
+ * @param freqB Segunda frequência a considerar
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @return Número de intersecções encontradas, ou -1 em caso de erro
+ * 
+ * @details Só a deteção é paralela (detetar_intersecoes_paralelo); a impressão é
+ * feita depois, pelo fio que chamou a função, e é igual à de intersecoes_frequencias.
+ * Os contadores vão para o contexto de procura do grafo.
+ */
+int intersecoes_frequencias_paralelo(Grafo* grafo, char freqA, char freqB, int num_fios) {
+    if (!grafo) return -1;
+    return intersecoes_frequencias_ctx(grafo, &grafo->contexto, freqA, freqB, num_fios);
+}
+
+/**
+ * @brief Igual a intersecoes_frequencias_paralelo, mas com os contadores num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto que recebe os contadores e os tempos
+ * @param freqA Primeira frequência a considerar
+ * @param freqB Segunda frequência a considerar
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @return Número de intersecções encontradas, ou -1 em caso de erro
+ */
+int intersecoes_frequencias_ctx(const Grafo* grafo, ContextoProcura* ctx, char freqA, char freqB, int num_fios) {
+    bool cabecalho = false;
+    return intersecoes_frequencias_visitar_ctx(grafo, ctx, freqA, freqB, num_fios, imprimir_intersecao, &cabecalho);
+}
+
+/**
+ * @brief Encontra as intersecções entre duas frequências, chamando uma função para cada uma
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto que recebe os contadores e os tempos
+ * @param freqA Primeira frequência a considerar
+ * @param freqB Segunda frequência a considerar
+ * @param num_fios Número de fios de execução da deteção (0 para usar um por processador)
+ * @param visita Função chamada para cada intersecção, pela ordem de intersecoes_frequencias
+ * (NULL para só contar)
+ * @param dados Apontador passado a cada chamada de visita
+ * @return Número de intersecções encontradas (mesmo que visita termine a
+ * enumeração), ou -1 em caso de erro
+ * 
+ * @details Em cada intersecção, a1-a2 é o segmento de freqA e b1-b2 o de freqB
+ */
+int intersecoes_frequencias_visitar_ctx(const Grafo* grafo, ContextoProcura* ctx, char freqA, char freqB,
+                                        int num_fios, FuncaoIntersecao visita, void* dados) {
+    if (!grafo || !ctx) return -1;
+    
+    int count = 0;
+    LoteSegmentos loteA, loteB;
+    Vertice** extremosA = NULL;
+    Vertice** extremosB = NULL;
+    int capA = 0, capB = 0;
+    Cruzamento* cruzamentos = NULL;
+    lote_iniciar(&loteA);
+    lote_iniciar(&loteB);
+    
+    int caixaA[4], caixaB[4];
+    bool sobrepostas = caixas_sobrepostas(grafo, freqA, freqB, caixaA, caixaB);
+    
+    ESTAT_INICIAR_TEMPO(inicio_recolha);
+    if (sobrepostas &&
+        (recolher_segmentos(grafo, freqA, &loteA, &extremosA, &capA, caixaB) != 0 ||
+         recolher_segmentos(grafo, freqB, &loteB, &extremosB, &capB, caixaA) != 0)) {
+        count = -1;
+    }
+    ESTAT_TERMINAR_TEMPO(&ctx->estatisticas, FASE_RECOLHA_SEGMENTOS, inicio_recolha);
+    if (sobrepostas && count == 0) {
+        ESTAT_INICIAR_TEMPO(inicio_detecao);
+        count = detetar_intersecoes_estatisticas(&loteA, &loteB, num_fios, &cruzamentos,
+                                                 &ctx->estatisticas.intersecoes);
+        ESTAT_TERMINAR_TEMPO(&ctx->estatisticas, FASE_DETECAO_INTERSECOES, inicio_detecao);
+    }
+    
+    for (int k = 0; visita && k < count; k++) {
+        Intersecao intersecao;
+        intersecao.x = cruzamentos[k].x;
+        intersecao.y = cruzamentos[k].y;
+        intersecao.a1 = extremosA[2 * cruzamentos[k].a];
+        intersecao.a2 = extremosA[2 * cruzamentos[k].a + 1];
+        intersecao.b1 = extremosB[2 * cruzamentos[k].b];
+        intersecao.b2 = extremosB[2 * cruzamentos[k].b + 1];
+        intersecao.prox = NULL;
+        if (visita(&intersecao, dados) != 0) break;
+    }
+    
+    free(cruzamentos);
+    free(extremosA);
+    free(extremosB);
+    lote_libertar(&loteA);
+    lote_libertar(&loteB);
+    
+    return count;
+}
+
+/**
+ * @brief Conta as intersecções entre duas frequências, sem as imprimir
+ * @param grafo Apontador para o grafo
+ * @param freqA Primeira frequência a considerar
+ * @param freqB Segunda frequência a considerar
+ * @return Número de intersecções, ou -1 em caso de erro
+ * 
+ * @details Devolve o mesmo valor que intersecoes_frequencias. Os contadores
+ * vão para o contexto de procura do grafo.
+ */
+int contar_intersecoes(Grafo* grafo, char freqA, char freqB) {
+    if (!grafo) return -1;
+    return contar_intersecoes_ctx(grafo, &grafo->contexto, freqA, freqB);
+}
+
+/**
+ * @brief Igual a contar_intersecoes, mas com os contadores num contexto dado
+ * @param grafo Apontador para o grafo (só lido)
+ * @param ctx Contexto que recebe os contadores e os tempos
+ * @param freqA Primeira frequência a considerar
+ * @param freqB Segunda frequência a considerar
+ * @return Número de intersecções, ou -1 em caso de erro
+ */
+int contar_intersecoes_ctx(const Grafo* grafo, ContextoProcura* ctx, char freqA, char freqB) {
+    return intersecoes_frequencias_visitar_ctx(grafo, ctx, freqA, freqB, 1, NULL, NULL);
+}
+
+/**
+ * @brief Conta, num só passo, as intersecções entre todos os pares de frequências
+ * @param grafo Apontador para o grafo
+ * @param[out] matriz Matriz de NUM_FREQUENCIAS x NUM_FREQUENCIAS; matriz[a * NUM_FREQUENCIAS + b]
+ * fica com o número de intersecções entre as frequências a e b
+ * @param visita Função chamada para cada intersecção (pode ser NULL)
+ * @param dados Apontador passado a cada chamada de visita
+ * @return 0 em caso de sucesso, 1 se visita terminou a enumeração, -1 em caso de erro
+ * 
+ * @details Junta os segmentos de todas as frequências num só lote e entrega-o a
+ * cruzamentos_agrupados, que os indexa numa única grelha e testa cada par de
+ * segmentos vizinhos uma só vez. matriz[a][b] é igual ao valor devolvido por
+ * intersecoes_frequencias(grafo, a, b), sem chamar essa função para cada par.
+ * A matriz é simétrica e fica completa mesmo que visita termine a enumeração.
+ * Em cada intersecção passada a visita, a1-a2 é a linha recolhida primeiro.
+ */
+int matriz_interferencia(Grafo* grafo, unsigned int* matriz, FuncaoIntersecao visita, void* dados) {
+    if (!grafo || !matriz) return -1;
+    
+    LoteSegmentos lote;
+    Vertice** extremos = NULL;
+    int cap = 0;
+    unsigned char* grupo = NULL;
+    Cruzamento* cruzamentos = NULL;
+    int resultado = 0;
+    lote_iniciar(&lote);
+    
+    for (int f = 0; resultado == 0 && f < NUM_FREQUENCIAS; f++) {
+        if (grafo->num_por_frequencia[f] < 2) continue;
+        int antes = lote.num;
+        if (recolher_segmentos(grafo, (char)f, &lote, &extremos, &cap, NULL) != 0) {
+            resultado = -1;
+            break;
+        }
+        if (lote.num == antes) continue;
+        unsigned char* novo = (unsigned char*)realloc(grupo, lote.num);
+        if (!novo) {
+            resultado = -1;
+            break;
+        }
+        grupo = novo;
+        for (int i = antes; i < lote.num; i++) grupo[i] = (unsigned char)f;
+    }
+    
+    int total = 0;
+    if (resultado == 0) {
+        total = cruzamentos_agrupados(&lote, grupo, matriz, visita ? &cruzamentos : NULL);
+        if (total < 0) resultado = -1;
+    }
+    
+    for (int k = 0; resultado == 0 && visita && k < total; k++) {
+        Intersecao intersecao;
+        intersecao.x = cruzamentos[k].x;
+        intersecao.y = cruzamentos[k].y;
+        intersecao.a1 = extremos[2 * cruzamentos[k].a];
+        intersecao.a2 = extremos[2 * cruzamentos[k].a + 1];
+        intersecao.b1 = extremos[2 * cruzamentos[k].b];
+        intersecao.b2 = extremos[2 * cruzamentos[k].b + 1];
+        intersecao.prox = NULL;
+        if (visita(&intersecao, dados) != 0) resultado = 1;
+    }
+    
+    free(cruzamentos);
+    free(grupo);
+    free(extremos);
+    lote_libertar(&lote);
+    
+    return resultado;
+}
+
+/**
+ * @brief Encontra um vértice no grafo pelas suas coordenadas
+ * @param grafo Apontador para o grafo
+ * @param x Coordenada x (coluna) do vértice
+ * @param y Coordenada y (linha) do vértice
+ * 
+ * @details Consulta o índice de coordenadas do grafo (tabela de dispersão com
+ * sondagem linear), pelo que o custo é constante em média
+ */
+Vertice* encontrar_vertice(Grafo* grafo, int x, int y) {
+    if (!grafo || grafo->cap_indice == 0) return NULL;
+    
+    int mascara = grafo->cap_indice - 1;
+    int i = posicao_indice(x, y, mascara);
+    while (grafo->indice[i] != NULL) {
+        Vertice* v = grafo->indice[i];
+        if (v->x == x && v->y == y) return v;
+        i = (i + 1) & mascara;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Constrói a grelha de uma frequência a partir do seu vetor de antenas
+ * @param grafo Apontador para o grafo
+ * @param f Frequência
+ * @param grelha Grelha de destino (já inicializada)
+ * @return 0 em caso de sucesso, -2 em caso de erro de memória
+ */
+static int construir_grelha_frequencia(const Grafo* grafo, int f, GrelhaPontos* grelha) {
+    int n = grafo->num_por_frequencia[f];
+    if (n == 0) return grelha_pontos_construir(grelha, NULL, NULL, 0);
+    int* x = (int*)malloc((size_t)n * sizeof(int));
+    int* y = (int*)malloc((size_t)n * sizeof(int));
+    int resultado = -2;
+    if (x && y) {
+        for (int i = 0; i < n; i++) {
+            x[i] = grafo->por_frequencia[f][i]->x;
+            y[i] = grafo->por_frequencia[f][i]->y;
+        }
+        resultado = grelha_pontos_construir(grelha, x, y, n);
+    }
+    free(x);
+    free(y);
+    return resultado;
+}
+
+/**
+ * @brief Constrói o índice espacial das frequências alteradas desde a última indexação
+ * @param grafo Apontador para o grafo
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Cada frequência tem uma grelha uniforme com as posições das suas
+ * antenas (ver espacial.h). Adicionar, remover ou mover uma antena invalida
+ * só a grelha da sua frequência, e só essas são reconstruídas aqui, em O(k).
+ * carregar_mapa_modo indexa o grafo que devolve. As consultas espaciais sobre
+ * uma frequência sem grelha válida constroem uma grelha temporária.
+ */
+int indexar_grafo(Grafo* grafo) {
+    return indexar_grafo_paralelo(grafo, 1);
+}
+
+/**
+ * @brief Estado partilhado de indexar_grafo_paralelo
+ */
+typedef struct {
+    Grafo* grafo;                       ///< Grafo a indexar
+    int frequencias[NUM_FREQUENCIAS];   ///< Frequências com a grelha inválida
+    int resultados[NUM_FREQUENCIAS];    ///< Resultado da construção de cada grelha
+} TrabalhoIndexacao;
+
+/**
+ * @brief Reconstrói a grelha de uma frequência
+ * @param dados Apontador para o TrabalhoIndexacao
+ * @param k Posição da frequência em TrabalhoIndexacao.frequencias
+ */
+static void indexar_frequencia(void* dados, int k) {
+    TrabalhoIndexacao* t = (TrabalhoIndexacao*)dados;
+    int f = t->frequencias[k];
+    t->resultados[k] = construir_grelha_frequencia(t->grafo, f, &t->grafo->espacial[f]);
+}
+
+/**
+ * @brief Constrói o índice espacial das frequências alteradas, repartindo-as por vários fios
+ * @param grafo Apontador para o grafo
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Igual a indexar_grafo; as grelhas das frequências são independentes
+ * e cada fio constrói as das frequências que obtiver. Em caso de erro é
+ * devolvido o da primeira frequência que falhou.
+ */
+int indexar_grafo_paralelo(Grafo* grafo, int num_fios) {
+    if (!grafo || num_fios < 0) return -1;
+    TrabalhoIndexacao t;
+    t.grafo = grafo;
+    int num = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        if (!grafo->espacial[f].valida) t.frequencias[num++] = f;
+    }
+    executar_tarefas(indexar_frequencia, &t, num, num_fios);
+    for (int k = 0; k < num; k++) {
+        if (t.resultados[k] != 0) return t.resultados[k];
+    }
+    return 0;
+}
+
+/**
+ * @brief Obtém a grelha de uma frequência, construindo uma temporária se a do grafo não for válida
+ * @param grafo Apontador para o grafo
+ * @param f Frequência
+ * @param temporaria Grelha temporária (inicializada aqui; libertar com grelha_pontos_libertar)
+ * @param[out] estado 0, ou o código de erro da construção
+ * @return Grelha a usar, ou NULL em caso de erro
+ */
+static const GrelhaPontos* grelha_frequencia(const Grafo* grafo, int f, GrelhaPontos* temporaria, int* estado) {
+    grelha_pontos_iniciar(temporaria);
+    *estado = 0;
+    if (grafo->espacial[f].valida) return &grafo->espacial[f];
+    *estado = construir_grelha_frequencia(grafo, f, temporaria);
+    return *estado == 0 ? temporaria : NULL;
+}
+
+/**
+ * @brief Indica se um valor é uma frequência ou TODAS_FREQUENCIAS
+ * @param freq Valor a verificar (um char, com ou sem sinal)
+ */
+static bool frequencia_valida(int freq) {
+    return freq == TODAS_FREQUENCIAS || (freq >= -128 && freq < NUM_FREQUENCIAS);
+}
+
+/**
+ * @brief Estado da tradução das visitas da grelha em visitas de antenas
+ */
+typedef struct {
+    Vertice** antenas;      ///< Vetor da frequência de onde a grelha foi construída
+    FuncaoVisita visita;    ///< Função de visita de quem chamou
+    void* dados;            ///< Dados de quem chamou
+    bool terminada;         ///< A função de visita pediu para terminar
+} VisitaEspacial;
+
+/**
+ * @brief Função de ponto que passa a antena correspondente à função de visita
+ * @param indice Posição da antena no vetor da frequência
+ * @param x Coordenada x (não usada)
+ * @param y Coordenada y (não usada)
+ * @param dados Apontador para o VisitaEspacial
+ * @return 0 para continuar, 1 se a função de visita terminou a enumeração
+ */
+static int visitar_ponto(int indice, int x, int y, void* dados) {
+    (void)x;
+    (void)y;
+    VisitaEspacial* e = (VisitaEspacial*)dados;
+    if (e->visita(e->antenas[indice], e->dados) != 0) {
+        e->terminada = true;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Enumera as antenas de uma ou de todas as frequências dentro de um retângulo ou de um círculo
+ * @param grafo Apontador para o grafo
+ * @param freq Frequência, ou TODAS_FREQUENCIAS
+ * @param circulo true para {x, y, raio}, false para {x0, y0, x1, y1}
+ * @param area Coordenadas da zona
+ * @param visita Função chamada para cada antena
+ * @param dados Apontador passado a cada chamada de visita
+ * @return Número de antenas passadas a visita, -1 em caso de erro, -2 em caso de erro de memória
+ */
+static int enumerar_espacial(const Grafo* grafo, int freq, bool circulo, const int* area,
+                             FuncaoVisita visita, void* dados) {
+    if (!grafo || !visita || !frequencia_valida(freq)) return -1;
+    int primeira = freq == TODAS_FREQUENCIAS ? 0 : (unsigned char)freq;
+    int ultima = freq == TODAS_FREQUENCIAS ? NUM_FREQUENCIAS - 1 : primeira;
+    
+    int total = 0;
+    for (int f = primeira; f <= ultima; f++) {
+        if (grafo->num_por_frequencia[f] == 0) continue;
+        GrelhaPontos temporaria;
+        int estado;
+        const GrelhaPontos* g = grelha_frequencia(grafo, f, &temporaria, &estado);
+        if (!g) return estado;
+        
+        VisitaEspacial e = { grafo->por_frequencia[f], visita, dados, false };
+        int n = circulo ? grelha_pontos_raio(g, area[0], area[1], area[2], visitar_ponto, &e)
+                        : grelha_pontos_retangulo(g, area[0], area[1], area[2], area[3], visitar_ponto, &e);
+        grelha_pontos_libertar(&temporaria);
+        if (n < 0) return -1;
+        total += n;
+        if (e.terminada) break;
+    }
+    return total;
+}
+
+/**
+ * @brief Enumera as antenas dentro de um retângulo
+ * @param grafo Apontador para o grafo (só lido)
+ * @param freq Frequência das antenas, ou TODAS_FREQUENCIAS
+ * @param x0 Coordenada x de um canto
+ * @param y0 Coordenada y de um canto
+ * @param x1 Coordenada x do canto oposto (inclusive)
+ * @param y1 Coordenada y do canto oposto (inclusive)
+ * @param visita Função chamada para cada antena
+ * @param dados Apontador passado a cada chamada de visita
+ * @return Número de antenas passadas a visita, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Só são percorridas as células das grelhas que tocam no retângulo.
+ * As antenas chegam frequência a frequência e, em cada uma, célula a célula.
+ */
+int antenas_no_retangulo(const Grafo* grafo, int freq, int x0, int y0, int x1, int y1,
+                         FuncaoVisita visita, void* dados) {
+    int area[4] = { x0, y0, x1, y1 };
+    return enumerar_espacial(grafo, freq, false, area, visita, dados);
+}
+
+/**
+ * @brief Enumera as antenas a uma distância não superior a raio de uma posição
+ * @param grafo Apontador para o grafo (só lido)
+ * @param freq Frequência das antenas, ou TODAS_FREQUENCIAS
+ * @param x Coordenada x do centro
+ * @param y Coordenada y do centro
+ * @param raio Raio (distância euclidiana, inclusive)
+ * @param visita Função chamada para cada antena
+ * @param dados Apontador passado a cada chamada de visita
+ * @return Número de antenas passadas a visita, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details A ordem das antenas é a de antenas_no_retangulo
+ */
+int antenas_no_raio(const Grafo* grafo, int freq, int x, int y, int raio, FuncaoVisita visita, void* dados) {
+    if (raio < 0) return -1;
+    int area[3] = { x, y, raio };
+    return enumerar_espacial(grafo, freq, true, area, visita, dados);
+}
+
+/**
+ * @brief Encontra as k antenas mais próximas de uma posição
+ * @param grafo Apontador para o grafo (só lido)
+ * @param freq Frequência das antenas, ou TODAS_FREQUENCIAS
+ * @param x Coordenada x da posição
+ * @param y Coordenada y da posição
+ * @param k Número de antenas pretendido
+ * @param[out] resultado Antenas encontradas (k entradas), da mais próxima para a mais afastada
+ * @return Número de antenas encontradas, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Pede as k mais próximas à grelha de cada frequência e junta-as. A
+ * distância é euclidiana; em caso de empate vem primeiro a antena de menor
+ * frequência e, dentro da frequência, a que está antes no vetor da frequência.
+ * Uma antena na própria posição conta, a distância 0.
+ */
+int antenas_mais_proximas(const Grafo* grafo, int freq, int x, int y, int k, Vertice** resultado) {
+    if (!grafo || !resultado || k < 0 || !frequencia_valida(freq)) return -1;
+    if (k == 0) return 0;
+    int primeira = freq == TODAS_FREQUENCIAS ? 0 : (unsigned char)freq;
+    int ultima = freq == TODAS_FREQUENCIAS ? NUM_FREQUENCIAS - 1 : primeira;
+    
+    int* indices = (int*)malloc((size_t)k * sizeof(int));
+    unsigned long long* distancias = (unsigned long long*)malloc((size_t)k * sizeof(unsigned long long));
+    unsigned long long* melhores = (unsigned long long*)malloc((size_t)k * sizeof(unsigned long long));
+    if (!indices || !distancias || !melhores) {
+        free(indices);
+        free(distancias);
+        free(melhores);
+        return -2;
+    }
+    
+    int num = 0;
+    for (int f = primeira; num >= 0 && f <= ultima; f++) {
+        if (grafo->num_por_frequencia[f] == 0) continue;
+        GrelhaPontos temporaria;
+        int estado;
+        const GrelhaPontos* g = grelha_frequencia(grafo, f, &temporaria, &estado);
+        if (!g) {
+            num = estado;
+            break;
+        }
+        int n = grelha_pontos_proximos(g, x, y, k, indices, distancias);
+        grelha_pontos_libertar(&temporaria);
+        if (n < 0) {
+            num = -2;
+            break;
+        }
+        
+        // Junção estável: um empate não passa à frente das frequências anteriores
+        for (int i = 0; i < n; i++) {
+            if (num == k && distancias[i] >= melhores[k - 1]) break;
+            int j = num < k ? num++ : k - 1;
+            while (j > 0 && distancias[i] < melhores[j - 1]) {
+                melhores[j] = melhores[j - 1];
+                resultado[j] = resultado[j - 1];
+                j--;
+            }
+            melhores[j] = distancias[i];
+            resultado[j] = grafo->por_frequencia[f][indices[i]];
+        }
+    }
+    
+    free(indices);
+    free(distancias);
+    free(melhores);
+    return num;
+}
+
+/**
+ * @brief Reinicia o estado de visita de todos os vértices do grafo
+ * @param grafo Apontador para o grafo
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ * 
+ * @details Pré-requisito para algoritmos de procura do grafo. Em vez de
+ * percorrer os vértices, avança a época do contexto do grafo: as marcas
+ * antigas deixam de coincidir com ela. Só quando o contador dá a volta é que
+ * as marcas são limpas. As procuras com contexto próprio não são afetadas.
+ */
+int reiniciar_visitados(Grafo* grafo) {
+    if (!grafo) return -1;
+    return contexto_preparar(&grafo->contexto, grafo) == 0 ? 0 : -1;
+}
+
+/**
+ * @brief Escreve a posição de uma antena, no formato (x,y)
+ * @param saida Saída
+ * @param v Antena a escrever
+ */
+static void escrever_posicao(Saida* saida, const Vertice* v) {
+    saida_caracter(saida, '(');
+    saida_inteiro(saida, v->x);
+    saida_caracter(saida, ',');
+    saida_inteiro(saida, v->y);
+    saida_caracter(saida, ')');
+}
+
+/**
+ * @brief Escreve a representação do grafo numa saída com buffer
+ * @param grafo Apontador para o grafo a escrever
+ * @param saida Saída de destino
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ * 
+ * @details Produz o mesmo texto que imprimir_grafo. Não faz alocações nem
+ * chamadas a printf: cada antena e cada vizinho são formatados diretamente no
+ * buffer da saída, que só é despejado quando enche. A saída não é fechada.
+ */
+int escrever_grafo(const Grafo* grafo, Saida* saida) {
+    if (!saida) return -1;
+    if (grafo == NULL) {
+        saida_texto(saida, "Grafo inválido (NULL)\n");
+        return -1;
+    }
+    
+    saida_texto(saida, "\nGrafo (");
+    saida_inteiro(saida, grafo->num_vertices);
+    saida_texto(saida, " antenas):\n");
+    
+    for (Vertice* v = grafo->vertices; v != NULL; v = v->proximo) {
+        saida_texto(saida, "Antena ");
+        saida_caracter(saida, v->frequencia);
+        saida_caracter(saida, ' ');
+        escrever_posicao(saida, v);
+        saida_texto(saida, " -> ");
+        IteradorVizinhos it;
+        iniciar_vizinhos(grafo, v, &it);
+        Vertice* u = proximo_vizinho(&it);
+        
+        if (u == NULL) {
+            saida_texto(saida, "Sem conexões");
+        } else {
+            while (u != NULL) {
+                saida_caracter(saida, u->frequencia);
+                escrever_posicao(saida, u);
+                u = proximo_vizinho(&it);
+                if (u != NULL) saida_escrever(saida, "  ", 2);
+            }
+        }
+        saida_caracter(saida, '\n');
+    }
+    return saida->erro ? -1 : 0;
+}
+
+/**
+ * @brief Imprime a representação do grafo na consola
+ * @param grafo Apontador para o grafo a imprimir
+ * 
+ * @details Mostra cada vértice e as suas conexões num formato legível. A
+ * escrita é feita por escrever_grafo, num buffer de TAMANHO_BUFFER_ESCRITA
+ * bytes na pilha, despejado na saída padrão em blocos.
+ */
+void imprimir_grafo(Grafo* grafo) {
+    char buffer[TAMANHO_BUFFER_ESCRITA];
+    Saida saida;
+    if (saida_ficheiro(&saida, stdout, buffer, sizeof(buffer)) != 0) return;
+    escrever_grafo(grafo, &saida);
+    saida_despejar(&saida);
+}
+
+/**
+ * @brief Copia as estatísticas acumuladas do grafo
+ * @param grafo Apontador para o grafo
+ * @param[out] estatisticas Cópia dos contadores e tempos
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ * 
+ * @details Junta os contadores da construção do grafo aos das procuras feitas
+ * com o contexto do grafo; as procuras com contexto próprio ficam nesse
+ * contexto (ver obter_estatisticas_contexto). Sem EDA_ESTATISTICAS a cópia
+ * tem todos os valores a 0.
+ */
+int obter_estatisticas(const Grafo* grafo, EstatisticasGrafo* estatisticas) {
+    if (!grafo || !estatisticas) return -1;
+    *estatisticas = grafo->estatisticas;
+    estatisticas_juntar(estatisticas, &grafo->contexto.estatisticas);
+    return 0;
+}
+
+/**
+ * @brief Copia as estatísticas acumuladas das procuras feitas com um contexto
+ * @param ctx Contexto da procura
+ * @param[out] estatisticas Cópia dos contadores e tempos
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int obter_estatisticas_contexto(const ContextoProcura* ctx, EstatisticasGrafo* estatisticas) {
+    if (!ctx || !estatisticas) return -1;
+    *estatisticas = ctx->estatisticas;
+    return 0;
+}
+
+/**
+ * @brief Põe a 0 as estatísticas acumuladas do grafo
+ * @param grafo Apontador para o grafo
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int reiniciar_estatisticas(Grafo* grafo) {
+    if (!grafo) return -1;
+    estatisticas_limpar(&grafo->estatisticas);
+    estatisticas_limpar(&grafo->contexto.estatisticas);
+    return 0;
+}
@@ -0,0 +1,934 @@
+/**
+ * @file intersecao.c
+ * @brief Implementação do núcleo geométrico de intersecção de segmentos
+ *
+ * @details Implementa as funções declaradas em intersecao.h, incluindo:
+ * - Teste exato de intersecção com produtos vetoriais inteiros
+ * - Cálculo racional exato do ponto de intersecção
+ * - Teste em lote sem ramificações, para vetorização automática
+ * - Índice em grelha uniforme e deteção de cruzamentos entre dois conjuntos,
+ *   com eliminação de pontos repetidos por tabela de dispersão
+ * - Deteção de cruzamentos repartida por vários fios de execução (pthreads)
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+#include "intersecao.h"
+#include "estatisticas.h"
+
+/**
+ * @brief Verifica se dois segmentos se intersectam e calcula o ponto
+ * @param a Primeiro segmento
+ * @param b Segundo segmento
+ * @param[out] x Coordenada x da intersecção (truncada para inteiro), se existir
+ * @param[out] y Coordenada y da intersecção (truncada para inteiro), se existir
+ * @return true se os segmentos se intersectam num único ponto
+ *
+ * @details Com a = P1 + ua (P2 - P1) e b = P3 + ub (P4 - P3), os parâmetros são
+ * ua = num_a / denom e ub = num_b / denom. Depois de tornar denom positivo, os
+ * segmentos intersectam-se se 0 <= num_a <= denom e 0 <= num_b <= denom, o que
+ * se decide só com inteiros. Segmentos paralelos (denom == 0) não se intersectam.
+ */
+bool intersetar_segmentos(const Segmento* a, const Segmento* b, int* x, int* y) {
+    long long dxa = a->x2 - a->x1, dya = a->y2 - a->y1;
+    long long dxb = b->x2 - b->x1, dyb = b->y2 - b->y1;
+    long long ox = a->x1 - b->x1, oy = a->y1 - b->y1;
+
+    long long denom = dyb * dxa - dxb * dya;
+    if (denom == 0) return false;
+
+    long long num_a = dxb * oy - dyb * ox;
+    long long num_b = dxa * oy - dya * ox;
+    if (denom < 0) {
+        denom = -denom;
+        num_a = -num_a;
+        num_b = -num_b;
+    }
+    if (num_a < 0 || num_a > denom || num_b < 0 || num_b > denom) return false;
+
+    ponto_intersecao(a, b, x, y);
+    return true;
+}
+
+/**
+ * @brief Calcula o ponto de intersecção de dois segmentos que já se sabe intersectarem
+ * @param a Primeiro segmento
+ * @param b Segundo segmento
+ * @param[out] x Coordenada x da intersecção (truncada para inteiro)
+ * @param[out] y Coordenada y da intersecção (truncada para inteiro)
+ *
+ * @details O ponto é P1 + num_a (P2 - P1) / denom. O numerador x1 * denom + num_a * dx
+ * pode exceder 64 bits, por isso é calculado com inteiros de 128 bits quando o
+ * compilador os suporta; a divisão inteira trunca para zero, como a conversão
+ * de vírgula flutuante para int fazia.
+ */
+void ponto_intersecao(const Segmento* a, const Segmento* b, int* x, int* y) {
+    long long dxa = a->x2 - a->x1, dya = a->y2 - a->y1;
+    long long dxb = b->x2 - b->x1, dyb = b->y2 - b->y1;
+    long long ox = a->x1 - b->x1, oy = a->y1 - b->y1;
+
+    long long denom = dyb * dxa - dxb * dya;
+    long long num_a = dxb * oy - dyb * ox;
+
+#ifdef __SIZEOF_INT128__
+    __extension__ typedef __int128 inteiro128;
+    *x = (int)(((inteiro128)a->x1 * denom + (inteiro128)num_a * dxa) / denom);
+    *y = (int)(((inteiro128)a->y1 * denom + (inteiro128)num_a * dya) / denom);
+#else
+    *x = (int)(a->x1 + (long double)num_a * dxa / denom);
+    *y = (int)(a->y1 + (long double)num_a * dya / denom);
+#endif
+}
+
+/**
+ * @brief Testa um segmento contra todos os segmentos de um lote
+ * @param a Segmento a testar
+ * @param lote Segmentos contra os quais testar
+ * @param[out] acerto Vetor com lote->num posições; fica a 1 onde há intersecção, 0 caso contrário
+ * @return Número de segmentos do lote intersectados por a
+ *
+ * @details O corpo do ciclo não tem ramificações: o sinal do denominador é
+ * aplicado com uma máscara e as comparações são combinadas com '&'. As
+ * diferenças cabem em 32 bits, pelo que os produtos são de 32x32 para 64 bits.
+ * Só o teste é feito aqui; as coordenadas calculam-se depois com
+ * ponto_intersecao, apenas para os acertos.
+ */
+int intersetar_lote(const Segmento* a, const LoteSegmentos* lote, unsigned char* acerto) {
+    const int ax = a->x1, ay = a->y1;
+    const int dxa = a->x2 - a->x1, dya = a->y2 - a->y1;
+    const int* restrict bx1 = lote->x1;
+    const int* restrict by1 = lote->y1;
+    const int* restrict bx2 = lote->x2;
+    const int* restrict by2 = lote->y2;
+    unsigned char* restrict saida = acerto;
+    const int n = lote->num;
+    int total = 0;
+
+    for (int i = 0; i < n; i++) {
+        int dxb = bx2[i] - bx1[i], dyb = by2[i] - by1[i];
+        int ox = ax - bx1[i], oy = ay - by1[i];
+
+        long long denom = (long long)dyb * dxa - (long long)dxb * dya;
+        long long num_a = (long long)dxb * oy - (long long)dyb * ox;
+        long long num_b = (long long)dxa * oy - (long long)dya * ox;
+
+        long long sinal = denom >> 63;          // 0 ou -1
+        denom = (denom ^ sinal) - sinal;
+        num_a = (num_a ^ sinal) - sinal;
+        num_b = (num_b ^ sinal) - sinal;
+
+        unsigned char r = (unsigned char)((denom != 0) & (num_a >= 0) & (num_a <= denom) &
+                                          (num_b >= 0) & (num_b <= denom));
+        saida[i] = r;
+        total += r;
+    }
+    return total;
+}
+
+/**
+ * @brief Prepara um lote vazio
+ * @param lote Lote a inicializar
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int lote_iniciar(LoteSegmentos* lote) {
+    if (!lote) return -1;
+    lote->x1 = lote->y1 = lote->x2 = lote->y2 = NULL;
+    lote->num = 0;
+    lote->cap = 0;
+    return 0;
+}
+
+/**
+ * @brief Acrescenta um segmento ao fim de um lote
+ * @param lote Lote a alterar
+ * @param s Segmento a acrescentar
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
+ *
+ * @details A capacidade dos quatro vetores duplica quando ficam cheios
+ */
+int lote_acrescentar(LoteSegmentos* lote, const Segmento* s) {
+    if (lote->num == lote->cap) {
+        int nova_cap = lote->cap ? 2 * lote->cap : 64;
+        int* v[4] = { lote->x1, lote->y1, lote->x2, lote->y2 };
+        for (int k = 0; k < 4; k++) {
+            int* novo = (int*)realloc(v[k], nova_cap * sizeof(int));
+            if (!novo) {
+                // Os vetores já realocados ficam válidos com a capacidade antiga
+                lote->x1 = v[0]; lote->y1 = v[1]; lote->x2 = v[2]; lote->y2 = v[3];
+                return -1;
+            }
+            v[k] = novo;
+        }
+        lote->x1 = v[0]; lote->y1 = v[1]; lote->x2 = v[2]; lote->y2 = v[3];
+        lote->cap = nova_cap;
+    }
+    lote->x1[lote->num] = s->x1;
+    lote->y1[lote->num] = s->y1;
+    lote->x2[lote->num] = s->x2;
+    lote->y2[lote->num] = s->y2;
+    lote->num++;
+    return 0;
+}
+
+/**
+ * @brief Obtém o segmento numa posição de um lote
+ * @param lote Lote a consultar
+ * @param i Posição do segmento
+ * @param[out] s Segmento lido
+ */
+void lote_obter(const LoteSegmentos* lote, int i, Segmento* s) {
+    s->x1 = lote->x1[i];
+    s->y1 = lote->y1[i];
+    s->x2 = lote->x2[i];
+    s->y2 = lote->y2[i];
+}
+
+/**
+ * @brief Liberta a memória de um lote
+ * @param lote Lote a libertar
+ */
+void lote_libertar(LoteSegmentos* lote) {
+    if (!lote) return;
+    free(lote->x1);
+    free(lote->y1);
+    free(lote->x2);
+    free(lote->y2);
+    lote_iniciar(lote);
+}
+
+/**
+ * @brief Obtém o número de processadores disponíveis
+ * @return Número de processadores (pelo menos 1)
+ */
+int numero_processadores(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    int n = (int)info.dwNumberOfProcessors;
+#else
+    int n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return n > 0 ? n : 1;
+}
+
+/**
+ * @brief Divisão inteira arredondada para baixo (o divisor tem de ser positivo)
+ * @param a Dividendo
+ * @param b Divisor (> 0)
+ * @return floor(a / b)
+ */
+static long long dividir_abaixo(long long a, long long b) {
+    long long q = a / b;
+    if ((a % b) != 0 && a < 0) q--;
+    return q;
+}
+
+/**
+ * @brief Divisão inteira arredondada para cima (o divisor tem de ser positivo)
+ * @param a Dividendo
+ * @param b Divisor (> 0)
+ * @return ceil(a / b)
+ */
+static long long dividir_acima(long long a, long long b) {
+    return -dividir_abaixo(-a, b);
+}
+
+/**
+ * @brief Raiz quadrada inteira arredondada para cima
+ * @param n Valor
+ * @return Menor r tal que r * r >= n
+ */
+static long long raiz_acima(long long n) {
+    long long r = 1;
+    while (r * r < n) r *= 2;
+    long long lo = r / 2, hi = r;   // lo*lo < n <= hi*hi (para n > 1)
+    while (hi - lo > 1) {
+        long long meio = lo + (hi - lo) / 2;
+        if (meio * meio >= n) hi = meio; else lo = meio;
+    }
+    return n <= 1 ? 1 : hi;
+}
+
+/**
+ * @brief Vetor crescente de inteiros, usado como memória de rascunho
+ */
+typedef struct {
+    int* dados;             ///< Elementos
+    int num;                ///< Número de elementos
+    int cap;                ///< Capacidade alocada
+} VetorInteiros;
+
+/**
+ * @brief Acrescenta um inteiro ao fim de um vetor
+ * @param v Vetor a alterar
+ * @param valor Valor a acrescentar
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
+ */
+static int vetor_acrescentar(VetorInteiros* v, int valor) {
+    if (v->num == v->cap) {
+        int nova_cap = v->cap ? 2 * v->cap : 64;
+        int* novo = (int*)realloc(v->dados, nova_cap * sizeof(int));
+        if (!novo) return -1;
+        v->dados = novo;
+        v->cap = nova_cap;
+    }
+    v->dados[v->num++] = valor;
+    return 0;
+}
+
+/**
+ * @brief Calcula as células da grelha atravessadas por um segmento
+ * @param indice Grelha (só são usadas as dimensões)
+ * @param s Segmento
+ * @param[out] celulas Vetor onde são acrescentados os índices das células (é esvaziado antes)
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
+ * 
+ * @details Percorre as colunas da grelha entre os extremos do segmento. Em cada
+ * coluna, calcula exatamente o intervalo de y que o segmento ocupa dentro da
+ * faixa de x da coluna (valores racionais arredondados para fora) e acrescenta
+ * as células dessas linhas. Todas as células que contêm um ponto do segmento
+ * ficam incluídas; partes do segmento fora da grelha são ignoradas.
+ */
+static int celulas_segmento(const IndiceSegmentos* indice, const Segmento* s, VetorInteiros* celulas) {
+    celulas->num = 0;
+    
+    long long lado = indice->lado;
+    long long min_x = s->x1 < s->x2 ? s->x1 : s->x2;
+    long long max_x = s->x1 < s->x2 ? s->x2 : s->x1;
+    long long c0 = dividir_abaixo(min_x - indice->min_x, lado);
+    long long c1 = dividir_abaixo(max_x - indice->min_x, lado);
+    if (c0 < 0) c0 = 0;
+    if (c1 > indice->colunas - 1) c1 = indice->colunas - 1;
+    
+    // y(x) = y1 + (x - x1) * dy / dx, com dx > 0 depois de orientar o segmento
+    long long x1 = s->x1, y1 = s->y1, dx = s->x2 - s->x1, dy = s->y2 - s->y1;
+    if (dx < 0) {
+        x1 = s->x2;
+        y1 = s->y2;
+        dx = -dx;
+        dy = -dy;
+    }
+    
+    for (long long c = c0; c <= c1; c++) {
+        long long y_min, y_max;
+        if (dx == 0) {
+            y_min = s->y1 < s->y2 ? s->y1 : s->y2;
+            y_max = s->y1 < s->y2 ? s->y2 : s->y1;
+        } else {
+            long long xe = indice->min_x + c * lado;
+            long long xd = xe + lado;
+            if (xe < min_x) xe = min_x;
+            if (xd > max_x) xd = max_x;
+            long long ne = y1 * dx + (xe - x1) * dy;    // y(xe) * dx
+            long long nd = y1 * dx + (xd - x1) * dy;    // y(xd) * dx
+            long long n_min = ne < nd ? ne : nd;
+            long long n_max = ne < nd ? nd : ne;
+            y_min = dividir_abaixo(n_min, dx);
+            y_max = dividir_acima(n_max, dx);
+        }
+        
+        long long r0 = dividir_abaixo(y_min - indice->min_y, lado);
+        long long r1 = dividir_abaixo(y_max - indice->min_y, lado);
+        if (r0 < 0) r0 = 0;
+        if (r1 > indice->linhas - 1) r1 = indice->linhas - 1;
+        for (long long r = r0; r <= r1; r++) {
+            if (vetor_acrescentar(celulas, (int)(r * indice->colunas + c)) != 0) return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Constrói o índice em grelha de um lote de segmentos
+ * @param indice Índice a construir
+ * @param lote Segmentos a indexar
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ * 
+ * @details A grelha cobre a caixa envolvente dos segmentos com cerca de uma
+ * célula por segmento. As listas são construídas em duas passagens: primeiro
+ * conta-se quantos segmentos atravessam cada célula, depois preenchem-se as
+ * listas nas posições dadas pela soma acumulada das contagens.
+ */
+int indice_construir(IndiceSegmentos* indice, const LoteSegmentos* lote) {
+    if (!indice || !lote) return -1;
+    indice->inicio = NULL;
+    indice->segmentos = NULL;
+    indice->min_x = indice->min_y = 0;
+    indice->lado = 1;
+    indice->colunas = indice->linhas = 0;
+    if (lote->num == 0) return 0;
+    
+    int min_x = lote->x1[0], max_x = lote->x1[0], min_y = lote->y1[0], max_y = lote->y1[0];
+    for (int i = 0; i < lote->num; i++) {
+        int xs[2] = { lote->x1[i], lote->x2[i] }, ys[2] = { lote->y1[i], lote->y2[i] };
+        for (int k = 0; k < 2; k++) {
+            if (xs[k] < min_x) min_x = xs[k];
+            if (xs[k] > max_x) max_x = xs[k];
+            if (ys[k] < min_y) min_y = ys[k];
+            if (ys[k] > max_y) max_y = ys[k];
+        }
+    }
+    
+    long long largura = (long long)max_x - min_x + 1;
+    long long altura = (long long)max_y - min_y + 1;
+    long long lado = raiz_acima(dividir_acima(largura * altura, lote->num));
+    indice->min_x = min_x;
+    indice->min_y = min_y;
+    indice->lado = (int)lado;
+    indice->colunas = (int)((largura - 1) / lado + 1);
+    indice->linhas = (int)((altura - 1) / lado + 1);
+    
+    size_t num_celulas = (size_t)indice->colunas * indice->linhas;
+    indice->inicio = (size_t*)calloc(num_celulas + 1, sizeof(size_t));
+    if (!indice->inicio) return -1;
+    
+    VetorInteiros celulas = { NULL, 0, 0 };
+    for (int i = 0; i < lote->num; i++) {
+        Segmento s;
+        lote_obter(lote, i, &s);
+        if (celulas_segmento(indice, &s, &celulas) != 0) {
+            free(celulas.dados);
+            indice_libertar(indice);
+            return -1;
+        }
+        for (int k = 0; k < celulas.num; k++) indice->inicio[celulas.dados[k] + 1]++;
+    }
+    for (size_t c = 0; c < num_celulas; c++) {
+        indice->inicio[c + 1] += indice->inicio[c];
+    }
+    
+    size_t total = indice->inicio[num_celulas];
+    indice->segmentos = (int*)malloc((total ? total : 1) * sizeof(int));
+    size_t* cursor = (size_t*)malloc(num_celulas * sizeof(size_t));
+    if (!indice->segmentos || !cursor) {
+        free(cursor);
+        free(celulas.dados);
+        indice_libertar(indice);
+        return -1;
+    }
+    for (size_t c = 0; c < num_celulas; c++) cursor[c] = indice->inicio[c];
+    
+    for (int i = 0; i < lote->num; i++) {
+        Segmento s;
+        lote_obter(lote, i, &s);
+        celulas_segmento(indice, &s, &celulas);   // já teve sucesso na primeira passagem
+        for (int k = 0; k < celulas.num; k++) indice->segmentos[cursor[celulas.dados[k]]++] = i;
+    }
+    
+    free(cursor);
+    free(celulas.dados);
+    return 0;
+}
+
+/**
+ * @brief Liberta a memória de um índice em grelha
+ * @param indice Índice a libertar
+ */
+void indice_libertar(IndiceSegmentos* indice) {
+    if (!indice) return;
+    free(indice->inicio);
+    free(indice->segmentos);
+    indice->inicio = NULL;
+    indice->segmentos = NULL;
+    indice->colunas = indice->linhas = 0;
+}
+
+/**
+ * @brief Entrada da tabela de pontos já encontrados
+ */
+typedef struct {
+    int x, y;               ///< Coordenadas do ponto
+    int grupo;              ///< Grupo do ponto (permite usar a mesma tabela para vários pares)
+    bool ocupada;           ///< Indica se a entrada está em uso
+} EntradaPonto;
+
+/**
+ * @brief Tabela de dispersão com endereçamento aberto de pontos (x, y, grupo)
+ */
+typedef struct {
+    EntradaPonto* entradas; ///< Entradas da tabela
+    int cap;                ///< Número de entradas (potência de 2)
+    int num;                ///< Entradas ocupadas
+    unsigned long long sondagens;   ///< Posições consultadas (só com EDA_ESTATISTICAS)
+} ConjuntoPontos;
+
+/**
+ * @brief Calcula a posição inicial de um ponto na tabela
+ * @param x Coordenada x
+ * @param y Coordenada y
+ * @param grupo Grupo do ponto
+ * @param mascara Capacidade da tabela menos 1
+ */
+static int posicao_ponto(int x, int y, int grupo, int mascara) {
+    unsigned int h = (unsigned int)x * 0x9E3779B1u ^ (unsigned int)y * 0x85EBCA77u ^ (unsigned int)grupo * 0xC2B2AE3Du;
+    h ^= h >> 15;
+    return (int)(h & (unsigned int)mascara);
+}
+
+/**
+ * @brief Insere um ponto na tabela, se ainda lá não estiver
+ * @param conjunto Tabela de pontos
+ * @param x Coordenada x
+ * @param y Coordenada y
+ * @param grupo Grupo do ponto
+ * @return 1 se o ponto é novo, 0 se já existia, -1 em caso de erro de memória
+ * 
+ * @details Mantém a ocupação abaixo de 50%, duplicando a tabela quando necessário
+ */
+static int conjunto_inserir(ConjuntoPontos* conjunto, int x, int y, int grupo) {
+    if (2 * (conjunto->num + 1) > conjunto->cap) {
+        int nova_cap = conjunto->cap ? 2 * conjunto->cap : 64;
+        EntradaPonto* novas = (EntradaPonto*)calloc(nova_cap, sizeof(EntradaPonto));
+        if (!novas) return -1;
+        for (int i = 0; i < conjunto->cap; i++) {
+            EntradaPonto* e = &conjunto->entradas[i];
+            if (!e->ocupada) continue;
+            int p = posicao_ponto(e->x, e->y, e->grupo, nova_cap - 1);
+            while (novas[p].ocupada) p = (p + 1) & (nova_cap - 1);
+            novas[p] = *e;
+        }
+        free(conjunto->entradas);
+        conjunto->entradas = novas;
+        conjunto->cap = nova_cap;
+    }
+    
+    int mascara = conjunto->cap - 1;
+    int p = posicao_ponto(x, y, grupo, mascara);
+    ESTAT_SOMAR(conjunto->sondagens, 1);
+    while (conjunto->entradas[p].ocupada) {
+        EntradaPonto* e = &conjunto->entradas[p];
+        if (e->x == x && e->y == y && e->grupo == grupo) return 0;
+        p = (p + 1) & mascara;
+        ESTAT_SOMAR(conjunto->sondagens, 1);
+    }
+    conjunto->entradas[p].x = x;
+    conjunto->entradas[p].y = y;
+    conjunto->entradas[p].grupo = grupo;
+    conjunto->entradas[p].ocupada = true;
+    conjunto->num++;
+    return 1;
+}
+
+/**
+ * @brief Compara dois inteiros para qsort
+ */
+static int comparar_inteiros(const void* a, const void* b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Memória de rascunho de uma procura de candidatos na grelha
+ */
+typedef struct {
+    int* carimbo;               ///< Último segmento consultado que encontrou cada segmento indexado
+    VetorInteiros celulas;      ///< Células atravessadas pelo segmento consultado
+    VetorInteiros candidatos;   ///< Índices dos segmentos candidatos, por ordem crescente
+    LoteSegmentos lote;         ///< Coordenadas dos candidatos, para o teste em lote
+    unsigned char* acerto;      ///< Resultado do teste em lote
+    int cap_acerto;             ///< Capacidade de acerto
+    unsigned long long testes;  ///< Pares de segmentos testados (só com EDA_ESTATISTICAS)
+} ProcuraGrelha;
+
+/**
+ * @brief Prepara a memória de rascunho de uma procura
+ * @param p Procura a inicializar
+ * @param num_indexados Número de segmentos do índice
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
+ */
+static int procura_iniciar(ProcuraGrelha* p, int num_indexados) {
+    p->carimbo = (int*)malloc((num_indexados ? num_indexados : 1) * sizeof(int));
+    p->celulas.dados = p->candidatos.dados = NULL;
+    p->celulas.num = p->celulas.cap = p->candidatos.num = p->candidatos.cap = 0;
+    lote_iniciar(&p->lote);
+    p->acerto = NULL;
+    p->cap_acerto = 0;
+    p->testes = 0;
+    if (!p->carimbo) return -1;
+    for (int j = 0; j < num_indexados; j++) p->carimbo[j] = -1;
+    return 0;
+}
+
+/**
+ * @brief Liberta a memória de rascunho de uma procura
+ * @param p Procura a libertar
+ */
+static void procura_libertar(ProcuraGrelha* p) {
+    free(p->carimbo);
+    free(p->celulas.dados);
+    free(p->candidatos.dados);
+    lote_libertar(&p->lote);
+    free(p->acerto);
+}
+
+/**
+ * @brief Testa um segmento contra os segmentos indexados que partilham células com ele
+ * @param p Memória de rascunho da procura
+ * @param indice Grelha dos segmentos indexados
+ * @param indexados Segmentos indexados
+ * @param s Segmento a consultar
+ * @param marca Identificador da consulta (diferente em cada consulta, >= 0)
+ * @param minimo Só são considerados os segmentos indexados de índice >= minimo
+ * @return Número de candidatos intersectados, ou -1 em caso de erro de memória
+ * 
+ * @details No fim, p->candidatos tem os índices dos candidatos por ordem
+ * crescente, p->lote as suas coordenadas e p->acerto o resultado do teste.
+ * Cada candidato só é junto uma vez, graças ao carimbo com a marca da consulta.
+ */
+static int procura_testar(ProcuraGrelha* p, const IndiceSegmentos* indice, const LoteSegmentos* indexados,
+                          const Segmento* s, int marca, int minimo) {
+    if (celulas_segmento(indice, s, &p->celulas) != 0) return -1;
+    
+    // 1. Candidatos: segmentos indexados nas mesmas células
+    p->candidatos.num = 0;
+    for (int k = 0; k < p->celulas.num; k++) {
+        int c = p->celulas.dados[k];
+        for (size_t q = indice->inicio[c]; q < indice->inicio[c + 1]; q++) {
+            int j = indice->segmentos[q];
+            if (j < minimo || p->carimbo[j] == marca) continue;
+            p->carimbo[j] = marca;
+            if (vetor_acrescentar(&p->candidatos, j) != 0) return -1;
+        }
+    }
+    p->lote.num = 0;
+    if (p->candidatos.num == 0) return 0;
+    
+    // 2. Teste em lote, pela ordem dos índices
+    qsort(p->candidatos.dados, p->candidatos.num, sizeof(int), comparar_inteiros);
+    for (int k = 0; k < p->candidatos.num; k++) {
+        Segmento t;
+        lote_obter(indexados, p->candidatos.dados[k], &t);
+        if (lote_acrescentar(&p->lote, &t) != 0) return -1;
+    }
+    if (p->lote.num > p->cap_acerto) {
+        unsigned char* novo = (unsigned char*)realloc(p->acerto, p->lote.cap);
+        if (!novo) return -1;
+        p->acerto = novo;
+        p->cap_acerto = p->lote.cap;
+    }
+    ESTAT_SOMAR(p->testes, p->lote.num);
+    return intersetar_lote(s, &p->lote, p->acerto);
+}
+
+/**
+ * @brief Acrescenta um cruzamento ao fim de um vetor crescente
+ * @param cruzamentos Vetor de cruzamentos (realocado quando cheio)
+ * @param num Número de cruzamentos no vetor
+ * @param cap Capacidade do vetor
+ * @param c Cruzamento a acrescentar
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
+ */
+static int acrescentar_cruzamento(Cruzamento** cruzamentos, int* num, int* cap, Cruzamento c) {
+    if (*num == *cap) {
+        int nova_cap = *cap ? 2 * *cap : 64;
+        Cruzamento* mais = (Cruzamento*)realloc(*cruzamentos, nova_cap * sizeof(Cruzamento));
+        if (!mais) return -1;
+        *cruzamentos = mais;
+        *cap = nova_cap;
+    }
+    (*cruzamentos)[(*num)++] = c;
+    return 0;
+}
+
+/**
+ * @brief Encontra os pontos de intersecção distintos entre dois conjuntos de segmentos
+ * @param a Primeiro conjunto de segmentos
+ * @param b Segundo conjunto de segmentos
+ * @param[out] resultado Vetor alocado com os cruzamentos (libertar com free), ou NULL se vazio
+ * @return Número de pontos distintos, ou -1 em caso de erro de memória
+ * 
+ * @details Indexa b numa grelha uniforme e, para cada segmento de a:
+ * 1. Junta os segmentos de b das células que atravessa (cada um só uma vez,
+ *    graças a um carimbo por segmento com o índice do segmento de a)
+ * 2. Ordena os candidatos e testa-os de uma vez com intersetar_lote
+ * 3. Guarda os pontos ainda não vistos, verificados numa tabela de dispersão
+ * 
+ * Os cruzamentos ficam por ordem crescente de (a, b), e cada ponto é atribuído
+ * ao primeiro par que o produz nessa ordem, tal como faria o teste de todos os
+ * pares. Só são testados pares de segmentos que partilham uma célula.
+ * É detetar_intersecoes_paralelo com um só fio de execução.
+ */
+int detetar_intersecoes(const LoteSegmentos* a, const LoteSegmentos* b, Cruzamento** resultado) {
+    return detetar_intersecoes_paralelo(a, b, 1, resultado);
+}
+
+/**
+ * @brief Cruzamentos encontrados num bloco de segmentos consecutivos do primeiro conjunto
+ */
+typedef struct {
+    Cruzamento* cruzamentos;    ///< Cruzamentos do bloco, por ordem de (a, b)
+    int num;                    ///< Número de cruzamentos
+    int cap;                    ///< Capacidade alocada
+} FatiaCruzamentos;
+
+/**
+ * @brief Estado partilhado pelos fios de execução de detetar_intersecoes_paralelo
+ */
+typedef struct {
+    const IndiceSegmentos* indice;  ///< Grelha do segundo conjunto (só de leitura)
+    const LoteSegmentos* a;         ///< Primeiro conjunto
+    const LoteSegmentos* b;         ///< Segundo conjunto
+    FatiaCruzamentos* fatias;       ///< Resultado de cada bloco
+    int num_fatias;                 ///< Número de blocos
+    int por_fatia;                  ///< Segmentos de a por bloco
+    atomic_int proxima;             ///< Próximo bloco por tratar
+    atomic_int erro;                ///< Diferente de 0 se algum fio falhou
+    atomic_ullong testes;           ///< Pares de segmentos testados por todos os fios
+    atomic_ullong sondagens;        ///< Posições consultadas nas tabelas de pontos dos fios
+} TrabalhoIntersecoes;
+
+/**
+ * @brief Corpo de cada fio de execução: trata blocos até não haver mais
+ * @param arg Apontador para o TrabalhoIntersecoes partilhado
+ * @return NULL
+ * 
+ * @details Cada fio tem a sua memória de rascunho e a sua tabela de pontos, e
+ * escreve apenas nas fatias dos blocos que obteve. Como os blocos são obtidos
+ * por ordem crescente, a tabela do fio só elimina pontos que já apareceram num
+ * bloco anterior, o que preserva o primeiro par de cada ponto.
+ */
+static void* trabalhar_intersecoes(void* arg) {
+    TrabalhoIntersecoes* t = (TrabalhoIntersecoes*)arg;
+    ProcuraGrelha procura;
+    ConjuntoPontos vistos = { NULL, 0, 0, 0 };
+    int erro = procura_iniciar(&procura, t->b->num);
+    
+    while (erro == 0 && atomic_load(&t->erro) == 0) {
+        int k = atomic_fetch_add(&t->proxima, 1);
+        if (k >= t->num_fatias) break;
+        
+        FatiaCruzamentos* fatia = &t->fatias[k];
+        int fim = (k + 1) * t->por_fatia < t->a->num ? (k + 1) * t->por_fatia : t->a->num;
+        for (int i = k * t->por_fatia; erro == 0 && i < fim; i++) {
+            Segmento sa;
+            lote_obter(t->a, i, &sa);
+            int acertos = procura_testar(&procura, t->indice, t->b, &sa, i, 0);
+            if (acertos < 0) erro = -1;
+            
+            for (int j = 0; erro == 0 && acertos > 0 && j < procura.lote.num; j++) {
+                if (!procura.acerto[j]) continue;
+                Segmento sb;
+                Cruzamento c;
+                lote_obter(&procura.lote, j, &sb);
+                ponto_intersecao(&sa, &sb, &c.x, &c.y);
+                c.a = i;
+                c.b = procura.candidatos.dados[j];
+                
+                int novo = conjunto_inserir(&vistos, c.x, c.y, 0);
+                if (novo < 0 || (novo && acrescentar_cruzamento(&fatia->cruzamentos, &fatia->num, &fatia->cap, c) != 0)) {
+                    erro = -1;
+                }
+            }
+        }
+    }
+    
+    if (erro != 0) atomic_store(&t->erro, erro);
+#ifdef EDA_ESTATISTICAS
+    atomic_fetch_add(&t->testes, procura.testes);
+    atomic_fetch_add(&t->sondagens, vistos.sondagens);
+#endif
+    procura_libertar(&procura);
+    free(vistos.entradas);
+    return NULL;
+}
+
+/**
+ * @brief Encontra os pontos de intersecção distintos entre dois conjuntos, repartindo o trabalho por vários fios
+ * @param a Primeiro conjunto de segmentos
+ * @param b Segundo conjunto de segmentos
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @param[out] resultado Vetor alocado com os cruzamentos (libertar com free), ou NULL se vazio
+ * @return Número de pontos distintos, ou -1 em caso de erro
+ * 
+ * @details A grelha de b é construída uma vez e partilhada só para leitura. Os
+ * segmentos de a são divididos em blocos consecutivos (vários por fio, para
+ * equilibrar a carga), que os fios vão obtendo de um contador atómico; cada
+ * bloco tem a sua fatia de resultados. No fim, as fatias são juntas por ordem
+ * de bloco com uma tabela de pontos global, pelo que o resultado é o mesmo que
+ * com um só fio. Se não for possível criar algum fio, o fio que chamou a função
+ * trata os blocos que sobrarem.
+ */
+int detetar_intersecoes_paralelo(const LoteSegmentos* a, const LoteSegmentos* b, int num_fios,
+                                 Cruzamento** resultado) {
+    return detetar_intersecoes_estatisticas(a, b, num_fios, resultado, NULL);
+}
+
+/**
+ * @brief Igual a detetar_intersecoes_paralelo, acumulando também o trabalho feito
+ * @param a Primeiro conjunto de segmentos
+ * @param b Segundo conjunto de segmentos
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @param[out] resultado Vetor alocado com os cruzamentos (libertar com free), ou NULL se vazio
+ * @param[in,out] contadores Contadores a que é somado o trabalho feito (pode ser NULL)
+ * @return Número de pontos distintos, ou -1 em caso de erro
+ * 
+ * @details Cada fio conta os seus testes e sondagens em memória própria e só os
+ * soma aos totais partilhados no fim. Sem EDA_ESTATISTICAS os contadores não
+ * são alterados.
+ */
+int detetar_intersecoes_estatisticas(const LoteSegmentos* a, const LoteSegmentos* b, int num_fios,
+                                     Cruzamento** resultado, ContadoresIntersecao* contadores) {
+    if (!a || !b || !resultado || num_fios < 0) return -1;
+    *resultado = NULL;
+    if (a->num == 0 || b->num == 0) return 0;
+    
+    if (num_fios == 0) num_fios = numero_processadores();
+    if (num_fios > a->num) num_fios = a->num;
+    
+    IndiceSegmentos indice;
+    if (indice_construir(&indice, b) != 0) return -1;
+    
+    TrabalhoIntersecoes t;
+    t.indice = &indice;
+    t.a = a;
+    t.b = b;
+    t.num_fatias = num_fios == 1 ? 1 : (a->num < 8 * num_fios ? a->num : 8 * num_fios);
+    t.por_fatia = (a->num + t.num_fatias - 1) / t.num_fatias;
+    t.fatias = (FatiaCruzamentos*)calloc(t.num_fatias, sizeof(FatiaCruzamentos));
+    atomic_init(&t.proxima, 0);
+    atomic_init(&t.erro, 0);
+    atomic_init(&t.testes, 0);
+    atomic_init(&t.sondagens, 0);
+    if (!t.fatias) {
+        indice_libertar(&indice);
+        return -1;
+    }
+    
+    pthread_t* fios = num_fios > 1 ? (pthread_t*)malloc((num_fios - 1) * sizeof(pthread_t)) : NULL;
+    int criados = 0;
+    for (int f = 0; fios && f < num_fios - 1; f++) {
+        if (pthread_create(&fios[criados], NULL, trabalhar_intersecoes, &t) != 0) break;
+        criados++;
+    }
+    trabalhar_intersecoes(&t);
+    for (int f = 0; f < criados; f++) pthread_join(fios[f], NULL);
+    free(fios);
+    indice_libertar(&indice);
+    
+    // Junção das fatias, por ordem de bloco
+    int erro = atomic_load(&t.erro);
+    Cruzamento* cruzamentos = NULL;
+    int num = 0, cap = 0;
+    if (erro == 0 && t.num_fatias == 1) {
+        cruzamentos = t.fatias[0].cruzamentos;
+        num = t.fatias[0].num;
+        t.fatias[0].cruzamentos = NULL;
+    } else if (erro == 0) {
+        ConjuntoPontos vistos = { NULL, 0, 0, 0 };
+        for (int k = 0; erro == 0 && k < t.num_fatias; k++) {
+            for (int j = 0; erro == 0 && j < t.fatias[k].num; j++) {
+                Cruzamento c = t.fatias[k].cruzamentos[j];
+                int novo = conjunto_inserir(&vistos, c.x, c.y, 0);
+                if (novo < 0 || (novo && acrescentar_cruzamento(&cruzamentos, &num, &cap, c) != 0)) erro = -1;
+            }
+        }
+        atomic_fetch_add(&t.sondagens, vistos.sondagens);
+        free(vistos.entradas);
+    }
+    if (contadores) {
+        contadores->testes_segmentos += atomic_load(&t.testes);
+        contadores->sondagens_pontos += atomic_load(&t.sondagens);
+    }
+    
+    for (int k = 0; k < t.num_fatias; k++) free(t.fatias[k].cruzamentos);
+    free(t.fatias);
+    
+    if (erro != 0) {
+        free(cruzamentos);
+        return -1;
+    }
+    *resultado = cruzamentos;
+    return num;
+}
+
+/**
+ * @brief Encontra os pontos de intersecção distintos entre todos os pares de grupos de um lote
+ * @param lote Segmentos de todos os grupos
+ * @param grupo Grupo de cada segmento (lote->num entradas)
+ * @param[out] contagem Matriz de NUM_GRUPOS x NUM_GRUPOS; contagem[g * NUM_GRUPOS + h]
+ * fica com o número de pontos distintos entre os grupos g e h (pode ser NULL)
+ * @param[out] resultado Vetor alocado com os cruzamentos (libertar com free), ou NULL
+ * para não os guardar
+ * @return Número total de cruzamentos distintos, ou -1 em caso de erro de memória
+ * 
+ * @details Constrói uma só grelha com os segmentos de todos os grupos e consulta-a
+ * uma vez por segmento i, só com os segmentos j > i, pelo que cada par é testado
+ * no máximo uma vez. Um ponto conta uma vez por par de grupos {g, h}, como em
+ * detetar_intersecoes entre os lotes de g e de h; a matriz é simétrica. Nos
+ * cruzamentos devolvidos, a < b são índices no lote e a ordem é a de (a, b).
+ */
+int cruzamentos_agrupados(const LoteSegmentos* lote, const unsigned char* grupo, unsigned int* contagem,
+                          Cruzamento** resultado) {
+    if (!lote || (lote->num > 0 && !grupo)) return -1;
+    if (resultado) *resultado = NULL;
+    if (contagem) {
+        for (int k = 0; k < NUM_GRUPOS * NUM_GRUPOS; k++) contagem[k] = 0;
+    }
+    if (lote->num == 0) return 0;
+    
+    IndiceSegmentos indice;
+    if (indice_construir(&indice, lote) != 0) return -1;
+    
+    ProcuraGrelha procura;
+    ConjuntoPontos vistos = { NULL, 0, 0, 0 };
+    Cruzamento* cruzamentos = NULL;
+    int num = 0, cap = 0, total = 0;
+    int erro = procura_iniciar(&procura, lote->num);
+    
+    for (int i = 0; erro == 0 && i < lote->num; i++) {
+        Segmento si;
+        lote_obter(lote, i, &si);
+        int acertos = procura_testar(&procura, &indice, lote, &si, i, i + 1);
+        if (acertos < 0) erro = -1;
+        
+        for (int k = 0; erro == 0 && acertos > 0 && k < procura.lote.num; k++) {
+            if (!procura.acerto[k]) continue;
+            Segmento sj;
+            Cruzamento c;
+            lote_obter(&procura.lote, k, &sj);
+            ponto_intersecao(&si, &sj, &c.x, &c.y);
+            c.a = i;
+            c.b = procura.candidatos.dados[k];
+            
+            int g = grupo[c.a], h = grupo[c.b];
+            int par = g < h ? g * NUM_GRUPOS + h : h * NUM_GRUPOS + g;
+            int novo = conjunto_inserir(&vistos, c.x, c.y, par);
+            if (novo < 0) {
+                erro = -1;
+            } else if (novo) {
+                total++;
+                if (contagem) {
+                    contagem[g * NUM_GRUPOS + h]++;
+                    if (g != h) contagem[h * NUM_GRUPOS + g]++;
+                }
+                if (resultado && acrescentar_cruzamento(&cruzamentos, &num, &cap, c) != 0) erro = -1;
+            }
+        }
+    }
+    
+    indice_libertar(&indice);
+    procura_libertar(&procura);
+    free(vistos.entradas);
+    
+    if (erro != 0) {
+        free(cruzamentos);
+        return -1;
+    }
+    if (resultado) *resultado = cruzamentos;
+    return total;
+}
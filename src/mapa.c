@@ -4,6 +4,10 @@
  * 
  * @details Implementa as funções declaradas em mapa.h, incluindo:
  * - Leitura de ficheiros de mapa e conversão para grafos
+ * - Mapeamento dos ficheiros em memória (mmap / CreateFileMapping), sem cópias
+ * - Procura vetorial (AVX2/SSE2/NEON) das células com antenas
+ * - Carregamento em faixas de linhas lidas por vários fios (pthreads)
+ * - Processamento em faixas horizontais de mapas maiores do que a memória
  * - Representação matricial dos mapas
  * - Visualização de mapas com antenas e efeitos nefastos
  * - Deteção de posições com interferência entre antenas
@@ -20,9 +24,31 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+#ifdef _WIN32
+#include <windows.h>
 #include <direct.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 #include "grafo.h"
 #include "mapa.h"
+#include "intersecao.h"
+#include "cache.h"
 
 /**
  * @brief Cria um ficheiro binário padrão com o mapa inicial
@@ -54,7 +80,11 @@ int criar_mapa_padrao() {
     };
     
     // Cria pasta se não existir
+#ifdef _WIN32
     _mkdir("data");
+#else
+    mkdir("data", 0777);
+#endif
     
     FILE* file = fopen("data/mapa.bin", "wb");
     if (!file) return -1;
@@ -73,83 +103,931 @@ int criar_mapa_padrao() {
     return 0;
 }
 
+/**
+ * @brief Mapeia um ficheiro inteiro em memória, só para leitura
+ * @param nome Caminho do ficheiro
+ * @param[out] mapeamento Endereço e tamanho do conteúdo mapeado
+ * @return 0 em caso de sucesso, -1 se o ficheiro não puder ser aberto,
+ * -2 se não puder ser mapeado
+ * 
+ * @details Usa CreateFileMapping/MapViewOfFile no Windows e mmap nos restantes
+ * sistemas. Os descritores do ficheiro são fechados logo a seguir: a vista
+ * mapeada mantém-se válida até libertar_mapeamento. Um ficheiro vazio fica com
+ * dados == NULL e tamanho == 0.
+ */
+int mapear_ficheiro(const char* nome, FicheiroMapeado* mapeamento) {
+    if (!nome || !mapeamento) return -1;
+    mapeamento->dados = NULL;
+    mapeamento->tamanho = 0;
+    
+#ifdef _WIN32
+    HANDLE ficheiro = CreateFileA(nome, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (ficheiro == INVALID_HANDLE_VALUE) return -1;
+    
+    LARGE_INTEGER tamanho;
+    if (!GetFileSizeEx(ficheiro, &tamanho)) {
+        CloseHandle(ficheiro);
+        return -2;
+    }
+    if (tamanho.QuadPart == 0) {
+        CloseHandle(ficheiro);
+        return 0;
+    }
+    
+    HANDLE vista = CreateFileMappingA(ficheiro, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle(ficheiro);
+    if (!vista) return -2;
+    void* dados = MapViewOfFile(vista, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(vista);
+    if (!dados) return -2;
+    
+    mapeamento->dados = (const char*)dados;
+    mapeamento->tamanho = (size_t)tamanho.QuadPart;
+#else
+    int descritor = open(nome, O_RDONLY);
+    if (descritor < 0) return -1;
+    
+    struct stat info;
+    if (fstat(descritor, &info) != 0) {
+        close(descritor);
+        return -2;
+    }
+    if (info.st_size == 0) {
+        close(descritor);
+        return 0;
+    }
+    
+    void* dados = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, descritor, 0);
+    close(descritor);
+    if (dados == MAP_FAILED) return -2;
+#ifdef MADV_SEQUENTIAL
+    madvise(dados, (size_t)info.st_size, MADV_SEQUENTIAL);
+#endif
+    
+    mapeamento->dados = (const char*)dados;
+    mapeamento->tamanho = (size_t)info.st_size;
+#endif
+    return 0;
+}
+
+/**
+ * @brief Liberta um ficheiro mapeado com mapear_ficheiro
+ * @param mapeamento Mapeamento a libertar
+ */
+void libertar_mapeamento(FicheiroMapeado* mapeamento) {
+    if (!mapeamento || !mapeamento->dados) return;
+#ifdef _WIN32
+    UnmapViewOfFile((void*)mapeamento->dados);
+#else
+    munmap((void*)mapeamento->dados, mapeamento->tamanho);
+#endif
+    mapeamento->dados = NULL;
+    mapeamento->tamanho = 0;
+}
+
+/**
+ * @brief Procura o próximo caráter diferente de '.' numa sequência de bytes
+ * @param dados Início da sequência
+ * @param i Posição a partir da qual procurar
+ * @param n Tamanho da sequência
+ * @return Posição do próximo caráter diferente de '.', ou n se não houver
+ * 
+ * @details Compara 32 (AVX2) ou 16 (SSE2, NEON) bytes de cada vez com '.' e
+ * extrai uma máscara com um bit por byte diferente; a primeira posição é dada
+ * pelo número de zeros à direita da máscara. Os bytes que restam no fim, ou
+ * todos quando não há instruções vetoriais, são comparados um a um.
+ */
+static size_t proxima_antena(const char* dados, size_t i, size_t n) {
+#if defined(__AVX2__)
+    const __m256i pontos = _mm256_set1_epi8('.');
+    for (; i + 32 <= n; i += 32) {
+        __m256i bloco = _mm256_loadu_si256((const __m256i*)(dados + i));
+        unsigned int mascara = ~(unsigned int)_mm256_movemask_epi8(_mm256_cmpeq_epi8(bloco, pontos));
+        if (mascara) return i + (size_t)__builtin_ctz(mascara);
+    }
+#elif defined(__SSE2__)
+    const __m128i pontos = _mm_set1_epi8('.');
+    for (; i + 16 <= n; i += 16) {
+        __m128i bloco = _mm_loadu_si128((const __m128i*)(dados + i));
+        unsigned int mascara = ~(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(bloco, pontos)) & 0xFFFFu;
+        if (mascara) return i + (size_t)__builtin_ctz(mascara);
+    }
+#elif defined(__ARM_NEON)
+    const uint8x16_t pontos = vdupq_n_u8('.');
+    for (; i + 16 <= n; i += 16) {
+        uint8x16_t diferentes = vmvnq_u8(vceqq_u8(vld1q_u8((const uint8_t*)(dados + i)), pontos));
+        // Estreita cada byte para 4 bits: máscara de 64 bits com 4 bits por byte
+        uint64_t mascara = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(diferentes), 4)), 0);
+        if (mascara) return i + (size_t)(__builtin_ctzll(mascara) >> 2);
+    }
+#endif
+    for (; i < n; i++) {
+        if (dados[i] != '.') return i;
+    }
+    return n;
+}
+
+/**
+ * @brief Antenas encontradas numa faixa de linhas do mapa, pela ordem de leitura
+ */
+typedef struct {
+    char* frequencia;       ///< Frequência de cada antena
+    int* x;                 ///< Coluna de cada antena
+    int* y;                 ///< Linha de cada antena
+    int num;                ///< Número de antenas
+    int cap;                ///< Capacidade dos vetores
+} AntenasFaixa;
+
+/**
+ * @brief Estado partilhado pelos fios de execução de recolher_antenas
+ */
+typedef struct {
+    const char* celulas;        ///< Carateres do mapa, linha a linha
+    int linhas;                 ///< Número de linhas
+    int colunas;                ///< Número de colunas
+    int linhas_por_faixa;       ///< Linhas de cada faixa (a última pode ter menos)
+    int num_faixas;             ///< Número de faixas
+    AntenasFaixa* faixas;       ///< Antenas de cada faixa
+    atomic_int proxima;         ///< Próxima faixa por ler
+    atomic_int erro;            ///< Diferente de 0 se algum fio ficou sem memória
+} TrabalhoFaixas;
+
+/**
+ * @brief Acrescenta uma antena aos vetores de uma faixa
+ * @param faixa Antenas da faixa
+ * @param freq Frequência da antena
+ * @param x Coluna
+ * @param y Linha
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
+ */
+static int guardar_na_faixa(AntenasFaixa* faixa, char freq, int x, int y) {
+    if (faixa->num == faixa->cap) {
+        int nova_cap = faixa->cap ? 2 * faixa->cap : 256;
+        char* frequencia = (char*)realloc(faixa->frequencia, (size_t)nova_cap);
+        if (frequencia) faixa->frequencia = frequencia;
+        int* nx = frequencia ? (int*)realloc(faixa->x, (size_t)nova_cap * sizeof(int)) : NULL;
+        if (nx) faixa->x = nx;
+        int* ny = nx ? (int*)realloc(faixa->y, (size_t)nova_cap * sizeof(int)) : NULL;
+        if (!ny) return -1;
+        faixa->y = ny;
+        faixa->cap = nova_cap;
+    }
+    faixa->frequencia[faixa->num] = freq;
+    faixa->x[faixa->num] = x;
+    faixa->y[faixa->num] = y;
+    faixa->num++;
+    return 0;
+}
+
+/**
+ * @brief Corpo de cada fio de execução: lê as faixas que obtiver do contador
+ * @param arg Apontador para o TrabalhoFaixas partilhado
+ * @return NULL
+ * 
+ * @details Cada faixa é percorrida como uma só sequência com proxima_antena,
+ * saltando diretamente de antena em antena; a linha e a coluna só são
+ * calculadas para as posições encontradas
+ */
+static void* trabalhar_faixas(void* arg) {
+    TrabalhoFaixas* t = (TrabalhoFaixas*)arg;
+    size_t colunas = (size_t)t->colunas;
+    
+    while (atomic_load(&t->erro) == 0) {
+        int k = atomic_fetch_add(&t->proxima, 1);
+        if (k >= t->num_faixas) break;
+        AntenasFaixa* faixa = &t->faixas[k];
+        int ultima = (k + 1) * t->linhas_por_faixa < t->linhas ? (k + 1) * t->linhas_por_faixa : t->linhas;
+        size_t fim = (size_t)ultima * colunas;
+        for (size_t i = proxima_antena(t->celulas, (size_t)k * t->linhas_por_faixa * colunas, fim); i < fim;
+             i = proxima_antena(t->celulas, i + 1, fim)) {
+            if (guardar_na_faixa(faixa, t->celulas[i], (int)(i % colunas), (int)(i / colunas)) != 0) {
+                atomic_store(&t->erro, 1);
+                break;
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Adiciona ao grafo as antenas de uma grelha de carateres contígua, em faixas de linhas
+ * @param grafo Apontador para o grafo
+ * @param celulas Carateres do mapa, linha a linha, sem quebras de linha
+ * @param linhas Número de linhas
+ * @param colunas Número de colunas
+ * @param num_fios Número de fios de execução (já limitado pelo tamanho do mapa)
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ * 
+ * @details O mapa é dividido em FAIXAS_POR_FIO faixas de linhas por fio, que os
+ * fios vão obtendo de um contador atómico, para que as zonas mais densas não
+ * fiquem todas no mesmo fio. Cada fio guarda as antenas das suas faixas em
+ * vetores próprios; adicionar_vertices_lotes junta depois as faixas ao grafo,
+ * por ordem, também em paralelo. A ordem de inserção é a da leitura linha a
+ * linha, como se o mapa fosse lido por um só fio.
+ */
+static int recolher_antenas(Grafo* grafo, const char* celulas, int linhas, int colunas, int num_fios) {
+    if (linhas == 0 || colunas == 0) return 0;
+    
+    TrabalhoFaixas t;
+    t.celulas = celulas;
+    t.linhas = linhas;
+    t.colunas = colunas;
+    int pretendidas = num_fios > 1 ? num_fios * FAIXAS_POR_FIO : 1;
+    if (pretendidas > linhas) pretendidas = linhas;
+    t.linhas_por_faixa = (linhas + pretendidas - 1) / pretendidas;
+    t.num_faixas = (linhas + t.linhas_por_faixa - 1) / t.linhas_por_faixa;
+    t.faixas = (AntenasFaixa*)calloc((size_t)t.num_faixas, sizeof(AntenasFaixa));
+    LoteAntenas* lotes = (LoteAntenas*)malloc((size_t)t.num_faixas * sizeof(LoteAntenas));
+    if (!t.faixas || !lotes) {
+        free(t.faixas);
+        free(lotes);
+        return -1;
+    }
+    atomic_init(&t.proxima, 0);
+    atomic_init(&t.erro, 0);
+    
+    // 1. Leitura das faixas
+    if (num_fios > t.num_faixas) num_fios = t.num_faixas;
+    pthread_t* fios = num_fios > 1 ? (pthread_t*)malloc((size_t)(num_fios - 1) * sizeof(pthread_t)) : NULL;
+    int criados = 0;
+    for (int f = 0; fios && f < num_fios - 1; f++) {
+        if (pthread_create(&fios[criados], NULL, trabalhar_faixas, &t) != 0) break;
+        criados++;
+    }
+    trabalhar_faixas(&t);
+    for (int f = 0; f < criados; f++) pthread_join(fios[f], NULL);
+    free(fios);
+    
+    // 2. Junção ao grafo, faixa a faixa
+    for (int k = 0; k < t.num_faixas; k++) {
+        lotes[k].frequencia = t.faixas[k].frequencia;
+        lotes[k].x = t.faixas[k].x;
+        lotes[k].y = t.faixas[k].y;
+        lotes[k].num = t.faixas[k].num;
+    }
+    int estado = atomic_load(&t.erro) != 0 ? -1 : adicionar_vertices_lotes(grafo, lotes, t.num_faixas, num_fios);
+    
+    for (int k = 0; k < t.num_faixas; k++) {
+        free(t.faixas[k].frequencia);
+        free(t.faixas[k].x);
+        free(t.faixas[k].y);
+    }
+    free(t.faixas);
+    free(lotes);
+    return estado == 0 ? 0 : -1;
+}
+
+/**
+ * @brief Limita o número de fios ao trabalho disponível
+ * @param num_fios Número de fios pedido (0 para usar um por processador)
+ * @param trabalho Trabalho estimado (células ou pares de antenas)
+ * @return Número de fios a usar, entre 1 e o pedido
+ * 
+ * @details Cada fio fica com pelo menos TRABALHO_POR_FIO_CARREGAMENTO unidades,
+ * para que os mapas pequenos não paguem a criação de fios
+ */
+static int fios_para(int num_fios, unsigned long long trabalho) {
+    if (num_fios == 0) num_fios = numero_processadores();
+    unsigned long long maximo = trabalho / TRABALHO_POR_FIO_CARREGAMENTO;
+    if (maximo < 1) maximo = 1;
+    return (unsigned long long)num_fios > maximo ? (int)maximo : num_fios;
+}
+
+/**
+ * @brief Interpreta o cabeçalho de um ficheiro de mapa (versão 1 ou 2)
+ * @param bytes Primeiros bytes do ficheiro
+ * @param disponiveis Número de bytes disponíveis em bytes
+ * @param[out] cabecalho Versão, dimensões e tamanho do cabeçalho
+ * @return 0 em caso de sucesso, -1 se o cabeçalho for inválido ou estiver incompleto
+ * 
+ * @details Os ficheiros da versão 2 começam por MAGIA_MAPA_V2 (8 bytes), seguida
+ * das linhas e das colunas em inteiros de 64 bits. Sem essa identificação, o
+ * ficheiro é da versão 1: linhas e colunas em dois int.
+ */
+int ler_cabecalho_mapa(const char* bytes, size_t disponiveis, CabecalhoMapa* cabecalho) {
+    if (!bytes || !cabecalho) return -1;
+    
+    if (disponiveis >= TAMANHO_CABECALHO_V2 && memcmp(bytes, MAGIA_MAPA_V2, 8) == 0) {
+        int64_t linhas, colunas;
+        memcpy(&linhas, bytes + 8, sizeof(int64_t));
+        memcpy(&colunas, bytes + 16, sizeof(int64_t));
+        cabecalho->versao = 2;
+        cabecalho->linhas = linhas;
+        cabecalho->colunas = colunas;
+        cabecalho->tamanho = TAMANHO_CABECALHO_V2;
+    } else if (disponiveis >= 2 * sizeof(int)) {
+        int linhas, colunas;
+        memcpy(&linhas, bytes, sizeof(int));
+        memcpy(&colunas, bytes + sizeof(int), sizeof(int));
+        cabecalho->versao = 1;
+        cabecalho->linhas = linhas;
+        cabecalho->colunas = colunas;
+        cabecalho->tamanho = 2 * sizeof(int);
+    } else {
+        return -1;
+    }
+    
+    return cabecalho->linhas >= 0 && cabecalho->colunas >= 0 ? 0 : -1;
+}
+
+/**
+ * @brief Escreve um cabeçalho da versão 2 (dimensões de 64 bits)
+ * @param f Ficheiro aberto para escrita, posicionado no início
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ * 
+ * @details Os carateres do mapa devem ser escritos a seguir, linha a linha
+ */
+int escrever_cabecalho_mapa(FILE* f, long long linhas, long long colunas) {
+    if (!f || linhas < 0 || colunas < 0) return -1;
+    int64_t dimensoes[2] = { linhas, colunas };
+    if (fwrite(MAGIA_MAPA_V2, 1, 8, f) != 8 || fwrite(dimensoes, sizeof(int64_t), 2, f) != 2) return -1;
+    return 0;
+}
+
 /**
  * @brief Implementação do carregamento de mapa a partir de ficheiro binário
  * @param ficheiro Caminho para o ficheiro binário contendo o mapa
  * @return Apontador para grafo criado ou NULL em caso de erro
  * 
  * @details A função:
- * 1. Abre o ficheiro em modo binário ("rb")
- * 2. Lê as dimensões (2 × sizeof(int))
- * 3. Aloca memória para o grafo e buffers temporários
- * 4. Processa cada linha do mapa, adicionando vértices para antenas
- * 5. Conecta arestas entre antenas da mesma frequência
+ * 1. Mapeia o ficheiro em memória (mapear_ficheiro)
+ * 2. Lê as dimensões (2 × sizeof(int)) e confirma que cabem no ficheiro
+ * 3. Percorre os carateres mapeados, adicionando vértices para antenas
+ * 4. Conecta arestas entre antenas da mesma frequência (por baldes de frequência)
  * 
  * @note Se o ficheiro não existir, chama criar_mapa_padrao() e tenta novamente
  */
 Grafo* carregar_mapa(const char* ficheiro) {
-    if (!ficheiro) return NULL;
+    return carregar_mapa_modo(ficheiro, ARESTAS_EXPLICITAS);
+}
+
+/**
+ * @brief Carrega um mapa escolhendo a representação das arestas do grafo
+ * @param ficheiro Caminho para o ficheiro binário contendo o mapa
+ * @param modo ARESTAS_EXPLICITAS ou ARESTAS_IMPLICITAS
+ * @return Apontador para grafo criado ou NULL em caso de erro
+ * 
+ * @details Igual a carregar_mapa, mas no modo implícito o passo de ligação
+ * das arestas é omitido: os vizinhos ficam definidos pelos vetores de
+ * vértices por frequência do grafo, sem alocar nenhuma Aresta.
+ * Nos dois modos o grafo devolvido já tem o índice espacial (indexar_grafo).
+ * Usa um fio por processador (ver carregar_mapa_paralelo).
+ */
+Grafo* carregar_mapa_modo(const char* ficheiro, ModoArestas modo) {
+    return carregar_mapa_paralelo(ficheiro, modo, 0);
+}
+
+/**
+ * @brief Carrega um mapa repartindo a leitura e a construção do grafo por vários fios
+ * @param ficheiro Caminho para o ficheiro binário contendo o mapa
+ * @param modo ARESTAS_EXPLICITAS ou ARESTAS_IMPLICITAS
+ * @param num_fios Número de fios de execução (0 para usar um por processador)
+ * @return Apontador para grafo criado ou NULL em caso de erro
+ * 
+ * @details O grafo é igual ao do carregamento por um só fio, qualquer que seja
+ * num_fios:
+ * 1. Mapeia o ficheiro e valida o cabeçalho, como carregar_mapa
+ * 2. Lê as antenas em faixas de linhas, em paralelo, e junta-as ao grafo com
+ *    somas prefixas (recolher_antenas, adicionar_vertices_lotes)
+ * 3. No modo explícito, liga as antenas de cada frequência, com as frequências
+ *    repartidas pelos fios (ligar_frequencias)
+ * 4. Constrói as grelhas do índice espacial, também por frequência
+ * 
+ * O número de fios de cada passo é limitado pelo trabalho (células do mapa ou
+ * pares de antenas), pelo que os mapas pequenos são lidos por um só fio.
+ */
+Grafo* carregar_mapa_paralelo(const char* ficheiro, ModoArestas modo, int num_fios) {
+    if (!ficheiro || num_fios < 0) return NULL;
     
-    FILE* file = fopen(ficheiro, "rb");
-    if (!file) {
+    ESTAT_INICIAR_TEMPO(inicio_carregamento);
+    FicheiroMapeado mapeamento;
+    int estado = mapear_ficheiro(ficheiro, &mapeamento);
+    if (estado == -1) {
         if (criar_mapa_padrao() != 0) return NULL;
-        file = fopen(ficheiro, "rb");
-        if (!file) return NULL;
+        estado = mapear_ficheiro(ficheiro, &mapeamento);
     }
+    if (estado != 0) return NULL;
     
-    int linhas, colunas;
-    if (fread(&linhas, sizeof(int), 1, file) != 1 ||
-        fread(&colunas, sizeof(int), 1, file) != 1) {
-        fclose(file);
+    // Cabeçalho: as dimensões têm de ser válidas e os carateres têm de caber no ficheiro
+    CabecalhoMapa cabecalho;
+    if (ler_cabecalho_mapa(mapeamento.dados, mapeamento.tamanho, &cabecalho) != 0 ||
+        cabecalho.linhas > INT_MAX || cabecalho.colunas > INT_MAX ||
+        (cabecalho.colunas > 0 &&
+         (unsigned long long)cabecalho.linhas > (mapeamento.tamanho - cabecalho.tamanho) / (unsigned long long)cabecalho.colunas)) {
+        libertar_mapeamento(&mapeamento);
         return NULL;
     }
+    int linhas = (int)cabecalho.linhas, colunas = (int)cabecalho.colunas;
     
-    Grafo* grafo = criar_grafo();
+    Grafo* grafo = criar_grafo_modo(modo);
     if (!grafo) {
-        fclose(file);
+        libertar_mapeamento(&mapeamento);
         return NULL;
     }
     
-    char* linha = malloc(colunas + 1); // +1 para segurança
-    if (!linha) {
-        fclose(file);
+    int fios_leitura = fios_para(num_fios, (unsigned long long)linhas * (unsigned long long)colunas);
+    estado = recolher_antenas(grafo, mapeamento.dados + cabecalho.tamanho, linhas, colunas, fios_leitura);
+    libertar_mapeamento(&mapeamento);
+    
+    if (estado == 0 && modo == ARESTAS_EXPLICITAS) {
+        ESTAT_INICIAR_TEMPO(inicio_ligacao);
+        unsigned long long pares = 0;
+        for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+            pares += (unsigned long long)grafo->num_por_frequencia[f] * (unsigned long long)grafo->num_por_frequencia[f];
+        }
+        estado = ligar_frequencias(grafo, fios_para(num_fios, pares));
+        ESTAT_TERMINAR_TEMPO(&grafo->estatisticas, FASE_LIGACAO, inicio_ligacao);
+    }
+    if (estado == 0) estado = indexar_grafo_paralelo(grafo, fios_leitura);
+    if (estado != 0) {
         destruir_grafo(grafo);
         return NULL;
     }
     
-    for (int y = 0; y < linhas; y++) {
-        size_t elementos_lidos = fread(linha, sizeof(char), colunas, file);
-        if (elementos_lidos != (size_t)colunas) {
-            free(linha);
-            fclose(file);
-            destruir_grafo(grafo);
-            return NULL;
+    ESTAT_TERMINAR_TEMPO(&grafo->estatisticas, FASE_CARREGAMENTO, inicio_carregamento);
+    return grafo;
+}
+
+/**
+ * @brief Verifica se duas antenas da mesma frequência estão alinhadas para efeito nefasto
+ * @param dx Diferença de colunas entre as antenas
+ * @param dy Diferença de linhas entre as antenas
+ * @return true se o par produz efeito nefasto
+ */
+static bool alinhadas(long long dx, long long dy) {
+    long long ax = llabs(dx), ay = llabs(dy);
+    return dx == 0 || dy == 0 || ax == ay ||
+           ax == 2 * ay || 2 * ax == ay ||
+           ax == 3 * ay || 3 * ax == ay;
+}
+
+/**
+ * @brief Marca uma posição com efeito nefasto, se estiver no mapa e vazia
+ * @param celulas Grelha do mapa (linhas * colunas carateres)
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @param x Coluna da posição
+ * @param y Linha da posição
+ */
+static void marcar_efeito(char* celulas, int linhas, int colunas, int x, int y) {
+    if (x < 0 || x >= colunas || y < 0 || y >= linhas) return;
+    char* c = &celulas[(size_t)y * colunas + x];
+    if (*c == '.') *c = '#';
+}
+
+/**
+ * @brief Preenche uma grelha contígua com as antenas e os efeitos nefastos
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @param[out] celulas Grelha com linhas * colunas carateres; a posição (x,y) é celulas[y * colunas + x]
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ * 
+ * @details Cada posição fica com a frequência da antena, '#' se tiver efeito
+ * nefasto ou '.' se estiver vazia. Os efeitos só são procurados entre pares de
+ * antenas da mesma frequência, diretamente nos vetores por frequência do grafo,
+ * e cada par é considerado uma vez: o par (v, u) marca v - (u - v) e u + (u - v).
+ * Antenas e efeitos fora do mapa são ignorados.
+ */
+int calcular_efeitos(Grafo* grafo, int linhas, int colunas, char* celulas) {
+    return calcular_efeitos_cache(grafo, NULL, linhas, colunas, celulas);
+}
+
+/**
+ * @brief Obtém as posições, sem repetições, com efeito nefasto de uma frequência
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param f Frequência
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @param marcas Bits auxiliares, um por posição do mapa, todos a 0 (ficam a 0 no fim)
+ * @param[out] valores Vetor alocado com as posições em pares (x, y), ou NULL se não houver
+ * @param[out] num Número de posições
+ * @return 0 em caso de sucesso, -2 em caso de erro de memória
+ * 
+ * @details Percorre os pares como calcular_efeitos e guarda cada posição dentro
+ * do mapa na primeira vez que é atingida, mesmo que esteja ocupada por uma antena
+ * de outra frequência: assim o resultado só depende das antenas de f.
+ */
+static int efeitos_frequencia(Grafo* grafo, int f, int linhas, int colunas, unsigned char* marcas,
+                              int** valores, int* num) {
+    Vertice** balde = grafo->por_frequencia[f];
+    int k = grafo->num_por_frequencia[f];
+    int cap = 0;
+    int resultado = 0;
+    *valores = NULL;
+    *num = 0;
+    for (int i = 0; i < k && resultado == 0; i++) {
+        for (int j = i + 1; j < k && resultado == 0; j++) {
+            int dx = balde[j]->x - balde[i]->x;
+            int dy = balde[j]->y - balde[i]->y;
+            if (!alinhadas(dx, dy)) continue;
+            long long px[2] = { (long long)balde[i]->x - dx, (long long)balde[j]->x + dx };
+            long long py[2] = { (long long)balde[i]->y - dy, (long long)balde[j]->y + dy };
+            for (int p = 0; p < 2; p++) {
+                if (px[p] < 0 || px[p] >= colunas || py[p] < 0 || py[p] >= linhas) continue;
+                size_t pos = (size_t)py[p] * colunas + (size_t)px[p];
+                if (marcas[pos / 8] & (1u << (pos % 8))) continue;
+                if (*num == cap) {
+                    int nova_cap = cap ? 2 * cap : 64;
+                    int* novo = nova_cap < INT_MAX / VALORES_EFEITO
+                              ? (int*)realloc(*valores, (size_t)nova_cap * VALORES_EFEITO * sizeof(int)) : NULL;
+                    if (!novo) {
+                        resultado = -2;
+                        break;
+                    }
+                    *valores = novo;
+                    cap = nova_cap;
+                }
+                marcas[pos / 8] |= (unsigned char)(1u << (pos % 8));
+                (*valores)[2 * (size_t)*num] = (int)px[p];
+                (*valores)[2 * (size_t)*num + 1] = (int)py[p];
+                (*num)++;
+            }
+        }
+    }
+    
+    for (int i = 0; i < *num; i++) {
+        size_t pos = (size_t)(*valores)[2 * (size_t)i + 1] * colunas + (size_t)(*valores)[2 * (size_t)i];
+        marcas[pos / 8] = 0;
+    }
+    if (resultado != 0) {
+        free(*valores);
+        *valores = NULL;
+        *num = 0;
+    }
+    return resultado;
+}
+
+/**
+ * @brief Preenche uma grelha contígua com as antenas e os efeitos nefastos, usando uma cache de resultados
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param cache Cache de resultados (NULL para calcular sempre)
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @param[out] celulas Grelha com linhas * colunas carateres; a posição (x,y) é celulas[y * colunas + x]
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Produz a mesma grelha que calcular_efeitos. Com cache, as posições de
+ * efeito de cada frequência são guardadas como um resultado RESULTADO_EFEITOS,
+ * com a assinatura dessa frequência: depois de adicionar_antena, remover_antena
+ * ou mover_antena só a frequência alterada volta a ser calculada.
+ */
+int calcular_efeitos_cache(Grafo* grafo, CacheResultados* cache, int linhas, int colunas, char* celulas) {
+    if (!grafo || !celulas || linhas < 0 || colunas < 0) return -1;
+    
+    size_t total = (size_t)linhas * colunas;
+    for (size_t i = 0; i < total; i++) celulas[i] = '.';
+    
+    // Antenas
+    Vertice* v = grafo->vertices;
+    while (v != NULL) {
+        if (v->x >= 0 && v->x < colunas && v->y >= 0 && v->y < linhas) {
+            celulas[(size_t)v->y * colunas + v->x] = v->frequencia;
+        }
+        v = v->proximo;
+    }
+    
+    // Efeitos nefastos, frequência a frequência
+    unsigned char* marcas = NULL;
+    int resultado = 0;
+    for (int f = 0; f < NUM_FREQUENCIAS && resultado == 0; f++) {
+        Vertice** balde = grafo->por_frequencia[f];
+        int k = grafo->num_por_frequencia[f];
+        if (k < 2) continue;
+        if (!cache) {
+            for (int i = 0; i < k; i++) {
+                for (int j = i + 1; j < k; j++) {
+                    int dx = balde[j]->x - balde[i]->x;
+                    int dy = balde[j]->y - balde[i]->y;
+                    if (!alinhadas(dx, dy)) continue;
+                    marcar_efeito(celulas, linhas, colunas, balde[i]->x - dx, balde[i]->y - dy);
+                    marcar_efeito(celulas, linhas, colunas, balde[j]->x + dx, balde[j]->y + dy);
+                }
+            }
+            continue;
         }
         
+        ChaveResultado chave;
+        chave_resultado(&chave, grafo, RESULTADO_EFEITOS, (char)f, 0, linhas, colunas);
+        int* valores;
+        int num;
+        int encontrado = cache_resultados_obter(cache, &chave, &valores, &num);
+        if (encontrado < 0) {
+            resultado = encontrado;
+            break;
+        }
+        if (encontrado == 0) {
+            if (!marcas) {
+                marcas = (unsigned char*)calloc(total / 8 + 1, 1);
+                if (!marcas) {
+                    resultado = -2;
+                    break;
+                }
+            }
+            resultado = efeitos_frequencia(grafo, f, linhas, colunas, marcas, &valores, &num);
+            if (resultado != 0) break;
+            cache_resultados_guardar(cache, &chave, valores, num);
+        }
+        for (int i = 0; i < num; i++) {
+            marcar_efeito(celulas, linhas, colunas, valores[2 * (size_t)i], valores[2 * (size_t)i + 1]);
+        }
+        free(valores);
+    }
+    free(marcas);
+    return resultado;
+}
+
+/**
+ * @brief Obtém as posições com efeito nefasto, sem imprimir o mapa
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @param[out] posicoes Vetor alocado com as posições (libertar com free), ou NULL se não houver
+ * @param[out] num Número de posições
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details As posições vêm por ordem de linha e, dentro de cada linha, de coluna.
+ * Como em imprimir_mapa, uma posição ocupada por uma antena não conta como efeito.
+ */
+int posicoes_efeito(Grafo* grafo, int linhas, int colunas, Posicao** posicoes, int* num) {
+    return posicoes_efeito_cache(grafo, NULL, linhas, colunas, posicoes, num);
+}
+
+/**
+ * @brief Obtém as posições com efeito nefasto, usando uma cache de resultados
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param cache Cache de resultados (NULL para calcular sempre)
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @param[out] posicoes Vetor alocado com as posições (libertar com free), ou NULL se não houver
+ * @param[out] num Número de posições
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details O mesmo que posicoes_efeito, com a grelha de calcular_efeitos_cache
+ */
+int posicoes_efeito_cache(Grafo* grafo, CacheResultados* cache, int linhas, int colunas, Posicao** posicoes, int* num) {
+    if (!grafo || !posicoes || !num || linhas < 0 || colunas < 0) return -1;
+    *posicoes = NULL;
+    *num = 0;
+    
+    size_t total = (size_t)linhas * colunas;
+    char* celulas = (char*)malloc(total ? total : 1);
+    if (!celulas) return -2;
+    int resultado = calcular_efeitos_cache(grafo, cache, linhas, colunas, celulas);
+    if (resultado != 0) {
+        free(celulas);
+        return resultado;
+    }
+    
+    int cap = 0;
+    for (int y = 0; y < linhas; y++) {
+        const char* linha = &celulas[(size_t)y * colunas];
         for (int x = 0; x < colunas; x++) {
-            if (linha[x] != '.') {
-                adicionar_vertice(grafo, linha[x], x, y);
+            if (linha[x] != '#') continue;
+            if (*num == cap) {
+                int nova_cap = cap ? 2 * cap : 64;
+                Posicao* novo = (Posicao*)realloc(*posicoes, nova_cap * sizeof(Posicao));
+                if (!novo) {
+                    free(*posicoes);
+                    free(celulas);
+                    *posicoes = NULL;
+                    *num = 0;
+                    return -2;
+                }
+                *posicoes = novo;
+                cap = nova_cap;
             }
+            (*posicoes)[*num].x = x;
+            (*posicoes)[*num].y = y;
+            (*num)++;
         }
     }
     
-    free(linha);
-    fclose(file);
+    free(celulas);
+    return 0;
+}
+
+/**
+ * @brief Soma uma contagem a uma posição da grelha de efeitos, se estiver no mapa
+ * @param grelha Grelha de contagens
+ * @param x Coluna da posição
+ * @param y Linha da posição
+ * @param delta +1 ou -1
+ */
+static void contar_efeito(GrelhaEfeitos* grelha, long long x, long long y, int delta) {
+    if (x < 0 || x >= grelha->colunas || y < 0 || y >= grelha->linhas) return;
+    grelha->contagem[(size_t)y * grelha->colunas + x] += (unsigned int)delta;
+}
+
+/**
+ * @brief Soma à grelha os efeitos dos pares entre uma antena e as restantes da sua frequência
+ * @param grelha Grelha de contagens
+ * @param grafo Apontador para o grafo
+ * @param v Antena cujos pares se consideram
+ * @param delta +1 para acrescentar os efeitos, -1 para os retirar
+ * 
+ * @details O par (v, u) marca v - (u - v) e u + (u - v), como em calcular_efeitos;
+ * a ordem do par não altera as duas posições. Custa O(k), com k o número de
+ * antenas da frequência.
+ */
+static void contar_efeitos_antena(GrelhaEfeitos* grelha, Grafo* grafo, const Vertice* v, int delta) {
+    unsigned char f = (unsigned char)v->frequencia;
+    Vertice** balde = grafo->por_frequencia[f];
+    int k = grafo->num_por_frequencia[f];
+    for (int i = 0; i < k; i++) {
+        const Vertice* u = balde[i];
+        if (u == v) continue;
+        long long dx = (long long)u->x - v->x;
+        long long dy = (long long)u->y - v->y;
+        if (!alinhadas(dx, dy)) continue;
+        contar_efeito(grelha, v->x - dx, v->y - dy, delta);
+        contar_efeito(grelha, u->x + dx, u->y + dy, delta);
+    }
+}
+
+/**
+ * @brief Calcula a grelha de contagens de efeitos de todas as antenas do grafo
+ * @param grelha Grelha a inicializar
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details É o único passo que percorre todos os pares; depois disso, adicionar_antena,
+ * remover_antena e mover_antena só tocam nos pares da antena alterada
+ */
+int grelha_efeitos_iniciar(GrelhaEfeitos* grelha, Grafo* grafo, int linhas, int colunas) {
+    if (!grelha || !grafo || linhas < 0 || colunas < 0) return -1;
+    
+    size_t total = (size_t)linhas * colunas;
+    grelha->linhas = linhas;
+    grelha->colunas = colunas;
+    grelha->contagem = (unsigned int*)calloc(total ? total : 1, sizeof(unsigned int));
+    if (!grelha->contagem) return -2;
+    
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        Vertice** balde = grafo->por_frequencia[f];
+        int k = grafo->num_por_frequencia[f];
+        for (int i = 0; i < k; i++) {
+            for (int j = i + 1; j < k; j++) {
+                long long dx = (long long)balde[j]->x - balde[i]->x;
+                long long dy = (long long)balde[j]->y - balde[i]->y;
+                if (!alinhadas(dx, dy)) continue;
+                contar_efeito(grelha, balde[i]->x - dx, balde[i]->y - dy, 1);
+                contar_efeito(grelha, balde[j]->x + dx, balde[j]->y + dy, 1);
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Liberta a memória de uma grelha de efeitos
+ * @param grelha Grelha a libertar
+ */
+void grelha_efeitos_libertar(GrelhaEfeitos* grelha) {
+    if (!grelha) return;
+    free(grelha->contagem);
+    grelha->contagem = NULL;
+}
+
+/**
+ * @brief Preenche uma grelha de carateres a partir das contagens, como calcular_efeitos
+ * @param grelha Grelha de contagens
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param[out] celulas Grelha com linhas * colunas carateres
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ * 
+ * @details O resultado é igual ao de calcular_efeitos com as mesmas dimensões
+ */
+int grelha_efeitos_celulas(const GrelhaEfeitos* grelha, Grafo* grafo, char* celulas) {
+    if (!grelha || !grelha->contagem || !grafo || !celulas) return -1;
+    
+    size_t total = (size_t)grelha->linhas * grelha->colunas;
+    for (size_t i = 0; i < total; i++) celulas[i] = grelha->contagem[i] ? '#' : '.';
     
-    // Conectar arestas
     Vertice* v = grafo->vertices;
     while (v != NULL) {
-        Vertice* u = grafo->vertices;
-        while (u != NULL) {
-            if (v != u && v->frequencia == u->frequencia) {
-                adicionar_aresta(v, u);
-            }
-            u = u->proximo;
+        if (v->x >= 0 && v->x < grelha->colunas && v->y >= 0 && v->y < grelha->linhas) {
+            celulas[(size_t)v->y * grelha->colunas + v->x] = v->frequencia;
         }
         v = v->proximo;
     }
+    return 0;
+}
+
+/**
+ * @brief Adiciona uma antena ao grafo e os seus efeitos à grelha
+ * @param grafo Apontador para o grafo
+ * @param grelha Grelha de efeitos do grafo (pode ser NULL)
+ * @param cache Cache de resultados de onde descartar os da frequência (pode ser NULL)
+ * @param freq Frequência da antena
+ * @param x Coluna da antena
+ * @param y Linha da antena
+ * @return Apontador para o novo vértice, ou NULL se a posição estiver ocupada ou em caso de erro
+ * 
+ * @details Usa adicionar_vertice_ligado, pelo que só a frequência da antena é
+ * tocada, no grafo, na grelha e na cache: os resultados das outras frequências
+ * continuam a ser servidos
+ */
+Vertice* adicionar_antena(Grafo* grafo, GrelhaEfeitos* grelha, CacheResultados* cache, char freq, int x, int y) {
+    Vertice* v = adicionar_vertice_ligado(grafo, freq, x, y);
+    if (v && grelha && grelha->contagem) contar_efeitos_antena(grelha, grafo, v, 1);
+    if (v && cache) cache_resultados_invalidar(cache, freq);
+    return v;
+}
+
+/**
+ * @brief Retira os efeitos de uma antena da grelha e remove-a do grafo
+ * @param grafo Apontador para o grafo
+ * @param grelha Grelha de efeitos do grafo (pode ser NULL)
+ * @param cache Cache de resultados de onde descartar os da frequência (pode ser NULL)
+ * @param v Antena a remover
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ * 
+ * @details Uma antena que já não pertença ao grafo (vertice_pertence) é
+ * recusada antes de tocar na grelha ou na cache
+ */
+int remover_antena(Grafo* grafo, GrelhaEfeitos* grelha, CacheResultados* cache, Vertice* v) {
+    if (!vertice_pertence(grafo, v)) return -1;
+    char freq = v->frequencia;
+    if (grelha && grelha->contagem) contar_efeitos_antena(grelha, grafo, v, -1);
+    int resultado = remover_vertice(grafo, v);
+    if (resultado == 0 && cache) cache_resultados_invalidar(cache, freq);
+    return resultado;
+}
+
+/**
+ * @brief Muda uma antena de posição, atualizando os seus efeitos na grelha
+ * @param grafo Apontador para o grafo
+ * @param grelha Grelha de efeitos do grafo (pode ser NULL)
+ * @param cache Cache de resultados de onde descartar os da frequência (pode ser NULL)
+ * @param v Antena a mover
+ * @param x Nova coluna
+ * @param y Nova linha
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 se a nova posição estiver ocupada
+ */
+int mover_antena(Grafo* grafo, GrelhaEfeitos* grelha, CacheResultados* cache, Vertice* v, int x, int y) {
+    if (!vertice_pertence(grafo, v)) return -1;
+    if (v->x == x && v->y == y) return 0;
+    if (encontrar_vertice(grafo, x, y) != NULL) return -2;
     
-    return grafo;
+    bool com_grelha = grelha && grelha->contagem;
+    if (com_grelha) contar_efeitos_antena(grelha, grafo, v, -1);
+    int resultado = mover_vertice(grafo, v, x, y);
+    if (com_grelha) contar_efeitos_antena(grelha, grafo, v, 1);
+    if (resultado == 0 && cache) cache_resultados_invalidar(cache, v->frequencia);
+    return resultado;
+}
+
+/**
+ * @brief Escreve uma representação visual do mapa numa saída com buffer
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @param saida Saída de destino (não é fechada)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Produz o mesmo texto que imprimir_mapa. A única alocação é a grelha
+ * de calcular_efeitos; cada linha vai da grelha para o buffer da saída com um
+ * só memcpy.
+ */
+int escrever_mapa(Grafo* grafo, int linhas, int colunas, Saida* saida) {
+    return escrever_mapa_cache(grafo, NULL, linhas, colunas, saida);
+}
+
+/**
+ * @brief Escreve o mapa com as antenas e efeitos nefastos numa saída com buffer, usando uma cache de resultados
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param cache Cache de resultados (NULL para calcular sempre)
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * @param saida Saída de destino (não é fechada)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de memória
+ * 
+ * @details Produz o mesmo texto que escrever_mapa, com a grelha de calcular_efeitos_cache
+ */
+int escrever_mapa_cache(Grafo* grafo, CacheResultados* cache, int linhas, int colunas, Saida* saida) {
+    if (!grafo || !saida || linhas <= 0 || colunas <= 0) return -1;
+    
+    char* celulas = (char*)malloc((size_t)linhas * colunas);
+    if (!celulas) return -2;
+    int resultado = calcular_efeitos_cache(grafo, cache, linhas, colunas, celulas);
+    if (resultado != 0) {
+        free(celulas);
+        return resultado;
+    }
+    
+    for (int y = 0; y < linhas; y++) {
+        saida_escrever(saida, &celulas[(size_t)y * colunas], (size_t)colunas);
+        saida_caracter(saida, '\n');
+    }
+    
+    free(celulas);
+    return saida->erro ? -1 : 0;
 }
 
 /**
@@ -163,107 +1041,378 @@ Grafo* carregar_mapa(const char* ficheiro) {
  * - '#' para posições com efeito nefasto
  * - '.' para posições vazias
  * 
- * @note Calcula automaticamente as posições com efeito nefasto
- * considerando todas as combinações de antenas da mesma frequência
+ * @note Calcula as posições com efeito nefasto com calcular_efeitos, numa
+ * grelha contígua, considerando os pares de antenas da mesma frequência, e
+ * escreve-a com escrever_mapa num buffer na pilha
  */
 void imprimir_mapa(Grafo* grafo, int linhas, int colunas) {
-    Mapa* primeira_linha = NULL;
-    Mapa* ultima_linha = NULL;
+    imprimir_mapa_cache(grafo, NULL, linhas, colunas);
+}
+
+/**
+ * @brief Imprime uma representação visual do mapa na consola, usando uma cache de resultados
+ * @param grafo Apontador para o grafo contendo as antenas
+ * @param cache Cache de resultados (NULL para calcular sempre)
+ * @param linhas Número de linhas do mapa
+ * @param colunas Número de colunas do mapa
+ * 
+ * @details Imprime o mesmo que imprimir_mapa; as frequências cujas posições de
+ * efeito estão na cache com a assinatura atual não são calculadas
+ */
+void imprimir_mapa_cache(Grafo* grafo, CacheResultados* cache, int linhas, int colunas) {
+    char buffer[TAMANHO_BUFFER_ESCRITA];
+    Saida saida;
+    if (saida_ficheiro(&saida, stdout, buffer, sizeof(buffer)) != 0) return;
+    escrever_mapa_cache(grafo, cache, linhas, colunas, &saida);
+    saida_despejar(&saida);
+}
+
+/**
+ * @brief Lê a faixa seguinte do ficheiro para a memória da faixa
+ * @param m Mapa em faixas
+ * @param[out] faixa Primeira linha e número de linhas lidas
+ * @return 1 se leu uma faixa, 0 se o mapa terminou, -1 em caso de erro de leitura
+ */
+static int ler_faixa(MapaFaixas* m, FaixaMapa* faixa) {
+    if (m->proxima_linha >= m->cabecalho.linhas || m->cabecalho.colunas == 0) return 0;
     
-    // Criar todas as linhas do mapa
-    for (int y = 0; y < linhas; y++) {
-        Mapa* nova_linha = (Mapa*)malloc(sizeof(Mapa));
-        nova_linha->dados = (char*)malloc(colunas * sizeof(char));
-        
-        // Inicializar com pontos
-        for (int x = 0; x < colunas; x++) {
-            nova_linha->dados[x] = '.';
+    long long restantes = m->cabecalho.linhas - m->proxima_linha;
+    int num_linhas = restantes < m->linhas_por_faixa ? (int)restantes : m->linhas_por_faixa;
+    size_t bytes = (size_t)num_linhas * (size_t)m->cabecalho.colunas;
+    if (fread(m->celulas, 1, bytes, m->ficheiro) != bytes) return -1;
+    
+    faixa->y0 = m->proxima_linha;
+    faixa->num_linhas = num_linhas;
+    faixa->colunas = m->cabecalho.colunas;
+    faixa->celulas = m->celulas;
+    faixa->num_antenas = 0;
+    faixa->num_efeitos = 0;
+    m->proxima_linha += num_linhas;
+    return 1;
+}
+
+/**
+ * @brief Posiciona o ficheiro no primeiro caráter do mapa
+ * @param m Mapa em faixas
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+static int rebobinar_faixas(MapaFaixas* m) {
+    char bytes[TAMANHO_CABECALHO_V2];
+    rewind(m->ficheiro);
+    size_t lidos = fread(bytes, 1, sizeof(bytes), m->ficheiro);
+    if (ler_cabecalho_mapa(bytes, lidos, &m->cabecalho) != 0) return -1;
+    if (fseek(m->ficheiro, (long)m->cabecalho.tamanho, SEEK_SET) != 0) return -1;
+    m->proxima_linha = 0;
+    return 0;
+}
+
+/**
+ * @brief Guarda a posição de uma antena no vetor da sua frequência
+ * @param antenas Antenas da frequência
+ * @param x Coluna da antena
+ * @param y Linha da antena
+ * @return 0 em caso de sucesso, -1 em caso de erro de memória
+ */
+static int guardar_antena(AntenasFrequencia* antenas, long long x, long long y) {
+    if (antenas->num == antenas->cap) {
+        size_t nova_cap = antenas->cap ? 2 * antenas->cap : 64;
+        long long* nx = (long long*)realloc(antenas->x, nova_cap * sizeof(long long));
+        if (!nx) return -1;
+        antenas->x = nx;
+        long long* ny = (long long*)realloc(antenas->y, nova_cap * sizeof(long long));
+        if (!ny) return -1;
+        antenas->y = ny;
+        antenas->cap = nova_cap;
+    }
+    antenas->x[antenas->num] = x;
+    antenas->y[antenas->num] = y;
+    antenas->num++;
+    return 0;
+}
+
+/**
+ * @brief Abre um mapa para processamento em faixas horizontais
+ * @param ficheiro Caminho do mapa (cabeçalho da versão 1 ou 2)
+ * @param linhas_por_faixa Número máximo de linhas em memória de cada vez
+ * @return Apontador para o mapa em faixas ou NULL em caso de erro
+ * 
+ * @details Faz já a primeira passagem pelo ficheiro, faixa a faixa, guardando
+ * apenas a posição das antenas de cada frequência (que ficam ordenadas por linha
+ * e coluna). A memória usada é a de uma faixa mais a das antenas, e não depende
+ * do tamanho da grelha. Uma faixa de uma linha tem de caber em memória.
+ */
+MapaFaixas* abrir_mapa_faixas(const char* ficheiro, int linhas_por_faixa) {
+    if (!ficheiro || linhas_por_faixa <= 0) return NULL;
+    
+    MapaFaixas* m = (MapaFaixas*)calloc(1, sizeof(MapaFaixas));
+    if (!m) return NULL;
+    m->linhas_por_faixa = linhas_por_faixa;
+    m->ficheiro = fopen(ficheiro, "rb");
+    if (!m->ficheiro || rebobinar_faixas(m) != 0) {
+        fechar_mapa_faixas(m);
+        return NULL;
+    }
+    
+    // A faixa tem de ser endereçável; sem isso, nem uma linha cabe em memória
+    long long colunas = m->cabecalho.colunas;
+    if (colunas > 0 && (unsigned long long)colunas > SIZE_MAX / (size_t)linhas_por_faixa) {
+        fechar_mapa_faixas(m);
+        return NULL;
+    }
+    m->celulas = (char*)malloc(colunas > 0 ? (size_t)linhas_por_faixa * (size_t)colunas : 1);
+    if (!m->celulas) {
+        fechar_mapa_faixas(m);
+        return NULL;
+    }
+    
+    // Primeira passagem: antenas
+    FaixaMapa faixa;
+    int estado;
+    while ((estado = ler_faixa(m, &faixa)) == 1) {
+        size_t total = (size_t)faixa.num_linhas * (size_t)colunas;
+        for (size_t i = proxima_antena(faixa.celulas, 0, total); i < total; i = proxima_antena(faixa.celulas, i + 1, total)) {
+            unsigned char f = (unsigned char)faixa.celulas[i];
+            long long y = faixa.y0 + (long long)(i / (size_t)colunas);
+            long long x = (long long)(i % (size_t)colunas);
+            if (guardar_antena(&m->antenas[f], x, y) != 0) {
+                estado = -1;
+                break;
+            }
+            m->num_antenas++;
         }
-        
-        nova_linha->prox = NULL;
-        
-        // Adicionar à lista
-        if (primeira_linha == NULL) {
-            primeira_linha = nova_linha;
-            ultima_linha = nova_linha;
-        } else {
-            ultima_linha->prox = nova_linha;
-            ultima_linha = nova_linha;
+        if (estado != 1) break;
+    }
+    
+    if (estado != 0 || rebobinar_faixas(m) != 0) {
+        fechar_mapa_faixas(m);
+        return NULL;
+    }
+    return m;
+}
+
+/**
+ * @brief Fecha um mapa em faixas, libertando toda a memória
+ * @param m Mapa em faixas
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int fechar_mapa_faixas(MapaFaixas* m) {
+    if (!m) return -1;
+    if (m->ficheiro) fclose(m->ficheiro);
+    free(m->celulas);
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        free(m->antenas[f].x);
+        free(m->antenas[f].y);
+    }
+    free(m);
+    return 0;
+}
+
+/**
+ * @brief Primeira posição de um vetor ordenado com valor >= alvo
+ * @param v Vetor ordenado por ordem crescente
+ * @param n Número de elementos
+ * @param alvo Valor procurado
+ */
+static size_t limite_inferior(const long long* v, size_t n, long long alvo) {
+    size_t lo = 0, hi = n;
+    while (lo < hi) {
+        size_t meio = lo + (hi - lo) / 2;
+        if (v[meio] < alvo) lo = meio + 1; else hi = meio;
+    }
+    return lo;
+}
+
+/**
+ * @brief Lê a faixa seguinte e marca nela as antenas e os efeitos nefastos
+ * @param m Mapa em faixas
+ * @param[out] faixa Faixa lida; faixa->celulas fica como em imprimir_mapa
+ * @return 1 se leu uma faixa, 0 se o mapa terminou, -1 em caso de erro
+ * 
+ * @details Um efeito nefasto do par (v, u) fica em 2v - u. Para cada antena v,
+ * as antenas u da mesma frequência cujo efeito cai na faixa [y0, y0 + n) são as
+ * de linha entre 2 v.y - (y0 + n) + 1 e 2 v.y - y0, encontradas por pesquisa
+ * binária no vetor da frequência, ordenado por linha. Cada faixa custa assim
+ * O(V log V) mais o número de pares (v, u) examinados, que no pior caso (todas
+ * as antenas de uma frequência em poucas linhas) é O(k^2) para k antenas da
+ * frequência. A junção das faixas dá exatamente o mapa inteiro.
+ */
+int proxima_faixa(MapaFaixas* m, FaixaMapa* faixa) {
+    if (!m || !faixa) return -1;
+    int estado = ler_faixa(m, faixa);
+    if (estado != 1) return estado;
+    
+    long long colunas = faixa->colunas;
+    long long y0 = faixa->y0, y1 = faixa->y0 + faixa->num_linhas;
+    size_t total = (size_t)faixa->num_linhas * (size_t)colunas;
+    for (size_t i = proxima_antena(m->celulas, 0, total); i < total; i = proxima_antena(m->celulas, i + 1, total)) {
+        faixa->num_antenas++;
+    }
+    
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) {
+        const AntenasFrequencia* a = &m->antenas[f];
+        if (a->num < 2) continue;
+        for (size_t v = 0; v < a->num; v++) {
+            size_t inicio = limite_inferior(a->y, a->num, 2 * a->y[v] - y1 + 1);
+            size_t fim = limite_inferior(a->y, a->num, 2 * a->y[v] - y0 + 1);
+            for (size_t u = inicio; u < fim; u++) {
+                if (u == v) continue;
+                long long dx = a->x[u] - a->x[v], dy = a->y[u] - a->y[v];
+                long long x = a->x[v] - dx, y = a->y[v] - dy;
+                if (x < 0 || x >= colunas || !alinhadas(dx, dy)) continue;
+                char* c = &m->celulas[(size_t)(y - y0) * (size_t)colunas + (size_t)x];
+                if (*c == '.') {
+                    *c = '#';
+                    faixa->num_efeitos++;
+                }
+            }
         }
     }
+    return 1;
+}
 
-    // Marcar antenas no mapa
-    Vertice* v = grafo->vertices;
-    while (v != NULL) {
-        // Encontrar a linha correta
-        Mapa* linha_atual = primeira_linha;
-        for (int y = 0; y < v->y; y++) {
-            linha_atual = linha_atual->prox;
+/**
+ * @struct CursorSegmentos
+ * @brief Posição na enumeração dos segmentos de uma frequência que atravessam uma faixa
+ */
+typedef struct {
+    const AntenasFrequencia* antenas; ///< Antenas da frequência, ordenadas por linha
+    size_t fim;             ///< Primeira antena com linha >= y1
+    size_t desde;           ///< Primeira antena com linha >= y0
+    size_t i, j;            ///< Próximo par (i, j) a gerar
+} CursorSegmentos;
+
+/**
+ * @brief Posiciona um cursor no primeiro segmento que atravessa as linhas [y0, y1)
+ * @param c Cursor a iniciar
+ * @param a Antenas da frequência, ordenadas por linha
+ * @param y0 Primeira linha da faixa
+ * @param y1 Linha a seguir à última da faixa
+ */
+static void cursor_iniciar(CursorSegmentos* c, const AntenasFrequencia* a, long long y0, long long y1) {
+    c->antenas = a;
+    c->fim = limite_inferior(a->y, a->num, y1);
+    c->desde = limite_inferior(a->y, a->num, y0);
+    c->i = 0;
+    c->j = c->desde > 1 ? c->desde : 1;
+}
+
+/**
+ * @brief Recolhe o bloco seguinte de segmentos que atravessam a faixa
+ * @param c Cursor da frequência
+ * @param[out] lote Lote a preencher (esvaziado antes)
+ * @return Número de segmentos recolhidos (0 quando o cursor terminou), ou -1 em caso de erro de memória
+ * 
+ * @details Um segmento (i, j), com i < j na ordem por linha, atravessa a faixa
+ * se a antena i está antes de y1 e a j não está antes de y0. Cada chamada
+ * recolhe no máximo SEGMENTOS_POR_BLOCO segmentos e continua onde a anterior parou.
+ */
+static int segmentos_faixa(CursorSegmentos* c, LoteSegmentos* lote) {
+    const AntenasFrequencia* a = c->antenas;
+    lote->num = 0;
+    while (c->i < c->fim && lote->num < SEGMENTOS_POR_BLOCO) {
+        if (c->j >= a->num) {
+            c->i++;
+            c->j = c->desde > c->i + 1 ? c->desde : c->i + 1;
+            continue;
         }
-        linha_atual->dados[v->x] = v->frequencia;
-        v = v->proximo;
+        Segmento s = { (int)a->x[c->i], (int)a->y[c->i], (int)a->x[c->j], (int)a->y[c->j] };
+        if (lote_acrescentar(lote, &s) != 0) return -1;
+        c->j++;
     }
+    return lote->num;
+}
+
+/**
+ * @brief Conta as intersecções entre duas frequências cujo ponto fica numa faixa
+ * @param m Mapa em faixas
+ * @param faixa Faixa devolvida por proxima_faixa
+ * @param freqA Primeira frequência
+ * @param freqB Segunda frequência
+ * @return Número de intersecções com ponto na faixa, ou -1 em caso de erro
+ * 
+ * @details Só entram os segmentos (pares de antenas da mesma frequência) cujas
+ * linhas atravessam a faixa, e só contam os pontos com linha dentro dela. Como
+ * cada ponto pertence a uma só faixa, a soma sobre todas as faixas é igual ao
+ * valor de intersecoes_frequencias para o mapa inteiro. As coordenadas têm de
+ * caber no intervalo de intersecao.h (menos de 2^30 linhas e colunas).
+ * 
+ * Os segmentos são tratados em blocos de SEGMENTOS_POR_BLOCO por frequência,
+ * cruzando cada bloco de freqA com todos os de freqB, e os pontos repetidos
+ * entre blocos são eliminados com um mapa de bits das células da faixa. A
+ * memória fica assim limitada, mas o tempo continua proporcional ao número de
+ * segmentos que atravessam a faixa, que é O(k^2) para k antenas da frequência.
+ */
+long long intersecoes_faixa(const MapaFaixas* m, const FaixaMapa* faixa, char freqA, char freqB) {
+    if (!m || !faixa) return -1;
+    const long long limite = 1LL << 30;
+    if (m->cabecalho.linhas >= limite || m->cabecalho.colunas >= limite) return -1;
     
-    // Marcar efeitos nefastos
-    v = grafo->vertices;
-    while (v != NULL) {
-        Vertice* u = grafo->vertices;
-        while (u != NULL) {
-            if (v != u && v->frequencia == u->frequencia) {
-                int dx = u->x - v->x;
-                int dy = u->y - v->y;
-                
-                // Verificar alinhamento para efeito nefasto
-                if (dx == 0 || dy == 0 || abs(dx) == abs(dy) || 
-                    (abs(dx) == 2*abs(dy)) || (2*abs(dx) == abs(dy)) ||
-                    (abs(dx) == 3*abs(dy)) || (3*abs(dx) == abs(dy))) {
-                    
-                    // Pontos de efeito nefasto
-                    int x1 = v->x - dx;
-                    int y1 = v->y - dy;
-                    int x2 = u->x + dx;
-                    int y2 = u->y + dy;
-                    
-                    // Marcar no mapa se estiver dentro dos limites
-                    if (x1 >= 0 && x1 < colunas && y1 >= 0 && y1 < linhas) {
-                        Mapa* linha = primeira_linha;
-                        for (int y = 0; y < y1; y++) {
-                            linha = linha->prox;
-                        }
-                        if (linha->dados[x1] == '.') {
-                            linha->dados[x1] = '#';
-                        }
-                    }
-                    
-                    if (x2 >= 0 && x2 < colunas && y2 >= 0 && y2 < linhas) {
-                        Mapa* linha = primeira_linha;
-                        for (int y = 0; y < y2; y++) {
-                            linha = linha->prox;
-                        }
-                        if (linha->dados[x2] == '.') {
-                            linha->dados[x2] = '#';
-                        }
-                    }
+    long long y0 = faixa->y0, y1 = faixa->y0 + faixa->num_linhas;
+    size_t celulas = (size_t)faixa->num_linhas * (size_t)faixa->colunas;
+    uint64_t* vistos = calloc(celulas / 64 + 1, sizeof(uint64_t));
+    if (!vistos) return -1;
+    
+    LoteSegmentos loteA, loteB;
+    lote_iniciar(&loteA);
+    lote_iniciar(&loteB);
+    CursorSegmentos cursorA, cursorB;
+    cursor_iniciar(&cursorA, &m->antenas[(unsigned char)freqA], y0, y1);
+    long long total = 0;
+    int numA;
+    
+    while (total >= 0 && (numA = segmentos_faixa(&cursorA, &loteA)) != 0) {
+        if (numA < 0) { total = -1; break; }
+        cursor_iniciar(&cursorB, &m->antenas[(unsigned char)freqB], y0, y1);
+        int numB;
+        while ((numB = segmentos_faixa(&cursorB, &loteB)) != 0) {
+            Cruzamento* cruzamentos = NULL;
+            int num = numB < 0 ? -1 : detetar_intersecoes(&loteA, &loteB, &cruzamentos);
+            if (num < 0) { total = -1; break; }
+            for (int k = 0; k < num; k++) {
+                if (cruzamentos[k].y < y0 || cruzamentos[k].y >= y1 || cruzamentos[k].x >= faixa->colunas) continue;
+                size_t c = (size_t)(cruzamentos[k].y - y0) * (size_t)faixa->colunas + (size_t)cruzamentos[k].x;
+                if (!(vistos[c / 64] & (1ULL << (c % 64)))) {
+                    vistos[c / 64] |= 1ULL << (c % 64);
+                    total++;
                 }
             }
-            u = u->proximo;
+            free(cruzamentos);
         }
-        v = v->proximo;
     }
     
-    // Imprimir mapa
-    Mapa* linha = primeira_linha;
-    while (linha != NULL) {
-        printf("%.*s\n", colunas, linha->dados);
-        linha = linha->prox;
-    }
+    free(vistos);
+    lote_libertar(&loteA);
+    lote_libertar(&loteB);
+    return total;
+}
+
+/**
+ * @brief Imprime um mapa com os efeitos nefastos, uma faixa de cada vez
+ * @param ficheiro Caminho do mapa
+ * @param linhas_por_faixa Número máximo de linhas em memória de cada vez
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ * 
+ * @details Produz o mesmo resultado que imprimir_mapa depois de carregar_mapa,
+ * sem construir o grafo nem a grelha inteira
+ */
+int imprimir_mapa_faixas(const char* ficheiro, int linhas_por_faixa) {
+    MapaFaixas* m = abrir_mapa_faixas(ficheiro, linhas_por_faixa);
+    if (!m) return -1;
+    
+    char buffer[TAMANHO_BUFFER_ESCRITA];
+    Saida saida;
+    saida_ficheiro(&saida, stdout, buffer, sizeof(buffer));
     
-    // Liberar memória
-    linha = primeira_linha;
-    while (linha != NULL) {
-        Mapa* temp = linha;
-        linha = linha->prox;
-        free(temp->dados);
-        free(temp);
+    FaixaMapa faixa;
+    int estado;
+    while ((estado = proxima_faixa(m, &faixa)) == 1) {
+        for (int y = 0; y < faixa.num_linhas; y++) {
+            saida_escrever(&saida, &faixa.celulas[(size_t)y * (size_t)faixa.colunas], (size_t)faixa.colunas);
+            saida_caracter(&saida, '\n');
+        }
     }
-}
\ No newline at end of file
+    
+    fechar_mapa_faixas(m);
+    if (saida_despejar(&saida) != 0) return -1;
+    return estado == 0 ? 0 : -1;
+}
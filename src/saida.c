@@ -0,0 +1,261 @@
+/**
+ * @file saida.c
+ * @brief Implementação da escrita com buffer próprio
+ *
+ * @details Implementa as funções declaradas em saida.h. Os inteiros são
+ * convertidos à mão, diretamente para o buffer, e os bytes só saem do buffer
+ * quando este enche ou em saida_despejar, num único fwrite, write ou gzwrite.
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+#ifdef EDA_ZLIB
+#include <zlib.h>
+#endif
+#include "saida.h"
+
+/**
+ * @brief Preenche os campos comuns a todos os destinos
+ * @param saida Saída a preparar
+ * @param tipo Tipo do destino
+ * @param buffer Buffer de escrita
+ * @param capacidade Tamanho do buffer
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+static int preparar_saida(Saida* saida, TipoSaida tipo, char* buffer, size_t capacidade) {
+    if (!saida || !buffer || capacidade < MIN_BUFFER_ESCRITA) return -1;
+    memset(saida, 0, sizeof(Saida));
+    saida->buffer = buffer;
+    saida->capacidade = capacidade;
+    saida->tipo = tipo;
+    saida->descritor = -1;
+    return 0;
+}
+
+/**
+ * @brief Prepara uma saída para um FILE
+ * @param saida Saída a preparar
+ * @param ficheiro Ficheiro de destino
+ * @param buffer Buffer de escrita (pelo menos MIN_BUFFER_ESCRITA bytes)
+ * @param capacidade Tamanho do buffer
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ *
+ * @details Como a escrita passa por fwrite, a ordem em relação a printf no
+ * mesmo FILE mantém-se, desde que a saída seja despejada antes do printf
+ */
+int saida_ficheiro(Saida* saida, FILE* ficheiro, char* buffer, size_t capacidade) {
+    if (!ficheiro || preparar_saida(saida, SAIDA_FICHEIRO, buffer, capacidade) != 0) return -1;
+    saida->ficheiro = ficheiro;
+    return 0;
+}
+
+/**
+ * @brief Prepara uma saída para um descritor de ficheiro
+ * @param saida Saída a preparar
+ * @param descritor Descritor de destino (por exemplo 1 para a saída padrão)
+ * @param buffer Buffer de escrita (pelo menos MIN_BUFFER_ESCRITA bytes)
+ * @param capacidade Tamanho do buffer
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ *
+ * @details A escrita não passa pelo buffer do FILE associado ao descritor; se
+ * esse FILE também for usado, deve ser despejado com fflush antes
+ */
+int saida_descritor(Saida* saida, int descritor, char* buffer, size_t capacidade) {
+    if (descritor < 0 || preparar_saida(saida, SAIDA_DESCRITOR, buffer, capacidade) != 0) return -1;
+    saida->descritor = descritor;
+    return 0;
+}
+
+/**
+ * @brief Abre um ficheiro gzip para escrita
+ * @param saida Saída a preparar
+ * @param nome Caminho do ficheiro a criar
+ * @param buffer Buffer de escrita (pelo menos MIN_BUFFER_ESCRITA bytes)
+ * @param capacidade Tamanho do buffer
+ * @return 0 em caso de sucesso, -1 em caso de erro ou se EDA_ZLIB não estiver definido
+ */
+int saida_comprimida(Saida* saida, const char* nome, char* buffer, size_t capacidade) {
+#ifdef EDA_ZLIB
+    if (!nome || preparar_saida(saida, SAIDA_COMPRIMIDA, buffer, capacidade) != 0) return -1;
+    gzFile gz = gzopen(nome, "wb");
+    if (!gz) return -1;
+    saida->comprimido = gz;
+    return 0;
+#else
+    (void)saida;
+    (void)nome;
+    (void)buffer;
+    (void)capacidade;
+    return -1;
+#endif
+}
+
+/**
+ * @brief Escreve um descritor até ao fim, repetindo as escritas parciais
+ * @param descritor Descritor de destino
+ * @param dados Bytes a escrever
+ * @param tamanho Número de bytes
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+static int escrever_descritor(int descritor, const char* dados, size_t tamanho) {
+    while (tamanho > 0) {
+#ifdef _WIN32
+        int escritos = _write(descritor, dados, tamanho > 0x40000000u ? 0x40000000u : (unsigned)tamanho);
+#else
+        ssize_t escritos = write(descritor, dados, tamanho);
+#endif
+        if (escritos < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        dados += escritos;
+        tamanho -= (size_t)escritos;
+    }
+    return 0;
+}
+
+/**
+ * @brief Entrega ao destino tudo o que está no buffer
+ * @param saida Saída
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ *
+ * @details Depois de um erro o buffer é descartado e as escritas seguintes
+ * são ignoradas, ficando o erro registado até saida_fechar
+ */
+int saida_despejar(Saida* saida) {
+    if (!saida) return -1;
+    if (saida->usados > 0 && !saida->erro) {
+        switch (saida->tipo) {
+        case SAIDA_FICHEIRO:
+            if (fwrite(saida->buffer, 1, saida->usados, saida->ficheiro) != saida->usados) saida->erro = 1;
+            break;
+        case SAIDA_DESCRITOR:
+            if (escrever_descritor(saida->descritor, saida->buffer, saida->usados) != 0) saida->erro = 1;
+            break;
+        case SAIDA_COMPRIMIDA:
+#ifdef EDA_ZLIB
+            if (gzwrite((gzFile)saida->comprimido, saida->buffer, (unsigned)saida->usados) != (int)saida->usados) {
+                saida->erro = 1;
+            }
+#else
+            saida->erro = 1;
+#endif
+            break;
+        }
+    }
+    saida->usados = 0;
+    return saida->erro ? -1 : 0;
+}
+
+/**
+ * @brief Despeja o buffer e termina a saída
+ * @param saida Saída
+ * @return 0 se todas as escritas correram bem, -1 caso contrário
+ *
+ * @details Fecha o ficheiro gzip; os FILE e os descritores não são fechados,
+ * mas um FILE é despejado com fflush
+ */
+int saida_fechar(Saida* saida) {
+    if (!saida) return -1;
+    saida_despejar(saida);
+    if (saida->tipo == SAIDA_FICHEIRO && saida->ficheiro) {
+        if (fflush(saida->ficheiro) != 0) saida->erro = 1;
+    }
+#ifdef EDA_ZLIB
+    if (saida->tipo == SAIDA_COMPRIMIDA && saida->comprimido) {
+        if (gzclose((gzFile)saida->comprimido) != Z_OK) saida->erro = 1;
+        saida->comprimido = NULL;
+    }
+#endif
+    return saida->erro ? -1 : 0;
+}
+
+/**
+ * @brief Escreve um bloco de bytes
+ * @param saida Saída
+ * @param dados Bytes a escrever
+ * @param tamanho Número de bytes
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ *
+ * @details Blocos maiores do que o buffer são entregues diretamente ao
+ * destino, depois de despejar o que já lá estava
+ */
+int saida_escrever(Saida* saida, const char* dados, size_t tamanho) {
+    if (!saida || (!dados && tamanho > 0)) return -1;
+    if (saida->usados + tamanho > saida->capacidade) {
+        if (saida_despejar(saida) != 0) return -1;
+        if (tamanho > saida->capacidade) {
+            char* buffer = saida->buffer;
+            saida->buffer = (char*)dados;
+            saida->usados = tamanho;
+            int resultado = saida_despejar(saida);
+            saida->buffer = buffer;
+            return resultado;
+        }
+    }
+    memcpy(saida->buffer + saida->usados, dados, tamanho);
+    saida->usados += tamanho;
+    return 0;
+}
+
+/**
+ * @brief Escreve um texto terminado em '\0'
+ * @param saida Saída
+ * @param texto Texto a escrever
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int saida_texto(Saida* saida, const char* texto) {
+    if (!texto) return -1;
+    return saida_escrever(saida, texto, strlen(texto));
+}
+
+/**
+ * @brief Escreve um caráter
+ * @param saida Saída
+ * @param c Caráter a escrever
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int saida_caracter(Saida* saida, char c) {
+    if (!saida) return -1;
+    if (saida->usados == saida->capacidade && saida_despejar(saida) != 0) return -1;
+    saida->buffer[saida->usados++] = c;
+    return 0;
+}
+
+/**
+ * @brief Escreve um inteiro em base 10, como "%lld"
+ * @param saida Saída
+ * @param valor Inteiro a escrever
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ *
+ * @details Os algarismos são gerados do fim para o início num vetor local e
+ * copiados de uma vez; o valor absoluto é calculado sem sinal, pelo que
+ * LLONG_MIN também é escrito corretamente
+ */
+int saida_inteiro(Saida* saida, long long valor) {
+    if (!saida) return -1;
+    char algarismos[24];
+    char* p = algarismos + sizeof(algarismos);
+    unsigned long long resto = valor < 0 ? 0ull - (unsigned long long)valor : (unsigned long long)valor;
+    do {
+        *--p = (char)('0' + resto % 10);
+        resto /= 10;
+    } while (resto > 0);
+    if (valor < 0) *--p = '-';
+    return saida_escrever(saida, p, (size_t)(algarismos + sizeof(algarismos) - p));
+}
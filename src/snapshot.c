@@ -0,0 +1,492 @@
+/**
+ * @file snapshot.c
+ * @brief Implementação dos instantâneos binários de grafos
+ *
+ * @details Implementa as funções declaradas em snapshot.h, incluindo:
+ * - Escrita do cabeçalho e das secções alinhadas, com somas de verificação
+ * - Validação e abertura por mapeamento em memória, sem cópias
+ * - Reconstrução automática do instantâneo quando o mapa de origem muda
+ *
+ * @author Diogo Pereira
+ * @date 18 Maio 2025
+ * @version 1.0
+ *
+ * @copyright Copyright (c) 2025
+ *
+ * @course Licenciatura em Engenharia de Sistemas Informáticos
+ * @institution EST-IPCA
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "grafo.h"
+#include "csr.h"
+#include "mapa.h"
+#include "snapshot.h"
+
+/**
+ * @brief Identificação dos ficheiros de instantâneo
+ */
+static const char MAGIA_SNAPSHOT[8] = { 'E', 'D', 'A', 'S', 'N', 'A', 'P', '\0' };
+
+/**
+ * @brief Cabeçalho de um instantâneo, tal como está gravado no início do ficheiro
+ *
+ * @details Todos os campos têm tamanho fixo e o cabeçalho ocupa um múltiplo de
+ * 8 bytes, pelo que a primeira secção fica alinhada. As posições são contadas a
+ * partir do início do ficheiro.
+ */
+typedef struct {
+    char magia[8];                  ///< MAGIA_SNAPSHOT
+    uint32_t versao;                ///< VERSAO_SNAPSHOT
+    uint32_t tamanho_cabecalho;     ///< sizeof(CabecalhoSnapshot)
+    uint64_t tamanho_ficheiro;      ///< Tamanho total do ficheiro
+    int32_t num_vertices;           ///< Número de vértices
+    uint32_t num_frequencias;       ///< NUM_FREQUENCIAS
+    uint64_t num_arestas;           ///< Número de entradas em destinos
+    uint64_t tamanho_origem;        ///< Tamanho do mapa de origem (0 se desconhecido)
+    int64_t data_origem;            ///< Data de modificação do mapa de origem, em segundos (0 se desconhecida)
+    int64_t data_origem_ns;         ///< Nanossegundos da data de modificação do mapa de origem (0 se desconhecidos)
+    uint64_t soma_origem;           ///< Soma de verificação do conteúdo do mapa de origem (0 se não foi precisa)
+    uint64_t inode_origem;          ///< Número do inode do mapa de origem (0 se desconhecido)
+    int64_t data_criacao;           ///< Data de gravação do instantâneo, em segundos
+    uint64_t pos_offsets;           ///< Posição da secção offsets
+    uint64_t pos_destinos;          ///< Posição da secção destinos
+    uint64_t pos_x;                 ///< Posição da secção x
+    uint64_t pos_y;                 ///< Posição da secção y
+    uint64_t pos_frequencia;        ///< Posição da secção frequencia
+    uint64_t pos_inicio_frequencia; ///< Posição da secção inicio_frequencia
+    uint64_t pos_por_frequencia;    ///< Posição da secção por_frequencia
+    uint64_t pos_por_posicao;       ///< Posição da secção por_posicao
+    uint64_t soma_dados;            ///< Soma de verificação de tudo o que segue o cabeçalho
+    uint64_t soma_cabecalho;        ///< Soma de verificação do cabeçalho, com este campo a 0
+} CabecalhoSnapshot;
+
+/**
+ * @brief Arredonda um tamanho para o múltiplo de 8 seguinte
+ */
+static uint64_t alinhar8(uint64_t n) {
+    return (n + 7) & ~(uint64_t)7;
+}
+
+/**
+ * @brief Acumula bytes numa soma de verificação FNV-1a de 64 bits
+ * @param soma Soma acumulada até agora
+ * @param dados Bytes a acrescentar
+ * @param n Número de bytes
+ * @return Nova soma
+ *
+ * @details Os bytes são consumidos 8 de cada vez, como uma palavra, o que torna
+ * a soma dos dados (que podem ter centenas de MB) várias vezes mais rápida do
+ * que byte a byte; o resto é consumido byte a byte.
+ */
+static uint64_t somar(uint64_t soma, const void* dados, size_t n) {
+    const unsigned char* p = (const unsigned char*)dados;
+    const uint64_t primo = 0x100000001B3ULL;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t palavra;
+        memcpy(&palavra, p + i, 8);
+        soma = (soma ^ palavra) * primo;
+        soma ^= soma >> 29;
+    }
+    for (; i < n; i++) {
+        soma = (soma ^ p[i]) * primo;
+    }
+    return soma;
+}
+
+/**
+ * @brief Valor inicial das somas de verificação
+ */
+#define SOMA_INICIAL 0xCBF29CE484222325ULL
+
+/**
+ * @brief Calcula a soma de verificação de um cabeçalho, ignorando o campo soma_cabecalho
+ */
+static uint64_t somar_cabecalho(const CabecalhoSnapshot* cabecalho) {
+    CabecalhoSnapshot copia = *cabecalho;
+    copia.soma_cabecalho = 0;
+    return somar(SOMA_INICIAL, &copia, sizeof(copia));
+}
+
+/**
+ * @brief Segundos entre a data do mapa e a do instantâneo abaixo dos quais o conteúdo do mapa é somado
+ *
+ * @details Cobre a resolução das datas dos sistemas de ficheiros mais grosseiros
+ * (2 segundos em FAT; 1 segundo no Windows)
+ */
+#define MARGEM_DATA_ORIGEM 2
+
+/**
+ * @brief Identificação de um mapa de origem: tamanho, data, inode e conteúdo
+ */
+typedef struct {
+    uint64_t tamanho;   ///< Tamanho em bytes
+    int64_t data;       ///< Data de modificação, em segundos
+    int64_t data_ns;    ///< Nanossegundos da data de modificação
+    uint64_t inode;     ///< Número do inode (0 onde não existe)
+    uint64_t soma;      ///< Soma de verificação do conteúdo (0 se não foi pedida)
+} IdentificacaoOrigem;
+
+/**
+ * @brief Indica se um mapa foi modificado perto demais da gravação do instantâneo para a data o distinguir
+ * @param data Data de modificação do mapa, em segundos
+ * @param criacao Data de gravação do instantâneo, em segundos
+ *
+ * @details Uma alteração feita depois da gravação tem uma data posterior a
+ * criacao; se a data gravada for anterior a criacao por mais do que a resolução
+ * das datas, essa alteração muda forçosamente a data do mapa. Só no caso
+ * contrário é preciso comparar o conteúdo.
+ */
+static bool origem_recente(int64_t data, int64_t criacao) {
+    return criacao - data < MARGEM_DATA_ORIGEM;
+}
+
+/**
+ * @brief Obtém o tamanho, a data de modificação, o inode e, se pedida, a soma do conteúdo de um ficheiro
+ * @param nome Caminho do ficheiro (pode ser NULL)
+ * @param[out] id Identificação do ficheiro (tudo a 0 se nome for NULL)
+ * @param com_soma Indica se o conteúdo deve ser somado
+ * @return 0 em caso de sucesso, -1 se o ficheiro não existir ou não puder ser lido
+ *
+ * @details Sem soma, custa um stat, independentemente do tamanho do mapa. A soma
+ * lê o ficheiro todo, mapeado em memória, numa única passagem.
+ */
+static int identificar_origem(const char* nome, IdentificacaoOrigem* id, bool com_soma) {
+    memset(id, 0, sizeof(*id));
+    if (!nome) return 0;
+    struct stat info;
+    if (stat(nome, &info) != 0) return -1;
+    id->tamanho = (uint64_t)info.st_size;
+    id->data = (int64_t)info.st_mtime;
+    id->inode = (uint64_t)info.st_ino;
+#if defined(__APPLE__)
+    id->data_ns = (int64_t)info.st_mtimespec.tv_nsec;
+#elif !defined(_WIN32)
+    id->data_ns = (int64_t)info.st_mtim.tv_nsec;
+#endif
+    if (!com_soma) return 0;
+
+    FicheiroMapeado mapeamento;
+    if (mapear_ficheiro(nome, &mapeamento) != 0) return -1;
+    id->soma = somar(SOMA_INICIAL, mapeamento.dados, mapeamento.tamanho);
+    libertar_mapeamento(&mapeamento);
+    return 0;
+}
+
+/**
+ * @brief Escreve uma secção no ficheiro, seguida dos bytes de alinhamento
+ * @param f Ficheiro
+ * @param dados Conteúdo da secção
+ * @param n Tamanho da secção em bytes
+ * @param[in,out] soma Soma de verificação dos dados
+ * @return 0 em caso de sucesso, -1 em caso de erro de escrita
+ */
+static int escrever_secao(FILE* f, const void* dados, size_t n, uint64_t* soma) {
+    static const unsigned char zeros[8] = { 0 };
+    size_t enchimento = (size_t)(alinhar8(n) - n);
+    if (n > 0 && fwrite(dados, 1, n, f) != n) return -1;
+    if (enchimento > 0 && fwrite(zeros, 1, enchimento, f) != enchimento) return -1;
+    // A soma é feita sobre a secção já alinhada, como verificar_snapshot a lê
+    size_t inteiras = n & ~(size_t)7;
+    *soma = somar(*soma, dados, inteiras);
+    if (n > inteiras) {
+        unsigned char ultima[8] = { 0 };
+        memcpy(ultima, (const unsigned char*)dados + inteiras, n - inteiras);
+        *soma = somar(*soma, ultima, sizeof(ultima));
+    }
+    return 0;
+}
+
+/**
+ * @brief Grava um grafo CSR num ficheiro de instantâneo
+ * @param csr Grafo a gravar
+ * @param ficheiro Caminho do instantâneo
+ * @param origem Mapa de onde o grafo foi carregado (pode ser NULL)
+ * @return 0 em caso de sucesso, -1 em caso de erro, -2 em caso de erro de escrita
+ *
+ * @details O índice de frequências é calculado a partir de csr: como os índices
+ * dos vértices seguem a ordem de inserção, percorrê-los por ordem dá os vetores
+ * por frequência do grafo original. O ficheiro é escrito com outro nome e só no
+ * fim substitui o anterior, pelo que um instantâneo meio escrito nunca é aberto.
+ */
+int gravar_snapshot(const GrafoCSR* csr, const char* ficheiro, const char* origem) {
+    if (!csr || !ficheiro) return -1;
+
+    CabecalhoSnapshot cabecalho;
+    memset(&cabecalho, 0, sizeof(cabecalho));
+    IdentificacaoOrigem id;
+    if (identificar_origem(origem, &id, false) != 0) return -1;
+    cabecalho.data_criacao = (int64_t)time(NULL);
+    if (origem && origem_recente(id.data, cabecalho.data_criacao) &&
+        identificar_origem(origem, &id, true) != 0) return -1;
+    cabecalho.tamanho_origem = id.tamanho;
+    cabecalho.data_origem = id.data;
+    cabecalho.data_origem_ns = id.data_ns;
+    cabecalho.soma_origem = id.soma;
+    cabecalho.inode_origem = id.inode;
+
+    int n = csr->num_vertices;
+    uint64_t* offsets = (uint64_t*)malloc(((size_t)n + 1) * sizeof(uint64_t));
+    uint64_t* inicio = (uint64_t*)calloc(NUM_FREQUENCIAS + 1, sizeof(uint64_t));
+    int32_t* por_frequencia = (int32_t*)malloc((n ? n : 1) * sizeof(int32_t));
+    if (!offsets || !inicio || !por_frequencia) {
+        free(offsets);
+        free(inicio);
+        free(por_frequencia);
+        return -1;
+    }
+
+    for (int v = 0; v <= n; v++) offsets[v] = csr->offsets[v];
+    for (int v = 0; v < n; v++) inicio[(unsigned char)csr->frequencia[v] + 1]++;
+    for (int f = 0; f < NUM_FREQUENCIAS; f++) inicio[f + 1] += inicio[f];
+    {
+        uint64_t cursor[NUM_FREQUENCIAS];
+        memcpy(cursor, inicio, sizeof(cursor));
+        for (int v = 0; v < n; v++) por_frequencia[cursor[(unsigned char)csr->frequencia[v]]++] = v;
+    }
+
+    // Posições das secções
+    uint64_t m = csr->num_arestas;
+    memcpy(cabecalho.magia, MAGIA_SNAPSHOT, sizeof(MAGIA_SNAPSHOT));
+    cabecalho.versao = VERSAO_SNAPSHOT;
+    cabecalho.tamanho_cabecalho = sizeof(CabecalhoSnapshot);
+    cabecalho.num_vertices = n;
+    cabecalho.num_frequencias = NUM_FREQUENCIAS;
+    cabecalho.num_arestas = m;
+    cabecalho.pos_offsets = sizeof(CabecalhoSnapshot);
+    cabecalho.pos_destinos = cabecalho.pos_offsets + alinhar8(((uint64_t)n + 1) * 8);
+    cabecalho.pos_x = cabecalho.pos_destinos + alinhar8(m * 4);
+    cabecalho.pos_y = cabecalho.pos_x + alinhar8((uint64_t)n * 4);
+    cabecalho.pos_frequencia = cabecalho.pos_y + alinhar8((uint64_t)n * 4);
+    cabecalho.pos_inicio_frequencia = cabecalho.pos_frequencia + alinhar8((uint64_t)n);
+    cabecalho.pos_por_frequencia = cabecalho.pos_inicio_frequencia + (NUM_FREQUENCIAS + 1) * 8;
+    cabecalho.pos_por_posicao = cabecalho.pos_por_frequencia + alinhar8((uint64_t)n * 4);
+    cabecalho.tamanho_ficheiro = cabecalho.pos_por_posicao + alinhar8((uint64_t)n * 4);
+
+    size_t tamanho_nome = strlen(ficheiro) + 5;
+    char* temporario = (char*)malloc(tamanho_nome);
+    FILE* f = NULL;
+    int resultado = -2;
+    if (temporario) {
+        snprintf(temporario, tamanho_nome, "%s.tmp", ficheiro);
+        f = fopen(temporario, "wb");
+    }
+
+    if (f) {
+        uint64_t soma = SOMA_INICIAL;
+        // O cabeçalho é escrito primeiro sem somas e reescrito no fim
+        if (fwrite(&cabecalho, sizeof(cabecalho), 1, f) == 1 &&
+            escrever_secao(f, offsets, ((size_t)n + 1) * 8, &soma) == 0 &&
+            escrever_secao(f, csr->destinos, (size_t)m * 4, &soma) == 0 &&
+            escrever_secao(f, csr->x, (size_t)n * 4, &soma) == 0 &&
+            escrever_secao(f, csr->y, (size_t)n * 4, &soma) == 0 &&
+            escrever_secao(f, csr->frequencia, (size_t)n, &soma) == 0 &&
+            escrever_secao(f, inicio, (NUM_FREQUENCIAS + 1) * 8, &soma) == 0 &&
+            escrever_secao(f, por_frequencia, (size_t)n * 4, &soma) == 0 &&
+            escrever_secao(f, csr->por_posicao, (size_t)n * 4, &soma) == 0) {
+            cabecalho.soma_dados = soma;
+            cabecalho.soma_cabecalho = somar_cabecalho(&cabecalho);
+            if (fseek(f, 0, SEEK_SET) == 0 && fwrite(&cabecalho, sizeof(cabecalho), 1, f) == 1) {
+                resultado = 0;
+            }
+        }
+        if (fclose(f) != 0) resultado = -2;
+
+        if (resultado == 0) {
+            remove(ficheiro);
+            if (rename(temporario, ficheiro) != 0) resultado = -2;
+        }
+        if (resultado != 0) remove(temporario);
+    }
+
+    free(temporario);
+    free(offsets);
+    free(inicio);
+    free(por_frequencia);
+    return resultado;
+}
+
+/**
+ * @brief Confirma que uma secção está alinhada e dentro do ficheiro
+ * @param posicao Posição da secção
+ * @param tamanho Tamanho da secção em bytes
+ * @param total Tamanho do ficheiro
+ */
+static bool secao_valida(uint64_t posicao, uint64_t tamanho, uint64_t total) {
+    return posicao % 8 == 0 && posicao <= total && tamanho <= total - posicao;
+}
+
+/**
+ * @brief Abre um instantâneo por mapeamento em memória
+ * @param ficheiro Caminho do instantâneo
+ * @param origem Mapa correspondente, para confirmar que o instantâneo está atualizado (pode ser NULL)
+ * @return Apontador para o instantâneo, ou NULL se não existir, for inválido ou estiver desatualizado
+ *
+ * @details Confirma a identificação, a versão e a soma do cabeçalho, e que todas
+ * as secções cabem no ficheiro. Se origem for dada, o seu tamanho, a sua data
+ * (com os nanossegundos) e o seu inode têm de ser os que estavam gravados. Só
+ * se o mapa tiver sido modificado a menos de MARGEM_DATA_ORIGEM segundos da
+ * gravação, quando a data não distingue uma reescrita, é que o seu conteúdo é
+ * lido e comparado com a soma gravada. Os dados do instantâneo não são lidos:
+ * os vetores de csr passam a apontar para as secções mapeadas, pelo que, fora
+ * desse caso, o custo não depende do tamanho do grafo nem do mapa. Para
+ * instantâneos de origem duvidosa, usar também verificar_snapshot.
+ *
+ * @note Requer size_t de 64 bits, o tipo dos offsets de GrafoCSR
+ */
+GrafoSnapshot* abrir_snapshot(const char* ficheiro, const char* origem) {
+    if (!ficheiro || sizeof(size_t) != sizeof(uint64_t)) return NULL;
+
+    FicheiroMapeado mapeamento;
+    if (mapear_ficheiro(ficheiro, &mapeamento) != 0) return NULL;
+
+    // 1. Cabeçalho
+    CabecalhoSnapshot c;
+    bool valido = mapeamento.tamanho >= sizeof(c);
+    if (valido) {
+        memcpy(&c, mapeamento.dados, sizeof(c));
+        valido = memcmp(c.magia, MAGIA_SNAPSHOT, sizeof(MAGIA_SNAPSHOT)) == 0 &&
+                 c.versao == VERSAO_SNAPSHOT &&
+                 c.tamanho_cabecalho == sizeof(CabecalhoSnapshot) &&
+                 c.soma_cabecalho == somar_cabecalho(&c) &&
+                 c.tamanho_ficheiro == mapeamento.tamanho &&
+                 c.num_vertices >= 0 &&
+                 c.num_frequencias == NUM_FREQUENCIAS;
+    }
+
+    // 2. Secções
+    if (valido) {
+        uint64_t n = (uint64_t)c.num_vertices, total = c.tamanho_ficheiro;
+        valido = c.num_arestas <= total / 4 &&
+                 secao_valida(c.pos_offsets, (n + 1) * 8, total) &&
+                 secao_valida(c.pos_destinos, c.num_arestas * 4, total) &&
+                 secao_valida(c.pos_x, n * 4, total) &&
+                 secao_valida(c.pos_y, n * 4, total) &&
+                 secao_valida(c.pos_frequencia, n, total) &&
+                 secao_valida(c.pos_inicio_frequencia, (NUM_FREQUENCIAS + 1) * 8, total) &&
+                 secao_valida(c.pos_por_frequencia, n * 4, total) &&
+                 secao_valida(c.pos_por_posicao, n * 4, total);
+    }
+
+    // 3. Mapa de origem
+    if (valido && origem) {
+        IdentificacaoOrigem id;
+        valido = identificar_origem(origem, &id, false) == 0 &&
+                 id.tamanho == c.tamanho_origem && id.data == c.data_origem &&
+                 id.data_ns == c.data_origem_ns && id.inode == c.inode_origem;
+        // O conteúdo só é lido se a data não bastar para distinguir uma alteração
+        if (valido && origem_recente(c.data_origem, c.data_criacao)) {
+            valido = identificar_origem(origem, &id, true) == 0 && id.soma == c.soma_origem;
+        }
+    }
+
+    GrafoSnapshot* snapshot = valido ? (GrafoSnapshot*)malloc(sizeof(GrafoSnapshot)) : NULL;
+    if (!snapshot) {
+        libertar_mapeamento(&mapeamento);
+        return NULL;
+    }
+
+    const char* base = mapeamento.dados;
+    snapshot->mapeamento = mapeamento;
+    snapshot->csr.num_vertices = c.num_vertices;
+    snapshot->csr.num_arestas = (size_t)c.num_arestas;
+    snapshot->csr.offsets = (size_t*)(base + c.pos_offsets);
+    snapshot->csr.destinos = (int*)(base + c.pos_destinos);
+    snapshot->csr.x = (int*)(base + c.pos_x);
+    snapshot->csr.y = (int*)(base + c.pos_y);
+    snapshot->csr.frequencia = (char*)(base + c.pos_frequencia);
+    snapshot->csr.por_posicao = (int*)(base + c.pos_por_posicao);
+    snapshot->inicio_frequencia = (const size_t*)(base + c.pos_inicio_frequencia);
+    snapshot->por_frequencia = (const int*)(base + c.pos_por_frequencia);
+    return snapshot;
+}
+
+/**
+ * @brief Confirma a soma de verificação dos dados de um instantâneo aberto
+ * @param snapshot Instantâneo a verificar
+ * @return 0 se os dados estiverem íntegros, -1 caso contrário
+ *
+ * @details Lê todo o ficheiro; com dados íntegros, todas as secções são válidas
+ * tal como foram gravadas por gravar_snapshot
+ */
+int verificar_snapshot(const GrafoSnapshot* snapshot) {
+    if (!snapshot || !snapshot->mapeamento.dados) return -1;
+    CabecalhoSnapshot c;
+    memcpy(&c, snapshot->mapeamento.dados, sizeof(c));
+    uint64_t soma = somar(SOMA_INICIAL, snapshot->mapeamento.dados + sizeof(c),
+                          snapshot->mapeamento.tamanho - sizeof(c));
+    return soma == c.soma_dados ? 0 : -1;
+}
+
+/**
+ * @brief Fecha um instantâneo, libertando o mapeamento
+ * @param snapshot Instantâneo a fechar
+ * @return 0 em caso de sucesso, -1 em caso de erro
+ */
+int fechar_snapshot(GrafoSnapshot* snapshot) {
+    if (!snapshot) return -1;
+    libertar_mapeamento(&snapshot->mapeamento);
+    free(snapshot);
+    return 0;
+}
+
+/**
+ * @brief Obtém o caminho do instantâneo guardado ao lado de um mapa
+ * @param mapa Caminho do mapa (por exemplo, "data/mapa.bin")
+ * @param[out] destino Memória onde escrever o caminho (por exemplo, "data/mapa.snap")
+ * @param tamanho Tamanho de destino em bytes
+ * @return 0 em caso de sucesso, -1 se destino for pequeno demais
+ *
+ * @details A extensão ".bin" é substituída por ".snap"; se o mapa não tiver essa
+ * extensão, ".snap" é acrescentado ao nome
+ */
+int caminho_snapshot(const char* mapa, char* destino, size_t tamanho) {
+    if (!mapa || !destino) return -1;
+    size_t n = strlen(mapa);
+    if (n >= 4 && strcmp(mapa + n - 4, ".bin") == 0) n -= 4;
+    if (n + 6 > tamanho) return -1;
+    memcpy(destino, mapa, n);
+    memcpy(destino + n, ".snap", 6);
+    return 0;
+}
+
+/**
+ * @brief Carrega um mapa através do seu instantâneo, criando-o se necessário
+ * @param ficheiro Caminho do mapa
+ * @return Apontador para o instantâneo, ou NULL em caso de erro
+ *
+ * @details Se existir um instantâneo válido e atualizado ao lado do mapa, é
+ * aberto diretamente. Caso contrário, o mapa é carregado (carregar_mapa_modo no
+ * modo implícito, já que o CSR não depende do modo), congelado e gravado como
+ * instantâneo, que é depois aberto.
+ */
+GrafoSnapshot* carregar_mapa_snapshot(const char* ficheiro) {
+    if (!ficheiro) return NULL;
+
+    size_t tamanho = strlen(ficheiro) + 6;
+    char* nome = (char*)malloc(tamanho);
+    if (!nome || caminho_snapshot(ficheiro, nome, tamanho) != 0) {
+        free(nome);
+        return NULL;
+    }
+
+    GrafoSnapshot* snapshot = abrir_snapshot(nome, ficheiro);
+    if (!snapshot) {
+        Grafo* grafo = carregar_mapa_modo(ficheiro, ARESTAS_IMPLICITAS);
+        GrafoCSR* csr = grafo ? grafo_congelar(grafo) : NULL;
+        if (csr && gravar_snapshot(csr, nome, ficheiro) == 0) {
+            snapshot = abrir_snapshot(nome, ficheiro);
+        }
+        destruir_grafo_csr(csr);
+        destruir_grafo(grafo);
+    }
+
+    free(nome);
+    return snapshot;
+}